@@ -56,6 +56,7 @@ extern "C" {
     typedef uint64_t ne10_uint64_t;
     typedef float    ne10_float32_t;
     typedef double   ne10_float64_t;
+    typedef uint16_t ne10_float16_t;    // IEEE 754 binary16, storage only
     typedef int      ne10_result_t;     // resulting [error-]code
     ///////////////////////////
 // Internal macro define
@@ -90,11 +91,22 @@ extern "C" {
 #define NE10_FACTOR_EIGHT_FIRST_STAGE   1
 #define NE10_FACTOR_EIGHT               2
 
-  // Comment when do not want to scale output result
+  // Comment when do not want to scale output result (the default; see the scale fields of the configurations)
 #define NE10_DSP_RFFT_SCALING
 #define NE10_DSP_CFFT_SCALING
 
 #define NE10_FFT_PARA_LEVEL 4
+
+ /*
+  * FFT kernel instruction sets
+  *
+  * The power-of-two butterflies are dispatched at run time to the widest kernel the
+  * CPU supports. NE10_FFT_ISA_C is the portable C implementation.
+  */
+#define NE10_FFT_ISA_C          0
+#define NE10_FFT_ISA_SSE2       1
+#define NE10_FFT_ISA_AVX2       2
+#define NE10_FFT_ISA_AVX512     3
 /////////////////////////////////////////////////////////
 // definitions for fft
 /////////////////////////////////////////////////////////
@@ -148,7 +160,6 @@ extern "C" {
          *  @note If is_forward_scaled is set 0, Ne10 will not scale output of forward floating
          *  point complex FFT. Otherwise, Ne10 will scale output of forward floating
          *  point complex FFT.
-         *  @warning Only non-power-of-two FFTs are affected by this flag.
          */
         ne10_int32_t is_forward_scaled;
         /**
@@ -156,7 +167,6 @@ extern "C" {
          *  @note If is_backward_scaled is set 0, Ne10 will not scale output of backward floating
          *  point complex FFT. Otherwise, Ne10 will scale output of backward floating
          *  point complex FFT.
-         *  @warning Only non-power-of-two FFTs are affected by this flag.
          */
         ne10_int32_t is_backward_scaled;
     } ne10_fft_state_float32_t;
@@ -174,6 +184,16 @@ extern "C" {
         ne10_int32_t* factors;
         ne10_fft_cpx_float32_t* twiddles;
         ne10_fft_cpx_float32_t* super_twiddles;
+        /**
+         *  @brief Factor applied to the output of the forward transform, 1.0f by default.
+         */
+        ne10_float32_t forward_scale;
+        /**
+         *  @brief Factor applied to the output of the backward transform, relative to an
+         *  unscaled inverse. 1.0f / nfft (a true inverse) by default, or 1.0f if
+         *  NE10_DSP_RFFT_SCALING is undefined.
+         */
+        ne10_float32_t backward_scale;
 #elif (NE10_UNROLL_LEVEL > 0)
         ne10_int32_t nfft;
         ne10_fft_cpx_float32_t* r_twiddles;
@@ -187,13 +207,110 @@ extern "C" {
     } ne10_fft_r2c_state_float32_t;
 
     typedef ne10_fft_r2c_state_float32_t* ne10_fft_r2c_cfg_float32_t;
+
+    /**
+     * @brief Structure for the double precision FFT function.
+     */
+    typedef struct
+    {
+        ne10_float64_t r;
+        ne10_float64_t i;
+    } ne10_fft_cpx_float64_t;
+
+    /**
+     * @brief Double precision counterpart of ne10_fft_r2c_state_float32_t (portable C only).
+     */
+    typedef struct
+    {
+        ne10_fft_cpx_float64_t* buffer;
+        ne10_int32_t ncfft;
+        ne10_int32_t* factors;
+        ne10_fft_cpx_float64_t* twiddles;
+        ne10_fft_cpx_float64_t* super_twiddles;
+        ne10_float64_t forward_scale;
+        ne10_float64_t backward_scale;
+    } ne10_fft_r2c_state_float64_t;
+
+    typedef ne10_fft_r2c_state_float64_t* ne10_fft_r2c_cfg_float64_t;
+
+    /**
+     * @brief Structures for the fixed-point (Q15 / Q31) FFT functions.
+     */
+    typedef struct
+    {
+        ne10_int16_t r;
+        ne10_int16_t i;
+    } ne10_fft_cpx_int16_t;
+
+    typedef struct
+    {
+        ne10_int32_t r;
+        ne10_int32_t i;
+    } ne10_fft_cpx_int32_t;
+
+    /**
+     * @brief Fixed-point real FFT state; twiddles are stored in Q15 (int16) or Q31 (int32).
+     */
+    typedef struct
+    {
+        ne10_int32_t ncfft;
+        ne10_int32_t* factors;
+        ne10_fft_cpx_int16_t* twiddles;
+        ne10_fft_cpx_int16_t* super_twiddles;
+        ne10_fft_cpx_int16_t* buffer;
+    } ne10_fft_r2c_state_int16_t;
+
+    typedef ne10_fft_r2c_state_int16_t* ne10_fft_r2c_cfg_int16_t;
+
+    typedef struct
+    {
+        ne10_int32_t ncfft;
+        ne10_int32_t* factors;
+        ne10_fft_cpx_int32_t* twiddles;
+        ne10_fft_cpx_int32_t* super_twiddles;
+        ne10_fft_cpx_int32_t* buffer;
+    } ne10_fft_r2c_state_int32_t;
+
+    typedef ne10_fft_r2c_state_int32_t* ne10_fft_r2c_cfg_int32_t;
 ///////////////////////////
 // function prototypes:
 ///////////////////////////
+    ne10_fft_cfg_float32_t ne10_fft_alloc_c2c_float32(ne10_int32_t nfft);
+    ne10_fft_cfg_float32_t ne10_fft_alloc_c2c_shared_float32(ne10_int32_t nfft);
+    void ne10_fft_c2c_1d_float32_c(ne10_fft_cpx_float32_t* fout,ne10_fft_cpx_float32_t* fin,ne10_fft_cfg_float32_t cfg,ne10_int32_t inverse_fft);
+    void ne10_fft_destroy_c2c_float32(ne10_fft_cfg_float32_t cfg);
     ne10_fft_r2c_cfg_float32_t ne10_fft_alloc_r2c_float32(ne10_int32_t nfft);
+    ne10_fft_r2c_cfg_float32_t ne10_fft_alloc_r2c_shared_float32(ne10_int32_t nfft);
+    void ne10_fft_release_shared_float32(void);
+    ne10_int32_t ne10_fft_get_isa_float32(void);
+    ne10_int32_t ne10_fft_set_isa_float32(ne10_int32_t isa);
     void ne10_fft_destory_r2c_float32(ne10_fft_r2c_cfg_float32_t cfg);
     void ne10_fft_r2c_1d_float32_c(ne10_fft_cpx_float32_t* fout,ne10_float32_t* fin,ne10_fft_r2c_cfg_float32_t cfg);
     void ne10_fft_c2r_1d_float32_c(ne10_float32_t* fout,ne10_fft_cpx_float32_t* fin,ne10_fft_r2c_cfg_float32_t cfg);
+    void ne10_fft_r2c_1d_packed_float32_c(ne10_fft_cpx_float32_t* fout,ne10_float32_t* fin,ne10_fft_r2c_cfg_float32_t cfg);
+    void ne10_fft_c2r_1d_packed_float32_c(ne10_float32_t* fout,ne10_fft_cpx_float32_t* fin,ne10_fft_r2c_cfg_float32_t cfg);
+    void ne10_fft_r2c_1d_split_float32_c(ne10_float32_t* re,ne10_float32_t* im,ne10_float32_t* fin,ne10_fft_r2c_cfg_float32_t cfg);
+    void ne10_fft_c2r_1d_split_float32_c(ne10_float32_t* fout,const ne10_float32_t* re,const ne10_float32_t* im,ne10_fft_r2c_cfg_float32_t cfg);
+    ne10_int32_t ne10_fft_r2c_lanes_float32(ne10_fft_r2c_cfg_float32_t cfg,ne10_int32_t channels);
+    ne10_result_t ne10_fft_r2c_1d_lanes_float32_c(ne10_float32_t* fout,ne10_float32_t* fin,ne10_int32_t lanes,ne10_fft_r2c_cfg_float32_t cfg,ne10_fft_cpx_float32_t* buffer);
+    void ne10_transpose_float32(ne10_float32_t* dst,ne10_int32_t dst_stride,const ne10_float32_t* src,ne10_int32_t src_stride,ne10_int32_t rows,ne10_int32_t cols);
+    ne10_result_t ne10_fft_c2r_1d_lanes_float32_c(ne10_float32_t* fout,ne10_float32_t* fin,ne10_int32_t lanes,ne10_fft_r2c_cfg_float32_t cfg,ne10_fft_cpx_float32_t* buffer);
+    void ne10_fft_r2c_1d_float16_c(ne10_float16_t* fout,const ne10_float16_t* fin,ne10_fft_r2c_cfg_float32_t cfg);
+    void ne10_fft_c2r_1d_float16_c(ne10_float16_t* fout,const ne10_float16_t* fin,ne10_fft_r2c_cfg_float32_t cfg);
+    void ne10_cvt_float16_float32(ne10_float32_t* dst,const ne10_float16_t* src,ne10_int32_t count);
+    void ne10_cvt_float32_float16(ne10_float16_t* dst,const ne10_float32_t* src,ne10_int32_t count);
+    ne10_fft_r2c_cfg_float64_t ne10_fft_alloc_r2c_float64(ne10_int32_t nfft);
+    void ne10_fft_destroy_r2c_float64(ne10_fft_r2c_cfg_float64_t cfg);
+    void ne10_fft_r2c_1d_float64_c(ne10_fft_cpx_float64_t* fout,ne10_float64_t* fin,ne10_fft_r2c_cfg_float64_t cfg);
+    void ne10_fft_c2r_1d_float64_c(ne10_float64_t* fout,ne10_fft_cpx_float64_t* fin,ne10_fft_r2c_cfg_float64_t cfg);
+    ne10_fft_r2c_cfg_int16_t ne10_fft_alloc_r2c_int16(ne10_int32_t nfft);
+    void ne10_fft_destroy_r2c_int16(ne10_fft_r2c_cfg_int16_t cfg);
+    ne10_int32_t ne10_fft_r2c_1d_int16_c(ne10_fft_cpx_int16_t* fout,const ne10_int16_t* fin,ne10_fft_r2c_cfg_int16_t cfg);
+    ne10_int32_t ne10_fft_c2r_1d_int16_c(ne10_int16_t* fout,const ne10_fft_cpx_int16_t* fin,ne10_int32_t exponent,ne10_fft_r2c_cfg_int16_t cfg);
+    ne10_fft_r2c_cfg_int32_t ne10_fft_alloc_r2c_int32(ne10_int32_t nfft);
+    void ne10_fft_destroy_r2c_int32(ne10_fft_r2c_cfg_int32_t cfg);
+    ne10_int32_t ne10_fft_r2c_1d_int32_c(ne10_fft_cpx_int32_t* fout,const ne10_int32_t* fin,ne10_fft_r2c_cfg_int32_t cfg);
+    ne10_int32_t ne10_fft_c2r_1d_int32_c(ne10_int32_t* fout,const ne10_fft_cpx_int32_t* fin,ne10_int32_t exponent,ne10_fft_r2c_cfg_int32_t cfg);
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,460 @@
+/*
+ * NE10 Library : dsp/NE10_fft_generic.h
+ *
+ * Portable FFT building blocks shared by every precision (NE10_fft_float32.cpp,
+ * NE10_fft_float64.cpp): factor/twiddle table generation, the generic mixed radix-2/3/4/5
+ * butterflies for any length, and the real-to-complex split. They are templates over the
+ * complex type T (ne10_fft_cpx_float32_t or ne10_fft_cpx_float64_t); arithmetic is done in
+ * the matching real type, while twiddles are always computed in double precision.
+ */
+#ifndef NE10_FFT_GENERIC_H
+#define NE10_FFT_GENERIC_H
+
+#include <math.h>
+#include "NE10_fft.h"
+
+ne10_int32_t ne10_factor (ne10_int32_t n, ne10_int32_t *facbuf, ne10_int32_t ne10_factor_flags);
+
+template <class T> struct ne10_fft_cpx_traits;
+template <> struct ne10_fft_cpx_traits<ne10_fft_cpx_float32_t> { typedef ne10_float32_t real_t; };
+template <> struct ne10_fft_cpx_traits<ne10_fft_cpx_float64_t> { typedef ne10_float64_t real_t; };
+
+template <class T> using ne10_fft_real_t = typename ne10_fft_cpx_traits<T>::real_t;
+
+/*
+ * Factors ncfft and fills in the twiddles of every stage after the first (ncfft entries).
+ * These are the tables of a complex transform of length ncfft, which is also the core of
+ * a real transform of length 2 * ncfft.
+ */
+template <class T>
+static ne10_int32_t ne10_fft_c2c_init_tables_c (ne10_int32_t ncfft,
+        ne10_int32_t *factors,
+        T *twiddles,
+        ne10_int32_t factor_flags)
+{
+    ne10_int32_t result = ne10_factor (ncfft, factors, factor_flags);
+    if (result == NE10_ERR)
+    {
+        return NE10_ERR;
+    }
+
+    ne10_int32_t j, k;
+    ne10_int32_t stage_count = factors[0];
+    ne10_int32_t fstride = factors[1];
+    ne10_int32_t mstride;
+    ne10_int32_t cur_radix;
+    ne10_float64_t phase;
+    const ne10_float64_t pi = 3.1415926535897932384626433832795;
+
+    // Don't generate any twiddles for the first stage
+    stage_count --;
+
+    // Generate twiddles for the other stages
+    for (; stage_count > 0; stage_count --)
+    {
+        cur_radix = factors[2 * stage_count];
+        fstride /= cur_radix;
+        mstride = factors[2 * stage_count + 1];
+        for (j = 0; j < mstride; j++)
+        {
+            for (k = 1; k < cur_radix; k++) // phase = 1 when k = 0
+            {
+                phase = -2 * pi * ((ne10_float64_t) fstride * k * j / ncfft);
+                twiddles[mstride * (k - 1) + j].r = (ne10_fft_real_t<T>) cos (phase);
+                twiddles[mstride * (k - 1) + j].i = (ne10_fft_real_t<T>) sin (phase);
+            }
+        }
+        twiddles += mstride * (cur_radix - 1);
+    }
+
+    // The stages above use ncfft - first_radix twiddles. The remaining first_radix slots hold
+    // the DFT coefficients for a first stage of generic (non 2/3/4/5) radix.
+    cur_radix = factors[2 * factors[0]];
+    for (j = 0; j < cur_radix; j++)
+    {
+        phase = -2 * pi * ( (ne10_float64_t) j / cur_radix);
+        twiddles[j].r = (ne10_fft_real_t<T>) cos (phase);
+        twiddles[j].i = (ne10_fft_real_t<T>) sin (phase);
+    }
+
+    return NE10_OK;
+}
+
+/*
+ * The complex tables of ncfft, followed by the super twiddles used by the real-to-complex
+ * split. Shared by every configuration of a given precision, so that private and cached
+ * ones produce identical tables.
+ */
+template <class T>
+static ne10_int32_t ne10_fft_r2c_init_tables_c (ne10_int32_t ncfft,
+        ne10_int32_t *factors,
+        T *twiddles,
+        T *super_twiddles,
+        ne10_int32_t factor_flags)
+{
+    ne10_int32_t j;
+    ne10_float64_t phase;
+    const ne10_float64_t pi = 3.1415926535897932384626433832795;
+
+    if (ne10_fft_c2c_init_tables_c (ncfft, factors, twiddles, factor_flags) == NE10_ERR)
+    {
+        return NE10_ERR;
+    }
+
+    twiddles = super_twiddles;
+    for (j = 0; j < ncfft / 2; j++)
+    {
+        phase = -pi * ( (ne10_float64_t) (j + 1) / ncfft + 0.5);
+        twiddles->r = (ne10_fft_real_t<T>) cos (phase);
+        twiddles->i = (ne10_fft_real_t<T>) sin (phase);
+        twiddles++;
+    }
+
+    return NE10_OK;
+}
+
+/*
+ * Radix-2/3/4/5 butterflies on x[0..radix-1], in place. For the forward transform the
+ * rotation is e^{-2*pi*i/radix}, for the inverse e^{+2*pi*i/radix}.
+ */
+template <class T, ne10_int32_t radix, bool inverse>
+static inline void ne10_radix_butterfly_c (T *x)
+{
+    T t[4];
+    // Multiplication by -i (forward) or i (inverse) of (r, i) is (sign * i, -sign * r)
+    const ne10_fft_real_t<T> sign = inverse ? -1.0f : 1.0f;
+
+    if (radix == 2)
+    {
+        t[0] = x[0];
+        x[0].r = t[0].r + x[1].r;
+        x[0].i = t[0].i + x[1].i;
+        x[1].r = t[0].r - x[1].r;
+        x[1].i = t[0].i - x[1].i;
+    }
+    else if (radix == 3)
+    {
+        const ne10_fft_real_t<T> TW_3I = 0.866025403784438646763723170752936183; // sin (2 * pi / 3)
+        t[0].r = x[1].r + x[2].r;
+        t[0].i = x[1].i + x[2].i;
+        t[1].r = (x[1].i - x[2].i) * TW_3I * sign;   // (x[1] - x[2]) * sin (2 * pi / 3) * -/+i
+        t[1].i = (x[2].r - x[1].r) * TW_3I * sign;
+        t[2].r = x[0].r - t[0].r * 0.5f;
+        t[2].i = x[0].i - t[0].i * 0.5f;
+
+        x[0].r += t[0].r;
+        x[0].i += t[0].i;
+        x[1].r = t[2].r + t[1].r;
+        x[1].i = t[2].i + t[1].i;
+        x[2].r = t[2].r - t[1].r;
+        x[2].i = t[2].i - t[1].i;
+    }
+    else if (radix == 4)
+    {
+        t[0].r = x[0].r + x[2].r;
+        t[0].i = x[0].i + x[2].i;
+        t[1].r = x[0].r - x[2].r;
+        t[1].i = x[0].i - x[2].i;
+        t[2].r = x[1].r + x[3].r;
+        t[2].i = x[1].i + x[3].i;
+        t[3].r = (x[1].i - x[3].i) * sign;           // (x[1] - x[3]) * -/+i
+        t[3].i = (x[3].r - x[1].r) * sign;
+
+        x[0].r = t[0].r + t[2].r;
+        x[0].i = t[0].i + t[2].i;
+        x[1].r = t[1].r + t[3].r;
+        x[1].i = t[1].i + t[3].i;
+        x[2].r = t[0].r - t[2].r;
+        x[2].i = t[0].i - t[2].i;
+        x[3].r = t[1].r - t[3].r;
+        x[3].i = t[1].i - t[3].i;
+    }
+    else if (radix == 5)
+    {
+        const ne10_fft_real_t<T> TW_5C1 = 0.309016994374947424102293417182819059;  // cos (2 * pi / 5)
+        const ne10_fft_real_t<T> TW_5C2 = -0.809016994374947424102293417182819059; // cos (4 * pi / 5)
+        const ne10_fft_real_t<T> TW_5S1 = 0.951056516295153572116439333379382143;  // sin (2 * pi / 5)
+        const ne10_fft_real_t<T> TW_5S2 = 0.587785252292473129168705954639072769;  // sin (4 * pi / 5)
+        T a1, a2, b1, b2;
+
+        t[0].r = x[1].r + x[4].r;
+        t[0].i = x[1].i + x[4].i;
+        t[1].r = x[2].r + x[3].r;
+        t[1].i = x[2].i + x[3].i;
+        t[2].r = x[1].r - x[4].r;
+        t[2].i = x[1].i - x[4].i;
+        t[3].r = x[2].r - x[3].r;
+        t[3].i = x[2].i - x[3].i;
+
+        a1.r = x[0].r + TW_5C1 * t[0].r + TW_5C2 * t[1].r;
+        a1.i = x[0].i + TW_5C1 * t[0].i + TW_5C2 * t[1].i;
+        a2.r = x[0].r + TW_5C2 * t[0].r + TW_5C1 * t[1].r;
+        a2.i = x[0].i + TW_5C2 * t[0].i + TW_5C1 * t[1].i;
+
+        // b = (s1 * t[2] + s2 * t[3]) * -/+i and (s2 * t[2] - s1 * t[3]) * -/+i
+        b1.r = (TW_5S1 * t[2].i + TW_5S2 * t[3].i) * sign;
+        b1.i = -(TW_5S1 * t[2].r + TW_5S2 * t[3].r) * sign;
+        b2.r = (TW_5S2 * t[2].i - TW_5S1 * t[3].i) * sign;
+        b2.i = -(TW_5S2 * t[2].r - TW_5S1 * t[3].r) * sign;
+
+        x[0].r += t[0].r + t[1].r;
+        x[0].i += t[0].i + t[1].i;
+        x[1].r = a1.r + b1.r;
+        x[1].i = a1.i + b1.i;
+        x[4].r = a1.r - b1.r;
+        x[4].i = a1.i - b1.i;
+        x[2].r = a2.r + b2.r;
+        x[2].i = a2.i + b2.i;
+        x[3].r = a2.r - b2.r;
+        x[3].i = a2.i - b2.i;
+    }
+}
+
+/*
+ * One radix-2/3/4/5 stage of the generic algorithm: butterfly m of section f reads
+ * src[f * mstride + m + k * step] (step = fstride * mstride), multiplies it by
+ * twiddles[m + (k - 1) * mstride] and writes dst[f * mstride * radix + m + k * mstride].
+ * For the last stage fstride is 1, so it reads and writes the same offsets and may run
+ * in place. The first stage has no twiddles and passes NULL.
+ */
+template <class T, ne10_int32_t radix, bool inverse>
+static void ne10_radix_stage_c (T *dst,
+        const T *src,
+        const T *twiddles,
+        ne10_int32_t fstride,
+        ne10_int32_t mstride,
+        ne10_fft_real_t<T> scale)
+{
+    ne10_int32_t f_count, m_count, k;
+    ne10_int32_t step = fstride * mstride;
+    T x[radix];
+    T tw;
+
+    for (f_count = 0; f_count < fstride; f_count++)
+    {
+        for (m_count = 0; m_count < mstride; m_count++)
+        {
+            x[0] = src[m_count];
+            for (k = 1; k < radix; k++)
+            {
+                if (twiddles == NULL)
+                {
+                    x[k] = src[m_count + k * step];
+                    continue;
+                }
+                tw = twiddles[m_count + (k - 1) * mstride];
+                if (inverse)
+                {
+                    tw.i = -tw.i;
+                }
+                x[k].r = src[m_count + k * step].r * tw.r - src[m_count + k * step].i * tw.i;
+                x[k].i = src[m_count + k * step].i * tw.r + src[m_count + k * step].r * tw.i;
+            }
+
+            ne10_radix_butterfly_c<T, radix, inverse> (x);
+
+            for (k = 0; k < radix; k++)
+            {
+                dst[m_count + k * mstride].r = x[k].r * scale;
+                dst[m_count + k * mstride].i = x[k].i * scale;
+            }
+        }
+        src += mstride;
+        dst += mstride * radix;
+    }
+}
+
+/*
+ * First stage of generic radix (any remaining factor, e.g. a prime > 5): a direct DFT of
+ * src[f + q * fstride] for q < radix, written to dst[f * radix + k]. 'dft' holds
+ * e^{-2*pi*i*j/radix} for j < radix.
+ */
+template <class T, bool inverse>
+static void ne10_radix_generic_first_stage_c (T *dst,
+        const T *src,
+        const T *dft,
+        ne10_int32_t fstride,
+        ne10_int32_t radix,
+        ne10_fft_real_t<T> scale)
+{
+    ne10_int32_t f_count, k, q, j;
+    T acc, tw;
+
+    for (f_count = 0; f_count < fstride; f_count++)
+    {
+        for (k = 0; k < radix; k++)
+        {
+            acc = src[f_count];
+            for (q = 1, j = k; q < radix; q++)
+            {
+                tw = dft[j];
+                if (inverse)
+                {
+                    tw.i = -tw.i;
+                }
+                acc.r += src[f_count + q * fstride].r * tw.r - src[f_count + q * fstride].i * tw.i;
+                acc.i += src[f_count + q * fstride].i * tw.r + src[f_count + q * fstride].r * tw.i;
+                j += k;
+                if (j >= radix)
+                {
+                    j -= radix;
+                }
+            }
+            dst[f_count * radix + k].r = acc.r * scale;
+            dst[f_count * radix + k].i = acc.i * scale;
+        }
+    }
+}
+
+/*
+ * This function calculates the FFT for any input size (NE10_FFT_ALG_ANY) with a mixed
+ * radix-2/3/4/5 DIT algorithm, using the same factor buffer, twiddle layout and stage
+ * ordering as the power-of-two butterflies.
+ *
+ * The first stage has no twiddles and is either one of the specialised radices or a
+ * direct DFT of the generic radix left over by ne10_factor. Every later stage is radix
+ * 2, 3, 4 or 5. The output of the inverse transform is multiplied by 'scale'.
+ */
+template <class T, bool inverse>
+static void ne10_mixed_radix_generic_butterfly_c (T *out,
+        T *in,
+        ne10_int32_t *factors,
+        T *twiddles,
+        T *buffer,
+        ne10_fft_real_t<T> scale)
+{
+    ne10_int32_t stage_count = factors[0];
+    ne10_int32_t fstride = factors[1];
+    ne10_int32_t radix = factors[stage_count << 1];
+    ne10_int32_t nfft = fstride * radix;
+    ne10_int32_t mstride = 1;
+    T *out_final = out;
+    T *dst, *tmp;
+    ne10_fft_real_t<T> first_scale = (stage_count == 1) ? scale : 1.0f;
+
+    // The first stage (no twiddles)
+    switch (radix)
+    {
+    case 2:
+        ne10_radix_stage_c<T, 2, inverse> (out, in, NULL, fstride, 1, first_scale);
+        break;
+    case 3:
+        ne10_radix_stage_c<T, 3, inverse> (out, in, NULL, fstride, 1, first_scale);
+        break;
+    case 4:
+        ne10_radix_stage_c<T, 4, inverse> (out, in, NULL, fstride, 1, first_scale);
+        break;
+    case 5:
+        ne10_radix_stage_c<T, 5, inverse> (out, in, NULL, fstride, 1, first_scale);
+        break;
+    default:
+        ne10_radix_generic_first_stage_c<T, inverse> (out, in, twiddles + (nfft - radix),
+                fstride, radix, first_scale);
+        break;
+    }
+
+    // The next stage should read the output of the first stage as input
+    in = out;
+    out = buffer;
+
+    // The other stages, the last one always writing to the final output buffer
+    for (stage_count--; stage_count > 0; stage_count--)
+    {
+        mstride *= radix;
+        radix = factors[stage_count << 1];
+        fstride /= radix;
+        dst = (stage_count == 1) ? out_final : out;
+
+        switch (radix)
+        {
+        case 2:
+            ne10_radix_stage_c<T, 2, inverse> (dst, in, twiddles, fstride, mstride, (stage_count == 1) ? scale : 1.0f);
+            break;
+        case 3:
+            ne10_radix_stage_c<T, 3, inverse> (dst, in, twiddles, fstride, mstride, (stage_count == 1) ? scale : 1.0f);
+            break;
+        case 4:
+            ne10_radix_stage_c<T, 4, inverse> (dst, in, twiddles, fstride, mstride, (stage_count == 1) ? scale : 1.0f);
+            break;
+        default: // 5
+            ne10_radix_stage_c<T, 5, inverse> (dst, in, twiddles, fstride, mstride, (stage_count == 1) ? scale : 1.0f);
+            break;
+        }
+        twiddles += mstride * (radix - 1);
+
+        // Swap the input and output buffers for the next stage
+        tmp = in;
+        in = out;
+        out = tmp;
+    }
+}
+
+/*
+ * Bins 1 .. ncfft - 1 of the real-to-complex split (and, below, of the complex-to-real
+ * merge). DC and Nyquist depend on the output packing and are left to the caller.
+ */
+template <class T>
+static void ne10_fft_split_r2c_c (T *dst,
+        const T *src,
+        T *twiddles,
+        ne10_int32_t ncfft)
+{
+    ne10_int32_t k;
+    T fpnk, fpk, f1k, f2k, tw;
+
+    for (k = 1; k <= ncfft / 2 ; ++k)
+    {
+        fpk    = src[k];
+        fpnk.r =   src[ncfft - k].r;
+        fpnk.i = - src[ncfft - k].i;
+
+        f1k.r = fpk.r + fpnk.r;
+        f1k.i = fpk.i + fpnk.i;
+
+        f2k.r = fpk.r - fpnk.r;
+        f2k.i = fpk.i - fpnk.i;
+
+        tw.r = f2k.r * (twiddles[k - 1]).r - f2k.i * (twiddles[k - 1]).i;
+        tw.i = f2k.r * (twiddles[k - 1]).i + f2k.i * (twiddles[k - 1]).r;
+
+        dst[k].r = (f1k.r + tw.r) * 0.5f;
+        dst[k].i = (f1k.i + tw.i) * 0.5f;
+        dst[ncfft - k].r = (f1k.r - tw.r) * 0.5f;
+        dst[ncfft - k].i = (tw.i - f1k.i) * 0.5f;
+    }
+}
+
+template <class T>
+static void ne10_fft_split_c2r_c (T *dst,
+        const T *src,
+        T *twiddles,
+        ne10_int32_t ncfft)
+{
+
+    ne10_int32_t k;
+    T fk, fnkc, fek, fok, tmp;
+
+    for (k = 1; k <= ncfft / 2; k++)
+    {
+        fk = src[k];
+        fnkc.r = src[ncfft - k].r;
+        fnkc.i = -src[ncfft - k].i;
+
+        fek.r = fk.r + fnkc.r;
+        fek.i = fk.i + fnkc.i;
+
+        tmp.r = fk.r - fnkc.r;
+        tmp.i = fk.i - fnkc.i;
+
+        fok.r = tmp.r * twiddles[k - 1].r + tmp.i * twiddles[k - 1].i;
+        fok.i = tmp.i * twiddles[k - 1].r - tmp.r * twiddles[k - 1].i;
+
+        dst[k].r = (fek.r + fok.r) * 0.5f;
+        dst[k].i = (fek.i + fok.i) * 0.5f;
+
+        dst[ncfft - k].r = (fek.r - fok.r) * 0.5f;
+        dst[ncfft - k].i = (fok.i - fek.i) * 0.5f;
+    }
+}
+
+#endif // NE10_FFT_GENERIC_H
@@ -0,0 +1,1326 @@
+/*
+ * NE10 Library : dsp/NE10_fft_simd.h
+ *
+ * Vectorised FFT kernels shared by the per-ISA translation units
+ * (NE10_fft_float32_sse2.cpp, NE10_fft_float32_avx2.cpp, NE10_fft_float32_avx512.cpp).
+ *
+ * The kernels are written once as templates over a "vector traits" type V that
+ * describes how W consecutive complex elements are held in one register:
+ *
+ *     typedef ... elem_t;                     storage element (one complex value)
+ *     typedef ... reg_t;                      register holding W elements
+ *     typedef ... half_t;                     traits to fall back to when fewer than W
+ *                                             elements are available
+ *     enum { W = ... };
+ *     reg_t load (const elem_t *p);           W consecutive elements
+ *     void  store (elem_t *p, reg_t x);
+ *     reg_t load_tw (const ne10_fft_cpx_float32_t *tw);
+ *                                             W consecutive twiddles, laid out like load
+ *     reg_t add (reg_t a, reg_t b);
+ *     reg_t sub (reg_t a, reg_t b);
+ *     reg_t scale (reg_t x, ne10_float32_t s);
+ *     reg_t mul_tw (reg_t x, reg_t tw);       x * tw
+ *     reg_t mul_tw_conj (reg_t x, reg_t tw);  x * conj (tw)
+ *     reg_t mul_neg_j (reg_t x);              x * -i
+ *     reg_t mul_pos_j (reg_t x);              x * i
+ *     reg_t conj (reg_t x);
+ *     reg_t reverse (reg_t x);                reverses the order of the W elements
+ *     template <int R> void store_transposed (elem_t *dst, const reg_t *o);
+ *                                             stores lane l of o[k] at dst[l * R + k]
+ *     reg_t load_split (const ne10_float32_t *re, const ne10_float32_t *im);
+ *     void  store_split (ne10_float32_t *re, ne10_float32_t *im, reg_t x);
+ *                                             W consecutive elements kept as separate
+ *                                             real and imaginary arrays
+ *
+ * Traits for an instruction set are only defined when the including translation
+ * unit is compiled with the matching flags (NE10_FFT_HAVE_SSE2/AVX2/AVX512).
+ *
+ * The same kernels also run "across channels": ne10_fft_lanes_traits<P> holds one
+ * complex value of L independent transforms per register (elem_t is L real parts
+ * followed by L imaginary parts, W = 1), and load_tw broadcasts the twiddle shared by
+ * all of them. P wraps the packed float operations of an instruction set (ps_t, L,
+ * load, store, set1, add, sub, mul, neg, madd = a * b + c, msub = a * b - c, and
+ * transpose, which transposes an L x L block held in L registers). Where the instruction
+ * set has half precision conversions, P also provides load_half and store_half, which
+ * convert L binary16 values to and from a register (see ne10_cvt_float16_float32).
+ *
+ * Every translation unit is compiled with different instruction set flags, so
+ * everything below lives in an anonymous namespace: each ISA gets its own
+ * private instantiation and the linker can never fold, for example, an AVX-512
+ * build of a shared template into the SSE2 code path.
+ */
+#ifndef NE10_FFT_SIMD_H
+#define NE10_FFT_SIMD_H
+
+#include <string.h>
+#include "NE10_fft.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define NE10_FFT_X86 1
+#endif
+
+/*
+ * Kernel table selected at run time. Each ISA translation unit exports a getter that
+ * returns its table, or NULL if the unit was built without the required compiler flags.
+ */
+// 'scale' multiplies the result, 1.0f leaves it unscaled
+typedef void (*ne10_fft_butterfly_float32_t) (ne10_fft_cpx_float32_t *out,
+        ne10_fft_cpx_float32_t *in,
+        ne10_int32_t *factors,
+        ne10_fft_cpx_float32_t *twiddles,
+        ne10_fft_cpx_float32_t *buffer,
+        ne10_float32_t scale);
+
+// Bins 1 .. ncfft - 1 of the real-to-complex split or complex-to-real merge
+typedef void (*ne10_fft_split_float32_t) (ne10_fft_cpx_float32_t *dst,
+        const ne10_fft_cpx_float32_t *src,
+        ne10_fft_cpx_float32_t *twiddles,
+        ne10_int32_t ncfft);
+
+// The same with the spectrum as separate real and imaginary arrays
+typedef void (*ne10_fft_split_r2c_soa_float32_t) (ne10_float32_t *re,
+        ne10_float32_t *im,
+        const ne10_fft_cpx_float32_t *src,
+        ne10_fft_cpx_float32_t *twiddles,
+        ne10_int32_t ncfft);
+
+typedef void (*ne10_fft_split_c2r_soa_float32_t) (ne10_fft_cpx_float32_t *dst,
+        const ne10_float32_t *re,
+        const ne10_float32_t *im,
+        ne10_fft_cpx_float32_t *twiddles,
+        ne10_int32_t ncfft);
+
+/*
+ * Real transforms of 'lanes' channels at once (see ne10_fft_r2c_lanes_float32). 'buffer'
+ * holds 2 * ncfft * lanes complex values; 'scale' is passed on to the butterfly.
+ */
+typedef void (*ne10_fft_lanes_float32_t) (ne10_float32_t *out,
+        ne10_float32_t *in,
+        ne10_int32_t *factors,
+        ne10_fft_cpx_float32_t *twiddles,
+        ne10_fft_cpx_float32_t *super_twiddles,
+        ne10_int32_t ncfft,
+        ne10_fft_cpx_float32_t *buffer,
+        ne10_float32_t scale);
+
+// dst[c * dst_stride + r] = src[r * src_stride + c] for r < rows, c < cols
+typedef void (*ne10_transpose_float32_t) (ne10_float32_t *dst,
+        ne10_int32_t dst_stride,
+        const ne10_float32_t *src,
+        ne10_int32_t src_stride,
+        ne10_int32_t rows,
+        ne10_int32_t cols);
+
+typedef struct
+{
+    ne10_int32_t lanes;                     // channels per call, 0 marks an unused entry
+    ne10_fft_lanes_float32_t r2c;
+    ne10_fft_lanes_float32_t c2r;
+} ne10_fft_lanes_kernels_float32_t;
+
+#define NE10_FFT_LANES_KERNELS 3
+
+// IEEE binary16 <-> float conversion of 'count' values, rounding to nearest even
+typedef void (*ne10_cvt_float16_float32_t) (ne10_float32_t *dst,
+        const ne10_float16_t *src,
+        ne10_int32_t count);
+
+typedef void (*ne10_cvt_float32_float16_t) (ne10_float16_t *dst,
+        const ne10_float32_t *src,
+        ne10_int32_t count);
+
+typedef struct
+{
+    ne10_int32_t isa;
+    ne10_fft_butterfly_float32_t butterfly;
+    ne10_fft_butterfly_float32_t butterfly_inverse;
+    ne10_fft_split_float32_t split_r2c;
+    ne10_fft_split_float32_t split_c2r;
+    ne10_fft_split_r2c_soa_float32_t split_r2c_soa;
+    ne10_fft_split_c2r_soa_float32_t split_c2r_soa;
+    ne10_fft_lanes_kernels_float32_t lanes[NE10_FFT_LANES_KERNELS]; // widest first
+    ne10_transpose_float32_t transpose;
+    ne10_cvt_float16_float32_t cvt_float16_float32;
+    ne10_cvt_float32_float16_t cvt_float32_float16;
+} ne10_fft_kernels_float32_t;
+
+const ne10_fft_kernels_float32_t* ne10_fft_kernels_sse2_float32 (void);
+const ne10_fft_kernels_float32_t* ne10_fft_kernels_avx2_float32 (void);
+const ne10_fft_kernels_float32_t* ne10_fft_kernels_avx512_float32 (void);
+
+namespace
+{
+
+/*
+ * Plain scalar traits (W = 1). Used as the final fallback of every vector traits type,
+ * e.g. for the first stage of very short transforms.
+ */
+struct ne10_fft_scalar_traits
+{
+    typedef ne10_fft_cpx_float32_t elem_t;
+    typedef ne10_fft_cpx_float32_t reg_t;
+    typedef ne10_fft_scalar_traits half_t;
+    enum { W = 1 };
+
+    static inline reg_t load (const elem_t *p) { return *p; }
+    static inline void store (elem_t *p, reg_t x) { *p = x; }
+    static inline reg_t load_tw (const ne10_fft_cpx_float32_t *tw) { return *tw; }
+
+    static inline reg_t add (reg_t a, reg_t b)
+    {
+        reg_t c;
+        c.r = a.r + b.r;
+        c.i = a.i + b.i;
+        return c;
+    }
+
+    static inline reg_t sub (reg_t a, reg_t b)
+    {
+        reg_t c;
+        c.r = a.r - b.r;
+        c.i = a.i - b.i;
+        return c;
+    }
+
+    static inline reg_t scale (reg_t x, ne10_float32_t s)
+    {
+        x.r *= s;
+        x.i *= s;
+        return x;
+    }
+
+    static inline reg_t mul_tw (reg_t x, reg_t tw)
+    {
+        reg_t c;
+        c.r = x.r * tw.r - x.i * tw.i;
+        c.i = x.i * tw.r + x.r * tw.i;
+        return c;
+    }
+
+    static inline reg_t mul_tw_conj (reg_t x, reg_t tw)
+    {
+        reg_t c;
+        c.r = x.r * tw.r + x.i * tw.i;
+        c.i = x.i * tw.r - x.r * tw.i;
+        return c;
+    }
+
+    static inline reg_t mul_neg_j (reg_t x)
+    {
+        reg_t c;
+        c.r = x.i;
+        c.i = -x.r;
+        return c;
+    }
+
+    static inline reg_t mul_pos_j (reg_t x)
+    {
+        reg_t c;
+        c.r = -x.i;
+        c.i = x.r;
+        return c;
+    }
+
+    static inline reg_t conj (reg_t x)
+    {
+        x.i = -x.i;
+        return x;
+    }
+
+    static inline reg_t reverse (reg_t x) { return x; }
+
+    template <int R>
+    static inline void store_transposed (elem_t *dst, const reg_t *o)
+    {
+        for (int k = 0; k < R; k++)
+        {
+            dst[k] = o[k];
+        }
+    }
+
+    static inline reg_t load_split (const ne10_float32_t *re, const ne10_float32_t *im)
+    {
+        reg_t x;
+        x.r = *re;
+        x.i = *im;
+        return x;
+    }
+
+    static inline void store_split (ne10_float32_t *re, ne10_float32_t *im, reg_t x)
+    {
+        *re = x.r;
+        *im = x.i;
+    }
+};
+
+#if defined(NE10_FFT_X86) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define NE10_FFT_HAVE_SSE2 1
+#include <emmintrin.h>
+
+// Two complex values per register
+struct ne10_fft_sse2_traits
+{
+    typedef ne10_fft_cpx_float32_t elem_t;
+    typedef __m128 reg_t;
+    typedef ne10_fft_scalar_traits half_t;
+    enum { W = 2 };
+
+    // Sign masks that negate the real (even) or imaginary (odd) lanes
+    static inline __m128 sign_re () { return _mm_set_ps (0.0f, -0.0f, 0.0f, -0.0f); }
+    static inline __m128 sign_im () { return _mm_set_ps (-0.0f, 0.0f, -0.0f, 0.0f); }
+    static inline __m128 swap_ri (__m128 x) { return _mm_shuffle_ps (x, x, _MM_SHUFFLE (2, 3, 0, 1)); }
+
+    static inline reg_t load (const elem_t *p) { return _mm_loadu_ps ( (const float*) p); }
+    static inline void store (elem_t *p, reg_t x) { _mm_storeu_ps ( (float*) p, x); }
+    static inline reg_t load_tw (const ne10_fft_cpx_float32_t *tw) { return _mm_loadu_ps ( (const float*) tw); }
+    static inline reg_t add (reg_t a, reg_t b) { return _mm_add_ps (a, b); }
+    static inline reg_t sub (reg_t a, reg_t b) { return _mm_sub_ps (a, b); }
+    static inline reg_t scale (reg_t x, ne10_float32_t s) { return _mm_mul_ps (x, _mm_set1_ps (s)); }
+
+    static inline reg_t mul_tw (reg_t x, reg_t tw)
+    {
+        __m128 tw_r = _mm_shuffle_ps (tw, tw, _MM_SHUFFLE (2, 2, 0, 0));
+        __m128 tw_i = _mm_shuffle_ps (tw, tw, _MM_SHUFFLE (3, 3, 1, 1));
+        return _mm_add_ps (_mm_mul_ps (x, tw_r), _mm_xor_ps (_mm_mul_ps (swap_ri (x), tw_i), sign_re ()));
+    }
+
+    static inline reg_t mul_tw_conj (reg_t x, reg_t tw)
+    {
+        __m128 tw_r = _mm_shuffle_ps (tw, tw, _MM_SHUFFLE (2, 2, 0, 0));
+        __m128 tw_i = _mm_shuffle_ps (tw, tw, _MM_SHUFFLE (3, 3, 1, 1));
+        return _mm_add_ps (_mm_mul_ps (x, tw_r), _mm_xor_ps (_mm_mul_ps (swap_ri (x), tw_i), sign_im ()));
+    }
+
+    static inline reg_t mul_neg_j (reg_t x) { return _mm_xor_ps (swap_ri (x), sign_im ()); }
+    static inline reg_t mul_pos_j (reg_t x) { return _mm_xor_ps (swap_ri (x), sign_re ()); }
+    static inline reg_t conj (reg_t x) { return _mm_xor_ps (x, sign_im ()); }
+    static inline reg_t reverse (reg_t x) { return _mm_shuffle_ps (x, x, _MM_SHUFFLE (1, 0, 3, 2)); }
+
+    // Stores o[k] lane l at dst[l * R + k], two registers at a time
+    template <int R>
+    static inline void store_transposed (elem_t *dst, const reg_t *o)
+    {
+        for (int k = 0; k < R; k += 2)
+        {
+            _mm_storeu_ps ( (float*) (dst + k), _mm_movelh_ps (o[k], o[k + 1]));
+            _mm_storeu_ps ( (float*) (dst + R + k), _mm_movehl_ps (o[k + 1], o[k]));
+        }
+    }
+
+    static inline reg_t load_split (const ne10_float32_t *re, const ne10_float32_t *im)
+    {
+        // Split arrays are only float aligned: movlps/movhps take any address, a double* must not
+        __m128 r = _mm_loadl_pi (_mm_setzero_ps(), (const __m64*) re);
+        __m128 i = _mm_loadl_pi (_mm_setzero_ps(), (const __m64*) im);
+        return _mm_unpacklo_ps (r, i);
+    }
+
+    static inline void store_split (ne10_float32_t *re, ne10_float32_t *im, reg_t x)
+    {
+        __m128 ri = _mm_shuffle_ps (x, x, _MM_SHUFFLE (3, 1, 2, 0));
+        _mm_storel_pi ( (__m64*) re, ri);
+        _mm_storeh_pi ( (__m64*) im, ri);
+    }
+};
+
+// Four channels per register
+struct ne10_fft_sse2_ps
+{
+    typedef __m128 ps_t;
+    enum { L = 4 };
+
+    static inline ps_t load (const ne10_float32_t *p) { return _mm_loadu_ps (p); }
+    static inline void store (ne10_float32_t *p, ps_t x) { _mm_storeu_ps (p, x); }
+    static inline ps_t set1 (ne10_float32_t x) { return _mm_set1_ps (x); }
+    static inline ps_t add (ps_t a, ps_t b) { return _mm_add_ps (a, b); }
+    static inline ps_t sub (ps_t a, ps_t b) { return _mm_sub_ps (a, b); }
+    static inline ps_t mul (ps_t a, ps_t b) { return _mm_mul_ps (a, b); }
+    static inline ps_t neg (ps_t x) { return _mm_xor_ps (x, _mm_set1_ps (-0.0f)); }
+    static inline ps_t madd (ps_t a, ps_t b, ps_t c) { return _mm_add_ps (_mm_mul_ps (a, b), c); }
+    static inline ps_t msub (ps_t a, ps_t b, ps_t c) { return _mm_sub_ps (_mm_mul_ps (a, b), c); }
+    static inline void transpose (ps_t *x) { _MM_TRANSPOSE4_PS (x[0], x[1], x[2], x[3]); }
+};
+#endif // SSE2
+
+#if defined(NE10_FFT_HAVE_SSE2) && defined(__AVX2__) && ((defined(__FMA__) && defined(__F16C__)) || defined(_MSC_VER))
+#define NE10_FFT_HAVE_AVX2 1
+#include <immintrin.h>
+
+// Four complex values per register
+struct ne10_fft_avx2_traits
+{
+    typedef ne10_fft_cpx_float32_t elem_t;
+    typedef __m256 reg_t;
+    typedef ne10_fft_sse2_traits half_t;
+    enum { W = 4 };
+
+    static inline __m256 sign_re () { return _mm256_set_ps (0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f); }
+    static inline __m256 sign_im () { return _mm256_set_ps (-0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f); }
+    static inline __m256 swap_ri (__m256 x) { return _mm256_permute_ps (x, _MM_SHUFFLE (2, 3, 0, 1)); }
+
+    static inline reg_t load (const elem_t *p) { return _mm256_loadu_ps ( (const float*) p); }
+    static inline void store (elem_t *p, reg_t x) { _mm256_storeu_ps ( (float*) p, x); }
+    static inline reg_t load_tw (const ne10_fft_cpx_float32_t *tw) { return _mm256_loadu_ps ( (const float*) tw); }
+    static inline reg_t add (reg_t a, reg_t b) { return _mm256_add_ps (a, b); }
+    static inline reg_t sub (reg_t a, reg_t b) { return _mm256_sub_ps (a, b); }
+    static inline reg_t scale (reg_t x, ne10_float32_t s) { return _mm256_mul_ps (x, _mm256_set1_ps (s)); }
+
+    static inline reg_t mul_tw (reg_t x, reg_t tw)
+    {
+        return _mm256_fmaddsub_ps (x, _mm256_moveldup_ps (tw), _mm256_mul_ps (swap_ri (x), _mm256_movehdup_ps (tw)));
+    }
+
+    static inline reg_t mul_tw_conj (reg_t x, reg_t tw)
+    {
+        return _mm256_fmsubadd_ps (x, _mm256_moveldup_ps (tw), _mm256_mul_ps (swap_ri (x), _mm256_movehdup_ps (tw)));
+    }
+
+    static inline reg_t mul_neg_j (reg_t x) { return _mm256_xor_ps (swap_ri (x), sign_im ()); }
+    static inline reg_t mul_pos_j (reg_t x) { return _mm256_xor_ps (swap_ri (x), sign_re ()); }
+    static inline reg_t conj (reg_t x) { return _mm256_xor_ps (x, sign_im ()); }
+
+    static inline reg_t reverse (reg_t x)
+    {
+        return _mm256_permute_ps (_mm256_permute2f128_ps (x, x, 0x01), _MM_SHUFFLE (1, 0, 3, 2));
+    }
+
+    // 4x4 transpose of complex (64-bit) elements: row l of the result is lane l of a, b, c, d
+    static inline void transpose4 (__m256 a, __m256 b, __m256 c, __m256 d, __m256 *r)
+    {
+        __m256d t0 = _mm256_unpacklo_pd (_mm256_castps_pd (a), _mm256_castps_pd (b));
+        __m256d t1 = _mm256_unpackhi_pd (_mm256_castps_pd (a), _mm256_castps_pd (b));
+        __m256d t2 = _mm256_unpacklo_pd (_mm256_castps_pd (c), _mm256_castps_pd (d));
+        __m256d t3 = _mm256_unpackhi_pd (_mm256_castps_pd (c), _mm256_castps_pd (d));
+        r[0] = _mm256_castpd_ps (_mm256_permute2f128_pd (t0, t2, 0x20));
+        r[1] = _mm256_castpd_ps (_mm256_permute2f128_pd (t1, t3, 0x20));
+        r[2] = _mm256_castpd_ps (_mm256_permute2f128_pd (t0, t2, 0x31));
+        r[3] = _mm256_castpd_ps (_mm256_permute2f128_pd (t1, t3, 0x31));
+    }
+
+    // Stores o[k] lane l at dst[l * R + k], four registers at a time
+    template <int R>
+    static inline void store_transposed (elem_t *dst, const reg_t *o)
+    {
+        __m256 r[4];
+        for (int k = 0; k < R; k += 4)
+        {
+            transpose4 (o[k], o[k + 1], o[k + 2], o[k + 3], r);
+            for (int l = 0; l < 4; l++)
+            {
+                _mm256_storeu_ps ( (float*) (dst + l * R + k), r[l]);
+            }
+        }
+    }
+
+    static inline reg_t load_split (const ne10_float32_t *re, const ne10_float32_t *im)
+    {
+        __m256 ri = _mm256_insertf128_ps (_mm256_castps128_ps256 (_mm_loadu_ps (re)), _mm_loadu_ps (im), 1);
+        return _mm256_permutevar8x32_ps (ri, _mm256_setr_epi32 (0, 4, 1, 5, 2, 6, 3, 7));
+    }
+
+    static inline void store_split (ne10_float32_t *re, ne10_float32_t *im, reg_t x)
+    {
+        __m256 ri = _mm256_permutevar8x32_ps (x, _mm256_setr_epi32 (0, 2, 4, 6, 1, 3, 5, 7));
+        _mm_storeu_ps (re, _mm256_castps256_ps128 (ri));
+        _mm_storeu_ps (im, _mm256_extractf128_ps (ri, 1));
+    }
+};
+
+// Eight channels per register
+struct ne10_fft_avx2_ps
+{
+    typedef __m256 ps_t;
+    enum { L = 8 };
+
+    static inline ps_t load (const ne10_float32_t *p) { return _mm256_loadu_ps (p); }
+    static inline void store (ne10_float32_t *p, ps_t x) { _mm256_storeu_ps (p, x); }
+    static inline ps_t set1 (ne10_float32_t x) { return _mm256_set1_ps (x); }
+    static inline ps_t add (ps_t a, ps_t b) { return _mm256_add_ps (a, b); }
+    static inline ps_t sub (ps_t a, ps_t b) { return _mm256_sub_ps (a, b); }
+    static inline ps_t mul (ps_t a, ps_t b) { return _mm256_mul_ps (a, b); }
+    static inline ps_t neg (ps_t x) { return _mm256_xor_ps (x, _mm256_set1_ps (-0.0f)); }
+    static inline ps_t madd (ps_t a, ps_t b, ps_t c) { return _mm256_fmadd_ps (a, b, c); }
+    static inline ps_t msub (ps_t a, ps_t b, ps_t c) { return _mm256_fmsub_ps (a, b, c); }
+    static inline ps_t load_half (const ne10_float16_t *p)
+    {
+        return _mm256_cvtph_ps (_mm_loadu_si128 ( (const __m128i*) p));
+    }
+    static inline void store_half (ne10_float16_t *p, ps_t x)
+    {
+        _mm_storeu_si128 ( (__m128i*) p, _mm256_cvtps_ph (x, _MM_FROUND_TO_NEAREST_INT));
+    }
+
+    static inline void transpose (ps_t *x)
+    {
+        __m256 t[8], u[8];
+        int i;
+
+        for (i = 0; i < 8; i += 2)
+        {
+            t[i] = _mm256_unpacklo_ps (x[i], x[i + 1]);
+            t[i + 1] = _mm256_unpackhi_ps (x[i], x[i + 1]);
+        }
+        for (i = 0; i < 8; i += 4)
+        {
+            u[i] = _mm256_shuffle_ps (t[i], t[i + 2], _MM_SHUFFLE (1, 0, 1, 0));
+            u[i + 1] = _mm256_shuffle_ps (t[i], t[i + 2], _MM_SHUFFLE (3, 2, 3, 2));
+            u[i + 2] = _mm256_shuffle_ps (t[i + 1], t[i + 3], _MM_SHUFFLE (1, 0, 1, 0));
+            u[i + 3] = _mm256_shuffle_ps (t[i + 1], t[i + 3], _MM_SHUFFLE (3, 2, 3, 2));
+        }
+        for (i = 0; i < 4; i++)
+        {
+            x[i] = _mm256_permute2f128_ps (u[i], u[i + 4], 0x20);
+            x[i + 4] = _mm256_permute2f128_ps (u[i], u[i + 4], 0x31);
+        }
+    }
+};
+#endif // AVX2
+
+#if defined(NE10_FFT_HAVE_AVX2) && defined(__AVX512F__)
+#define NE10_FFT_HAVE_AVX512 1
+
+// Eight complex values per register. Only AVX-512F is required.
+struct ne10_fft_avx512_traits
+{
+    typedef ne10_fft_cpx_float32_t elem_t;
+    typedef __m512 reg_t;
+    typedef ne10_fft_avx2_traits half_t;
+    enum { W = 8 };
+
+    static inline __m512 xor_ps (__m512 a, __m512 b)
+    {
+        return _mm512_castsi512_ps (_mm512_xor_si512 (_mm512_castps_si512 (a), _mm512_castps_si512 (b)));
+    }
+    static inline __m512 sign_re ()
+    {
+        return _mm512_set_ps (0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f,
+                              0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f);
+    }
+    static inline __m512 sign_im ()
+    {
+        return _mm512_set_ps (-0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f,
+                              -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f);
+    }
+    static inline __m512 swap_ri (__m512 x) { return _mm512_permute_ps (x, _MM_SHUFFLE (2, 3, 0, 1)); }
+
+    static inline reg_t load (const elem_t *p) { return _mm512_loadu_ps ( (const float*) p); }
+    static inline void store (elem_t *p, reg_t x) { _mm512_storeu_ps ( (float*) p, x); }
+    static inline reg_t load_tw (const ne10_fft_cpx_float32_t *tw) { return _mm512_loadu_ps ( (const float*) tw); }
+    static inline reg_t add (reg_t a, reg_t b) { return _mm512_add_ps (a, b); }
+    static inline reg_t sub (reg_t a, reg_t b) { return _mm512_sub_ps (a, b); }
+    static inline reg_t scale (reg_t x, ne10_float32_t s) { return _mm512_mul_ps (x, _mm512_set1_ps (s)); }
+
+    static inline reg_t mul_tw (reg_t x, reg_t tw)
+    {
+        return _mm512_fmaddsub_ps (x, _mm512_moveldup_ps (tw), _mm512_mul_ps (swap_ri (x), _mm512_movehdup_ps (tw)));
+    }
+
+    static inline reg_t mul_tw_conj (reg_t x, reg_t tw)
+    {
+        return _mm512_fmsubadd_ps (x, _mm512_moveldup_ps (tw), _mm512_mul_ps (swap_ri (x), _mm512_movehdup_ps (tw)));
+    }
+
+    static inline reg_t mul_neg_j (reg_t x) { return xor_ps (swap_ri (x), sign_im ()); }
+    static inline reg_t mul_pos_j (reg_t x) { return xor_ps (swap_ri (x), sign_re ()); }
+    static inline reg_t conj (reg_t x) { return xor_ps (x, sign_im ()); }
+
+    static inline reg_t reverse (reg_t x)
+    {
+        return _mm512_permute_ps (_mm512_shuffle_f32x4 (x, x, _MM_SHUFFLE (0, 1, 2, 3)), _MM_SHUFFLE (1, 0, 3, 2));
+    }
+
+    static inline __m256 lo (__m512 x) { return _mm512_castps512_ps256 (x); }
+    static inline __m256 hi (__m512 x) { return _mm256_castpd_ps (_mm512_extractf64x4_pd (_mm512_castps_pd (x), 1)); }
+
+    // Stores o[k] lane l at dst[l * R + k], as 4x4 transposes of the 256-bit halves
+    template <int R>
+    static inline void store_transposed (elem_t *dst, const reg_t *o)
+    {
+        __m256 r[4];
+        for (int k = 0; k < R; k += 4)
+        {
+            ne10_fft_avx2_traits::transpose4 (lo (o[k]), lo (o[k + 1]), lo (o[k + 2]), lo (o[k + 3]), r);
+            for (int l = 0; l < 4; l++)
+            {
+                _mm256_storeu_ps ( (float*) (dst + l * R + k), r[l]);
+            }
+            ne10_fft_avx2_traits::transpose4 (hi (o[k]), hi (o[k + 1]), hi (o[k + 2]), hi (o[k + 3]), r);
+            for (int l = 0; l < 4; l++)
+            {
+                _mm256_storeu_ps ( (float*) (dst + (l + 4) * R + k), r[l]);
+            }
+        }
+    }
+
+    static inline reg_t load_split (const ne10_float32_t *re, const ne10_float32_t *im)
+    {
+        __m512 ri = _mm512_castpd_ps (_mm512_insertf64x4 (_mm512_castpd256_pd512 (_mm256_castps_pd (_mm256_loadu_ps (re))),
+                                                         _mm256_castps_pd (_mm256_loadu_ps (im)), 1));
+        return _mm512_permutexvar_ps (_mm512_setr_epi32 (0, 8, 1, 9, 2, 10, 3, 11, 4, 12, 5, 13, 6, 14, 7, 15), ri);
+    }
+
+    static inline void store_split (ne10_float32_t *re, ne10_float32_t *im, reg_t x)
+    {
+        __m512 ri = _mm512_permutexvar_ps (_mm512_setr_epi32 (0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15), x);
+        _mm256_storeu_ps (re, lo (ri));
+        _mm256_storeu_ps (im, hi (ri));
+    }
+};
+
+// Sixteen channels per register
+struct ne10_fft_avx512_ps
+{
+    typedef __m512 ps_t;
+    enum { L = 16 };
+
+    static inline ps_t load (const ne10_float32_t *p) { return _mm512_loadu_ps (p); }
+    static inline void store (ne10_float32_t *p, ps_t x) { _mm512_storeu_ps (p, x); }
+    static inline ps_t set1 (ne10_float32_t x) { return _mm512_set1_ps (x); }
+    static inline ps_t add (ps_t a, ps_t b) { return _mm512_add_ps (a, b); }
+    static inline ps_t sub (ps_t a, ps_t b) { return _mm512_sub_ps (a, b); }
+    static inline ps_t mul (ps_t a, ps_t b) { return _mm512_mul_ps (a, b); }
+    static inline ps_t neg (ps_t x) { return ne10_fft_avx512_traits::xor_ps (x, _mm512_set1_ps (-0.0f)); }
+    static inline ps_t madd (ps_t a, ps_t b, ps_t c) { return _mm512_fmadd_ps (a, b, c); }
+    static inline ps_t msub (ps_t a, ps_t b, ps_t c) { return _mm512_fmsub_ps (a, b, c); }
+    static inline ps_t load_half (const ne10_float16_t *p)
+    {
+        return _mm512_cvtph_ps (_mm256_loadu_si256 ( (const __m256i*) p));
+    }
+    static inline void store_half (ne10_float16_t *p, ps_t x)
+    {
+        _mm256_storeu_si256 ( (__m256i*) p, _mm512_cvtps_ph (x, _MM_FROUND_TO_NEAREST_INT));
+    }
+};
+#endif // AVX512
+
+/*
+ * One complex value of P::L independent transforms per register (W = 1). Twiddles are
+ * shared by all channels and broadcast; no shuffles are needed at all.
+ */
+template <class P>
+struct ne10_fft_lanes_traits
+{
+    typedef typename P::ps_t ps_t;
+    struct elem_t
+    {
+        ne10_float32_t r[P::L];
+        ne10_float32_t i[P::L];
+    };
+    struct reg_t
+    {
+        ps_t r;
+        ps_t i;
+    };
+    typedef ne10_fft_lanes_traits half_t;
+    enum { W = 1 };
+
+    static inline reg_t make (ps_t r, ps_t i)
+    {
+        reg_t x;
+        x.r = r;
+        x.i = i;
+        return x;
+    }
+
+    static inline reg_t load (const elem_t *p) { return make (P::load (p->r), P::load (p->i)); }
+
+    static inline void store (elem_t *p, reg_t x)
+    {
+        P::store (p->r, x.r);
+        P::store (p->i, x.i);
+    }
+
+    static inline reg_t load_tw (const ne10_fft_cpx_float32_t *tw) { return make (P::set1 (tw->r), P::set1 (tw->i)); }
+    static inline reg_t add (reg_t a, reg_t b) { return make (P::add (a.r, b.r), P::add (a.i, b.i)); }
+    static inline reg_t sub (reg_t a, reg_t b) { return make (P::sub (a.r, b.r), P::sub (a.i, b.i)); }
+
+    static inline reg_t scale (reg_t x, ne10_float32_t s)
+    {
+        ps_t vs = P::set1 (s);
+        return make (P::mul (x.r, vs), P::mul (x.i, vs));
+    }
+
+    static inline reg_t mul_tw (reg_t x, reg_t tw)
+    {
+        return make (P::msub (x.r, tw.r, P::mul (x.i, tw.i)), P::madd (x.i, tw.r, P::mul (x.r, tw.i)));
+    }
+
+    static inline reg_t mul_tw_conj (reg_t x, reg_t tw)
+    {
+        return make (P::madd (x.r, tw.r, P::mul (x.i, tw.i)), P::msub (x.i, tw.r, P::mul (x.r, tw.i)));
+    }
+
+    static inline reg_t mul_neg_j (reg_t x) { return make (x.i, P::neg (x.r)); }
+    static inline reg_t mul_pos_j (reg_t x) { return make (P::neg (x.i), x.r); }
+    static inline reg_t conj (reg_t x) { return make (x.r, P::neg (x.i)); }
+    static inline reg_t reverse (reg_t x) { return x; }
+
+    template <int R>
+    static inline void store_transposed (elem_t *dst, const reg_t *o)
+    {
+        for (int k = 0; k < R; k++)
+        {
+            store (dst + k, o[k]);
+        }
+    }
+};
+
+// x * -i for the forward transform, x * i for the inverse
+template <class V, bool inverse>
+inline typename V::reg_t ne10_fft_rot (typename V::reg_t x)
+{
+    return inverse ? V::mul_pos_j (x) : V::mul_neg_j (x);
+}
+
+template <class V, bool inverse>
+inline typename V::reg_t ne10_fft_twiddle (typename V::reg_t x, typename V::reg_t tw)
+{
+    return inverse ? V::mul_tw_conj (x, tw) : V::mul_tw (x, tw);
+}
+
+/*
+ * First stage, radix-4: butterflies f read src[f + k * fstride] and write
+ * dst[f * 4 + k]. No twiddles are needed.
+ */
+template <class V, bool inverse>
+void ne10_fft_first_stage_r4 (typename V::elem_t *dst,
+        const typename V::elem_t *src,
+        ne10_int32_t fstride,
+        ne10_int32_t scaled,
+        ne10_float32_t scale)
+{
+    typedef typename V::reg_t reg_t;
+    ne10_int32_t f_count;
+
+    if (fstride % V::W)
+    {
+        ne10_fft_first_stage_r4<typename V::half_t, inverse> (dst, src, fstride, scaled, scale);
+        return;
+    }
+
+    for (f_count = 0; f_count < fstride; f_count += V::W)
+    {
+        reg_t in0 = V::load (src + f_count);
+        reg_t in1 = V::load (src + f_count + fstride);
+        reg_t in2 = V::load (src + f_count + fstride * 2);
+        reg_t in3 = V::load (src + f_count + fstride * 3);
+        reg_t s0 = V::add (in0, in2);
+        reg_t s1 = V::sub (in0, in2);
+        reg_t s2 = V::add (in1, in3);
+        reg_t s3 = ne10_fft_rot<V, inverse> (V::sub (in1, in3));
+        reg_t out[4];
+
+        out[0] = V::add (s0, s2);
+        out[1] = V::add (s1, s3);
+        out[2] = V::sub (s0, s2);
+        out[3] = V::sub (s1, s3);
+        if (scaled)
+        {
+            out[0] = V::scale (out[0], scale);
+            out[1] = V::scale (out[1], scale);
+            out[2] = V::scale (out[2], scale);
+            out[3] = V::scale (out[3], scale);
+        }
+        V::template store_transposed<4> (dst + f_count * 4, out);
+    }
+}
+
+/*
+ * First stage, radix-8 (nfft of form 2^{odd}): butterflies f read src[f + k * fstride]
+ * and write dst[f * 8 + k], using hardcoded radix-8 twiddles.
+ */
+template <class V, bool inverse>
+void ne10_fft_first_stage_r8 (typename V::elem_t *dst,
+        const typename V::elem_t *src,
+        ne10_int32_t fstride,
+        ne10_int32_t scaled,
+        ne10_float32_t scale)
+{
+    typedef typename V::reg_t reg_t;
+    const ne10_float32_t TW_81 = 0.70710678;
+    ne10_int32_t f_count, k;
+
+    if (fstride % V::W)
+    {
+        ne10_fft_first_stage_r8<typename V::half_t, inverse> (dst, src, fstride, scaled, scale);
+        return;
+    }
+
+    for (f_count = 0; f_count < fstride; f_count += V::W)
+    {
+        reg_t in0 = V::load (src + f_count);
+        reg_t in1 = V::load (src + f_count + fstride);
+        reg_t in2 = V::load (src + f_count + fstride * 2);
+        reg_t in3 = V::load (src + f_count + fstride * 3);
+        reg_t in4 = V::load (src + f_count + fstride * 4);
+        reg_t in5 = V::load (src + f_count + fstride * 5);
+        reg_t in6 = V::load (src + f_count + fstride * 6);
+        reg_t in7 = V::load (src + f_count + fstride * 7);
+
+        // X[k] +/- X[k + 4N/8]
+        reg_t s0 = V::add (in0, in4);
+        reg_t s1 = V::sub (in0, in4);
+        reg_t s2 = V::add (in1, in5);
+        reg_t s3 = V::sub (in1, in5);
+        reg_t s4 = V::add (in2, in6);
+        reg_t s5 = V::sub (in2, in6);
+        reg_t s6 = V::add (in3, in7);
+        reg_t s7 = V::sub (in3, in7);
+
+        // Hardcoded radix-8 twiddles: w^1 = (1 -/+ i) * TW_81, w^2 = -/+ i, w^3 = -(1 +/- i) * TW_81
+        s5 = ne10_fft_rot<V, inverse> (s5);
+        s3 = V::scale (V::add (s3, ne10_fft_rot<V, inverse> (s3)), TW_81);
+        s7 = V::scale (V::sub (s7, ne10_fft_rot<V, inverse> (s7)), TW_81);
+
+        reg_t s8 = V::add (s0, s4);
+        reg_t s9 = V::add (s1, s5);
+        reg_t s10 = V::sub (s0, s4);
+        reg_t s11 = V::sub (s1, s5);
+        reg_t s12 = V::add (s2, s6);
+        reg_t s13 = V::sub (s3, s7);
+        reg_t s14 = ne10_fft_rot<V, inverse> (V::sub (s2, s6));
+        reg_t s15 = ne10_fft_rot<V, inverse> (V::add (s3, s7));
+        reg_t out[8];
+
+        out[0] = V::add (s8, s12);
+        out[1] = V::add (s9, s13);
+        out[2] = V::add (s10, s14);
+        out[3] = V::add (s11, s15);
+        out[4] = V::sub (s8, s12);
+        out[5] = V::sub (s9, s13);
+        out[6] = V::sub (s10, s14);
+        out[7] = V::sub (s11, s15);
+        if (scaled)
+        {
+            for (k = 0; k < 8; k++)
+            {
+                out[k] = V::scale (out[k], scale);
+            }
+        }
+        V::template store_transposed<8> (dst + f_count * 8, out);
+    }
+}
+
+/*
+ * Radix-4 stage after the first: butterfly m of section f reads src[f * mstride + m + k * step],
+ * multiplies by twiddles[m + (k - 1) * mstride] and writes dst[f * mstride * 4 + m + k * mstride],
+ * or, for the last stage (which may run in place), dst[m + k * step].
+ */
+template <class V, bool inverse>
+void ne10_fft_radix4_stage (typename V::elem_t *dst,
+        const typename V::elem_t *src,
+        const ne10_fft_cpx_float32_t *twiddles,
+        ne10_int32_t fstride,
+        ne10_int32_t mstride,
+        ne10_int32_t step,
+        ne10_int32_t last,
+        ne10_float32_t scale)
+{
+    typedef typename V::reg_t reg_t;
+    ne10_int32_t f_count, m_count;
+    ne10_int32_t dst_stride = last ? step : mstride;
+
+    if (mstride % V::W)
+    {
+        ne10_fft_radix4_stage<typename V::half_t, inverse> (dst, src, twiddles, fstride, mstride, step, last, scale);
+        return;
+    }
+
+    for (f_count = 0; f_count < fstride; f_count++)
+    {
+        typename V::elem_t *d = last ? dst + f_count * mstride : dst + f_count * mstride * 4;
+        const typename V::elem_t *s = src + f_count * mstride;
+
+        for (m_count = 0; m_count < mstride; m_count += V::W)
+        {
+            reg_t tw0 = V::load_tw (twiddles + m_count);
+            reg_t tw1 = V::load_tw (twiddles + m_count + mstride);
+            reg_t tw2 = V::load_tw (twiddles + m_count + mstride * 2);
+            reg_t in0 = V::load (s + m_count);
+            reg_t in1 = ne10_fft_twiddle<V, inverse> (V::load (s + m_count + step), tw0);
+            reg_t in2 = ne10_fft_twiddle<V, inverse> (V::load (s + m_count + step * 2), tw1);
+            reg_t in3 = ne10_fft_twiddle<V, inverse> (V::load (s + m_count + step * 3), tw2);
+
+            reg_t s0 = V::add (in0, in2);
+            reg_t s1 = V::sub (in0, in2);
+            reg_t s2 = V::add (in1, in3);
+            reg_t s3 = ne10_fft_rot<V, inverse> (V::sub (in1, in3));
+
+            reg_t out0 = V::add (s0, s2);
+            reg_t out1 = V::add (s1, s3);
+            reg_t out2 = V::sub (s0, s2);
+            reg_t out3 = V::sub (s1, s3);
+            if (last && (scale != 1.0f))
+            {
+                out0 = V::scale (out0, scale);
+                out1 = V::scale (out1, scale);
+                out2 = V::scale (out2, scale);
+                out3 = V::scale (out3, scale);
+            }
+
+            V::store (d + m_count, out0);
+            V::store (d + m_count + dst_stride, out1);
+            V::store (d + m_count + dst_stride * 2, out2);
+            V::store (d + m_count + dst_stride * 3, out3);
+        }
+    }
+}
+
+/*
+ * Vectorised counterpart of ne10_mixed_radix_butterfly_float32_c and its inverse (same
+ * stage ordering, buffers and twiddle layout). Only power-of-two factorisations are handled.
+ * The result is multiplied by 'scale' in the first or last stage, whichever comes last.
+ */
+template <class V, bool inverse>
+void ne10_fft_mixed_radix_butterfly (ne10_fft_cpx_float32_t *out,
+        ne10_fft_cpx_float32_t *in,
+        ne10_int32_t *factors,
+        ne10_fft_cpx_float32_t *twiddles,
+        ne10_fft_cpx_float32_t *buffer,
+        ne10_float32_t scale)
+{
+    typedef typename V::elem_t elem_t;
+    ne10_int32_t stage_count = factors[0];
+    ne10_int32_t fstride = factors[1];
+    ne10_int32_t mstride = factors[ (stage_count << 1) - 1];
+    ne10_int32_t first_radix = factors[stage_count << 1];
+    ne10_float32_t one_by_nfft = scale;
+    ne10_int32_t step;
+    ne10_fft_cpx_float32_t *out_final = out;
+    ne10_fft_cpx_float32_t *tmp;
+
+    // The first stage (using hardcoded twiddles)
+    if (first_radix == 8)
+    {
+        stage_count--;
+        ne10_fft_first_stage_r8<V, inverse> ( (elem_t*) out, (const elem_t*) in, fstride,
+                                              (scale != 1.0f) && (stage_count == 0), one_by_nfft);
+        step = fstride << 1;
+        fstride /= 4;
+    }
+    else if (first_radix == 4)
+    {
+        stage_count--;
+        ne10_fft_first_stage_r4<V, inverse> ( (elem_t*) out, (const elem_t*) in, fstride,
+                                              (scale != 1.0f) && (stage_count == 0), one_by_nfft);
+        step = fstride;
+        fstride /= 4;
+    }
+    else if (first_radix == 2) // nfft = 2
+    {
+        ne10_fft_cpx_float32_t a = in[0], b = in[1];
+        out[0].r = (a.r + b.r) * one_by_nfft;
+        out[0].i = (a.i + b.i) * one_by_nfft;
+        out[1].r = (a.r - b.r) * one_by_nfft;
+        out[1].i = (a.i - b.i) * one_by_nfft;
+        return;
+    }
+    else // nfft = 1
+    {
+        out[0] = in[0];
+        return;
+    }
+
+    // The next stage should read the output of the first stage as input
+    in = out;
+    out = buffer;
+
+    // Middle stages (after the first, excluding the last)
+    for (; stage_count > 1; stage_count--)
+    {
+        ne10_fft_radix4_stage<V, inverse> ( (elem_t*) out, (const elem_t*) in, twiddles,
+                                            fstride, mstride, step, 0, one_by_nfft);
+
+        twiddles += mstride * 3;
+        mstride *= 4;
+        fstride /= 4;
+
+        // Swap the input and output buffers for the next stage
+        tmp = in;
+        in = out;
+        out = tmp;
+    }
+
+    // The last stage
+    if (stage_count)
+    {
+        ne10_fft_radix4_stage<V, inverse> ( (elem_t*) out_final, (const elem_t*) in, twiddles,
+                                            fstride, mstride, step, 1, one_by_nfft);
+    }
+}
+
+/*
+ * Bins [k, ncfft / 2] of the real-to-complex split (or, for the inverse, the complex-to-real
+ * merge). Bin k pairs src[k] with conj (src[ncfft - k]); W bins are processed at once by
+ * loading the mirrored block and reversing it, for as long as the forward and mirrored blocks
+ * do not overlap. The remaining bins around ncfft / 2 go to the narrower traits.
+ */
+template <class V, bool inverse>
+void ne10_fft_split_bins (typename V::elem_t *dst,
+        const typename V::elem_t *src,
+        const ne10_fft_cpx_float32_t *twiddles,
+        ne10_int32_t ncfft,
+        ne10_int32_t k)
+{
+    typedef typename V::reg_t reg_t;
+
+    for (; 2 * (k + V::W - 1) < ncfft; k += V::W)
+    {
+        reg_t fk = V::load (src + k);
+        reg_t fnkc = V::conj (V::reverse (V::load (src + ncfft - k - (V::W - 1))));
+        reg_t f1k = V::add (fk, fnkc);
+        reg_t tw = ne10_fft_twiddle<V, inverse> (V::sub (fk, fnkc), V::load_tw (twiddles + k - 1));
+
+        V::store (dst + k, V::scale (V::add (f1k, tw), 0.5f));
+        V::store (dst + ncfft - k - (V::W - 1), V::reverse (V::conj (V::scale (V::sub (f1k, tw), 0.5f))));
+    }
+
+    if (V::W > 1)
+    {
+        ne10_fft_split_bins<typename V::half_t, inverse> (dst, src, twiddles, ncfft, k);
+    }
+    else if (2 * k == ncfft)
+    {
+        // Middle bin, paired with itself
+        reg_t fk = V::load (src + k);
+        reg_t fnkc = V::conj (fk);
+        reg_t f1k = V::add (fk, fnkc);
+        reg_t tw = ne10_fft_twiddle<V, inverse> (V::sub (fk, fnkc), V::load_tw (twiddles + k - 1));
+
+        V::store (dst + k, V::conj (V::scale (V::sub (f1k, tw), 0.5f)));
+    }
+}
+
+// Vectorised counterpart of ne10_fft_split_r2c_1d_float32
+template <class V>
+void ne10_fft_split_r2c (ne10_fft_cpx_float32_t *dst,
+        const ne10_fft_cpx_float32_t *src,
+        ne10_fft_cpx_float32_t *twiddles,
+        ne10_int32_t ncfft)
+{
+    ne10_fft_split_bins<V, false> ( (typename V::elem_t*) dst, (const typename V::elem_t*) src, twiddles, ncfft, 1);
+}
+
+// Vectorised counterpart of ne10_fft_split_c2r_1d_float32
+template <class V>
+void ne10_fft_split_c2r (ne10_fft_cpx_float32_t *dst,
+        const ne10_fft_cpx_float32_t *src,
+        ne10_fft_cpx_float32_t *twiddles,
+        ne10_int32_t ncfft)
+{
+    ne10_fft_split_bins<V, true> ( (typename V::elem_t*) dst, (const typename V::elem_t*) src, twiddles, ncfft, 1);
+}
+
+/*
+ * ne10_fft_split_bins with the spectrum kept as separate real and imaginary arrays (bin k at
+ * re[k] and im[k]): the forward split writes them, the inverse merge reads them.
+ */
+template <class V>
+void ne10_fft_split_bins_r2c_soa (ne10_float32_t *re,
+        ne10_float32_t *im,
+        const typename V::elem_t *src,
+        const ne10_fft_cpx_float32_t *twiddles,
+        ne10_int32_t ncfft,
+        ne10_int32_t k)
+{
+    typedef typename V::reg_t reg_t;
+
+    for (; 2 * (k + V::W - 1) < ncfft; k += V::W)
+    {
+        ne10_int32_t nk = ncfft - k - (V::W - 1);
+        reg_t fk = V::load (src + k);
+        reg_t fnkc = V::conj (V::reverse (V::load (src + nk)));
+        reg_t f1k = V::add (fk, fnkc);
+        reg_t tw = V::mul_tw (V::sub (fk, fnkc), V::load_tw (twiddles + k - 1));
+
+        V::store_split (re + k, im + k, V::scale (V::add (f1k, tw), 0.5f));
+        V::store_split (re + nk, im + nk, V::reverse (V::conj (V::scale (V::sub (f1k, tw), 0.5f))));
+    }
+
+    if (V::W > 1)
+    {
+        ne10_fft_split_bins_r2c_soa<typename V::half_t> (re, im, src, twiddles, ncfft, k);
+    }
+    else if (2 * k == ncfft)
+    {
+        reg_t fk = V::load (src + k);
+        reg_t fnkc = V::conj (fk);
+        reg_t tw = V::mul_tw (V::sub (fk, fnkc), V::load_tw (twiddles + k - 1));
+
+        V::store_split (re + k, im + k, V::conj (V::scale (V::sub (V::add (fk, fnkc), tw), 0.5f)));
+    }
+}
+
+template <class V>
+void ne10_fft_split_bins_c2r_soa (typename V::elem_t *dst,
+        const ne10_float32_t *re,
+        const ne10_float32_t *im,
+        const ne10_fft_cpx_float32_t *twiddles,
+        ne10_int32_t ncfft,
+        ne10_int32_t k)
+{
+    typedef typename V::reg_t reg_t;
+
+    for (; 2 * (k + V::W - 1) < ncfft; k += V::W)
+    {
+        ne10_int32_t nk = ncfft - k - (V::W - 1);
+        reg_t fk = V::load_split (re + k, im + k);
+        reg_t fnkc = V::conj (V::reverse (V::load_split (re + nk, im + nk)));
+        reg_t f1k = V::add (fk, fnkc);
+        reg_t tw = V::mul_tw_conj (V::sub (fk, fnkc), V::load_tw (twiddles + k - 1));
+
+        V::store (dst + k, V::scale (V::add (f1k, tw), 0.5f));
+        V::store (dst + nk, V::reverse (V::conj (V::scale (V::sub (f1k, tw), 0.5f))));
+    }
+
+    if (V::W > 1)
+    {
+        ne10_fft_split_bins_c2r_soa<typename V::half_t> (dst, re, im, twiddles, ncfft, k);
+    }
+    else if (2 * k == ncfft)
+    {
+        reg_t fk = V::load_split (re + k, im + k);
+        reg_t fnkc = V::conj (fk);
+        reg_t tw = V::mul_tw_conj (V::sub (fk, fnkc), V::load_tw (twiddles + k - 1));
+
+        V::store (dst + k, V::conj (V::scale (V::sub (V::add (fk, fnkc), tw), 0.5f)));
+    }
+}
+
+// Bins 1 .. ncfft - 1 of the split, written to separate real and imaginary arrays
+template <class V>
+void ne10_fft_split_r2c_soa (ne10_float32_t *re,
+        ne10_float32_t *im,
+        const ne10_fft_cpx_float32_t *src,
+        ne10_fft_cpx_float32_t *twiddles,
+        ne10_int32_t ncfft)
+{
+    ne10_fft_split_bins_r2c_soa<V> (re, im, (const typename V::elem_t*) src, twiddles, ncfft, 1);
+}
+
+// Bins 1 .. ncfft - 1 of the merge, read from separate real and imaginary arrays
+template <class V>
+void ne10_fft_split_c2r_soa (ne10_fft_cpx_float32_t *dst,
+        const ne10_float32_t *re,
+        const ne10_float32_t *im,
+        ne10_fft_cpx_float32_t *twiddles,
+        ne10_int32_t ncfft)
+{
+    ne10_fft_split_bins_c2r_soa<V> ( (typename V::elem_t*) dst, re, im, twiddles, ncfft, 1);
+}
+
+/*
+ * Real-to-complex transform of P::L channels. 'in' holds the channels sample-interleaved
+ * (in[t * L + l]); 'out' receives ncfft + 1 bins, each as L real parts followed by L
+ * imaginary parts. Only power-of-two lengths with ncfft >= 4 are handled.
+ */
+template <class P>
+void ne10_fft_lanes_r2c (ne10_float32_t *out,
+        ne10_float32_t *in,
+        ne10_int32_t *factors,
+        ne10_fft_cpx_float32_t *twiddles,
+        ne10_fft_cpx_float32_t *super_twiddles,
+        ne10_int32_t ncfft,
+        ne10_fft_cpx_float32_t *buffer,
+        ne10_float32_t scale)
+{
+    typedef ne10_fft_lanes_traits<P> V;
+    typedef typename V::elem_t elem_t;
+    elem_t *dst = (elem_t*) out;
+    elem_t *tmp = (elem_t*) buffer;
+    ne10_int32_t l;
+
+    // 'out' doubles as the ping-pong buffer, which keeps the working set small
+    ne10_fft_mixed_radix_butterfly<V, false> ( (ne10_fft_cpx_float32_t*) tmp, (ne10_fft_cpx_float32_t*) in,
+            factors, twiddles, (ne10_fft_cpx_float32_t*) dst, scale);
+
+    for (l = 0; l < P::L; l++)
+    {
+        ne10_float32_t tdc_r = tmp[0].r[l];
+        ne10_float32_t tdc_i = tmp[0].i[l];
+        dst[0].r[l] = tdc_r + tdc_i;
+        dst[ncfft].r[l] = tdc_r - tdc_i;
+        dst[ncfft].i[l] = dst[0].i[l] = 0;
+    }
+    ne10_fft_split_bins<V, false> (dst, tmp, super_twiddles, ncfft, 1);
+}
+
+// Inverse of ne10_fft_lanes_r2c
+template <class P>
+void ne10_fft_lanes_c2r (ne10_float32_t *out,
+        ne10_float32_t *in,
+        ne10_int32_t *factors,
+        ne10_fft_cpx_float32_t *twiddles,
+        ne10_fft_cpx_float32_t *super_twiddles,
+        ne10_int32_t ncfft,
+        ne10_fft_cpx_float32_t *buffer,
+        ne10_float32_t scale)
+{
+    typedef ne10_fft_lanes_traits<P> V;
+    typedef typename V::elem_t elem_t;
+    const elem_t *src = (const elem_t*) in;
+    elem_t *tmp = (elem_t*) buffer;
+    ne10_int32_t l;
+
+    for (l = 0; l < P::L; l++)
+    {
+        tmp[0].r[l] = (src[0].r[l] + src[ncfft].r[l]) * 0.5f;
+        tmp[0].i[l] = (src[0].r[l] - src[ncfft].r[l]) * 0.5f;
+    }
+    ne10_fft_split_bins<V, true> (tmp, src, super_twiddles, ncfft, 1);
+
+    ne10_fft_mixed_radix_butterfly<V, true> ( (ne10_fft_cpx_float32_t*) out, (ne10_fft_cpx_float32_t*) tmp,
+            factors, twiddles, (ne10_fft_cpx_float32_t*) (tmp + ncfft), scale);
+}
+
+/*
+ * dst[c * dst_stride + r] = src[r * src_stride + c], in P::L x P::L blocks. Used to convert
+ * between planar and interleaved channels.
+ */
+template <class P>
+void ne10_transpose (ne10_float32_t *dst,
+        ne10_int32_t dst_stride,
+        const ne10_float32_t *src,
+        ne10_int32_t src_stride,
+        ne10_int32_t rows,
+        ne10_int32_t cols)
+{
+    typename P::ps_t x[P::L];
+    ne10_int32_t rows_v = rows - rows % P::L;
+    ne10_int32_t cols_v = cols - cols % P::L;
+    ne10_int32_t r, c, i;
+
+    for (r = 0; r < rows_v; r += P::L)
+    {
+        for (c = 0; c < cols_v; c += P::L)
+        {
+            for (i = 0; i < P::L; i++)
+            {
+                x[i] = P::load (src + (r + i) * src_stride + c);
+            }
+            P::transpose (x);
+            for (i = 0; i < P::L; i++)
+            {
+                P::store (dst + (c + i) * dst_stride + r, x[i]);
+            }
+        }
+        for (i = r; i < r + P::L; i++)
+        {
+            for (c = cols_v; c < cols; c++)
+            {
+                dst[c * dst_stride + i] = src[i * src_stride + c];
+            }
+        }
+    }
+    for (r = rows_v; r < rows; r++)
+    {
+        for (c = 0; c < cols; c++)
+        {
+            dst[c * dst_stride + r] = src[r * src_stride + c];
+        }
+    }
+}
+
+/*
+ * Scalar binary16 conversions. Half to float is exact; float to half rounds to nearest
+ * even. Subnormals, infinities and NaNs are preserved, and floats beyond the half range
+ * become infinities.
+ */
+static inline ne10_float32_t ne10_float16_to_float32 (ne10_float16_t h)
+{
+    ne10_uint32_t sign = (ne10_uint32_t) (h & 0x8000) << 16;
+    ne10_uint32_t exponent = (h >> 10) & 0x1f;
+    ne10_uint32_t mantissa = h & 0x3ff;
+    ne10_uint32_t bits;
+    ne10_float32_t f;
+
+    if (exponent == 0x1f)
+    {
+        bits = sign | 0x7f800000 | (mantissa << 13);
+    }
+    else if (exponent != 0)
+    {
+        bits = sign | ( (exponent + 112) << 23) | (mantissa << 13);
+    }
+    else
+    {
+        // Zero or subnormal: mantissa * 2^-24 is exact in float
+        f = (ne10_float32_t) mantissa * (1.0f / 16777216.0f);
+        memcpy (&bits, &f, sizeof (bits));
+        bits |= sign;
+    }
+    memcpy (&f, &bits, sizeof (f));
+    return f;
+}
+
+static inline ne10_float16_t ne10_float32_to_float16 (ne10_float32_t f)
+{
+    ne10_uint32_t bits;
+    ne10_uint32_t sign;
+
+    memcpy (&bits, &f, sizeof (bits));
+    sign = (bits >> 16) & 0x8000;
+    bits &= 0x7fffffff;
+
+    if (bits >= 0x47800000)
+    {
+        // 2^16 and above overflows; NaNs stay (quiet) NaNs
+        return (ne10_float16_t) (sign | (bits > 0x7f800000 ? 0x7e00 : 0x7c00));
+    }
+    if (bits < 0x38800000)
+    {
+        // Below 2^-14 the result is subnormal: adding 0.5 lets the FPU round the
+        // mantissa into the low bits
+        memcpy (&f, &bits, sizeof (f));
+        f += 0.5f;
+        memcpy (&bits, &f, sizeof (bits));
+        return (ne10_float16_t) (sign | (bits - 0x3f000000));
+    }
+    // Rebias the exponent and round to nearest even; a carry may reach infinity
+    bits += 0xc8000fff + ( (bits >> 13) & 1);
+    return (ne10_float16_t) (sign | (bits >> 13));
+}
+
+inline void ne10_cvt_float16_float32_c (ne10_float32_t *dst, const ne10_float16_t *src, ne10_int32_t count)
+{
+    ne10_int32_t i;
+    for (i = 0; i < count; i++)
+    {
+        dst[i] = ne10_float16_to_float32 (src[i]);
+    }
+}
+
+inline void ne10_cvt_float32_float16_c (ne10_float16_t *dst, const ne10_float32_t *src, ne10_int32_t count)
+{
+    ne10_int32_t i;
+    for (i = 0; i < count; i++)
+    {
+        dst[i] = ne10_float32_to_float16 (src[i]);
+    }
+}
+
+template <class P>
+void ne10_cvt_float16_float32 (ne10_float32_t *dst, const ne10_float16_t *src, ne10_int32_t count)
+{
+    ne10_int32_t i;
+    for (i = 0; i + P::L <= count; i += P::L)
+    {
+        P::store (dst + i, P::load_half (src + i));
+    }
+    ne10_cvt_float16_float32_c (dst + i, src + i, count - i);
+}
+
+template <class P>
+void ne10_cvt_float32_float16 (ne10_float16_t *dst, const ne10_float32_t *src, ne10_int32_t count)
+{
+    ne10_int32_t i;
+    for (i = 0; i + P::L <= count; i += P::L)
+    {
+        P::store_half (dst + i, P::load (src + i));
+    }
+    ne10_cvt_float32_float16_c (dst + i, src + i, count - i);
+}
+
+} // namespace
+
+#endif // NE10_FFT_SIMD_H
@@ -0,0 +1,76 @@
+#ifndef __ASYNC_IO_H__
+#define __ASYNC_IO_H__
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * I/O stage that moves file reads and writes off the processing thread. A dedicated
+ * thread prefetches input blocks into one bounded single-producer/single-consumer
+ * ring and drains output blocks from another, so a disk stall only reaches the
+ * processing loop once the input ring has run dry or the output ring has filled up.
+ * A full output ring blocks Get_async_output, which is the back-pressure that keeps
+ * memory bounded when the disk is slower than the processing.
+ *
+ * The rings hold fixed-size blocks allocated by Create_async_io; a block is handed
+ * out by pointer and never copied. Either side may be left out (NULL proc) for a
+ * read-only or write-only stage. All the functions below except Get_async_io_stats
+ * belong to one processing thread.
+ */
+typedef struct _TAsyncIO TAsyncIO;
+
+// Fills up to frame_count frames; fewer (or 0) means end of input, and < 0 an error
+typedef int (*TAsyncReadProc)(void* user, void* frames, const int frame_count);
+// Writes frame_count frames and returns the number written; fewer is an error
+typedef int (*TAsyncWriteProc)(void* user, const void* frames, const int frame_count);
+
+typedef struct _TAsyncIOConfig
+{
+    int block_frames; // frames per block
+    int in_frame_bytes; // bytes per input frame, channels * sample size
+    int out_frame_bytes;
+    int blocks; // ring depth per direction, >= 2; 2 is plain double buffering
+    TAsyncReadProc read; // NULL for no input
+    void* read_user;
+    TAsyncWriteProc write; // NULL for no output
+    void* write_user;
+}TAsyncIOConfig;
+
+typedef struct _TAsyncIOStats
+{
+    long long blocks_read;
+    long long blocks_written;
+    long long input_stalls; // Get_async_input calls that had to wait for the I/O thread
+    long long output_stalls; // Get_async_output calls held back by a full ring
+    double input_stall_ms; // time the processing thread spent in those waits
+    double output_stall_ms;
+    double read_ms; // time the I/O thread spent in the read and write procs
+    double write_ms;
+    int error; // nonzero once a proc has failed; reading stops, and output is dropped
+}TAsyncIOStats;
+
+TAsyncIO* Create_async_io(const TAsyncIOConfig* config); // starts the I/O thread; NULL if invalid or out of memory
+void Destroy_async_io(TAsyncIO* io); // flushes the committed output, then stops the thread
+
+/*
+ * Waits for the next input block and points *frames at it. Returns its frame count,
+ * which is block_frames except for the last block, and 0 once the input is exhausted.
+ * The block stays valid until Release_async_input, which must come before the next
+ * Get_async_input.
+ */
+int Get_async_input(TAsyncIO* io, const void** frames);
+void Release_async_input(TAsyncIO* io);
+
+/*
+ * Waits for a free output block of block_frames frames and returns it; NULL without
+ * a write proc. Commit_async_output queues its first frame_count frames for writing.
+ */
+void* Get_async_output(TAsyncIO* io);
+void Commit_async_output(TAsyncIO* io, const int frame_count);
+
+void Flush_async_io(TAsyncIO* io); // waits until every committed block has been written
+void Get_async_io_stats(TAsyncIO* io, TAsyncIOStats* stats);
+#ifdef __cplusplus
+}
+#endif
+#endif
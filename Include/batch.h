@@ -0,0 +1,67 @@
+#ifndef __BATCH_H__
+#define __BATCH_H__
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+#include "./thread_pool.h"
+
+/*
+ * Batch processing of many files, spread over the threads of a TThreadPool. The
+ * files come from a TBatchList: every *.wav in a directory (not recursive), or the
+ * lines of a manifest file. Each line is an input path, optionally followed by a tab
+ * and an output path; blank lines and lines starting with '#' are skipped. Files
+ * without an output path of their own are written to out_dir under their own name.
+ * Only the first of several files with the same output is processed.
+ *
+ * Each thread slot creates its engine state once, on its first file, and hands it
+ * to every file it processes after that, so FFT plans and buffers are allocated once
+ * per thread rather than once per file. Files are claimed one at a time, so a few
+ * long files do not hold the others back.
+ */
+typedef struct _TBatchList TBatchList;
+
+TBatchList* Create_batch_list(const char* source, const char* out_dir); // NULL if source can't be read or out of memory
+void Destroy_batch_list(TBatchList* list);
+int Get_batch_count(const TBatchList* list);
+const char* Get_batch_input(const TBatchList* list, const int index);
+const char* Get_batch_output(const TBatchList* list, const int index);
+int Get_batch_result(const TBatchList* list, const int index); // what process returned for the file in the last Run_batch
+
+typedef struct _TBatchFileInfo
+{
+    long long frames; // frames processed
+    int sample_rate;
+    int channels;
+}TBatchFileInfo;
+
+typedef struct _TBatchWorker
+{
+    void* (*create)(void* user); // engine state of one thread slot; NULL fails all of that slot's files
+    void (*destroy)(void* user, void* state);
+    // 0 on success, otherwise an error code of the caller's choosing, which is kept as the file's result
+    int (*process)(void* user, void* state, const char* in_path, const char* out_path, TBatchFileInfo* info);
+    void* user;
+}TBatchWorker;
+
+typedef struct _TBatchStats
+{
+    int files_ok;
+    int files_failed;
+    long long frames;
+    double audio_seconds; // sum of frames / sample_rate over the files processed
+    double wall_seconds;
+}TBatchStats;
+
+#define BATCH_ERROR_NO_STATE (-1) // result of a file whose slot could not create its state
+#define BATCH_ERROR_SAME_FILE (-2) // result of a file whose output is its input; it is skipped, not processed
+#define BATCH_ERROR_DUPLICATE_OUTPUT (-3) // result of a file whose output an earlier file of the list writes too; it is skipped
+
+/*
+ * Processes every file of the list, blocking until all are done. With a NULL pool
+ * the files are processed in order on the calling thread.
+ */
+void Run_batch(TBatchList* list, TThreadPool* pool, const TBatchWorker* worker, TBatchStats* stats);
+#ifdef __cplusplus
+}
+#endif
+#endif
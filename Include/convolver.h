@@ -0,0 +1,48 @@
+#ifndef __CONVOLVER_H__
+#define __CONVOLVER_H__
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+#include "./do_fft.h"
+typedef enum _TConvolverPartition
+{
+    kPartitionUniform = 0, // every partition block_len taps
+    kPartitionNonUniform // block_len at the head of the IR, doubling up to max_block_len
+}TConvolverPartition;
+
+typedef struct _TConvolverConfig
+{
+    int block_len; // smallest partition, and the latency in samples (any >= 1; powers of two are fastest)
+    TConvolverPartition partition;
+    int max_block_len; // kPartitionNonUniform: largest partition, block_len * 2^k; 0 for block_len * 32
+}TConvolverConfig;
+
+/*
+ * Partitioned overlap-save FIR convolution of one channel with an impulse response
+ * of any length. The IR is cut into partitions whose spectra are computed once;
+ * each stage (one per partition size) keeps a frequency-domain delay line of the
+ * spectra of its past input blocks, so a block of output costs one forward and one
+ * inverse FFT of twice the partition size plus a complex multiply-add per partition.
+ * Non-uniform stages start the larger partitions as late in the IR as the latency
+ * allows, so long IRs keep the latency of block_len at the cost of far fewer bins.
+ * The output equals direct convolution, to float rounding, delayed by block_len.
+ * All buffers and FFT plans are allocated by Create_convolver; processing never
+ * allocates. A convolver must not be used by two threads at once.
+ */
+typedef struct _TConvolver TConvolver;
+
+TConvolver* Create_convolver(const float* ir, const int ir_len, const TConvolverConfig* config); // NULL if invalid or out of memory
+void Destroy_convolver(TConvolver* conv);
+void Reset_convolver(TConvolver* conv); // clears the input history and pending output
+int Get_convolver_latency(const TConvolver* conv); // block_len
+int Get_convolver_partition_count(const TConvolver* conv);
+
+/*
+ * Pushes count (any number of) samples of data_in and writes as many samples of
+ * output, delayed by Get_convolver_latency, to data_out. data_out may equal data_in.
+ */
+TFFTResult Do_convolver_process(TConvolver* conv, float* data_out, const float* data_in, const int count);
+#ifdef __cplusplus
+}
+#endif
+#endif
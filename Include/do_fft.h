@@ -8,11 +8,107 @@ typedef enum _TFFTFormat
 {
     kHalfComplexInPlace = 0, // r[0],r[1],...,r[n/2],i[n/2 - 1]...i[1]
     kIntelPerm,// r[0],r[n/2],r[1],i[1],...,r[n/2 - 1],i[n/2 - 1]
-    kIntelCCS // r[0],0,r[1],i[1],...,r[n/2 - 1],i[n/2 - 1],r[n/2],0
+    kIntelCCS, // r[0],0,r[1],i[1],...,r[n/2 - 1],i[n/2 - 1],r[n/2],0
+    kSplitComplex // r[0],r[1],...,r[n/2],0,i[1],...,i[n/2 - 1],0: re = data, im = data + n/2 + 1
 }TFFTFormat;
 
-void Do_fftr(float* data_out, float* data_in, const int fft_len, TFFTFormat format);
-void Do_ifftr(float* data_out, float* data_in, const int fft_len, TFFTFormat format);
+typedef enum _TFFTResult
+{
+    kFFTOk = 0,
+    kFFTErrNullPointer = -1,
+    kFFTErrUnsupportedLength = -2, // see Is_fft_length_supported
+    kFFTErrOutOfMemory = -3,
+    kFFTErrInvalidArgument = -4
+}TFFTResult;
+
+/*
+ * Normalisation of a plan; with any of them Do_ifftr(Do_fftr(x)) returns x, except
+ * kFFTScaleNone which returns fft_len * x.
+ */
+typedef enum _TFFTScaling
+{
+    kFFTScaleNone = 0,
+    kFFTScaleForward, // 1/N on the forward transform
+    kFFTScaleInverse, // 1/N on the inverse transform (default)
+    kFFTScaleSymmetric // 1/sqrt(N) on both
+}TFFTScaling;
+
+typedef enum _TFFTLayout
+{
+    kPlanar = 0, // channel c at data[c * frame_len + t]
+    kInterleaved // channel c at data[t * channels + c]
+}TFFTLayout;
+
+/*
+ * Real transforms support any even fft_len >= 2. Lengths whose half is a power
+ * of two use the vectorised radix-4/8 kernels; other lengths are factored into
+ * radix-2/3/4/5 stages plus at most one generic-radix stage (a prime > 5 makes
+ * that stage O(p^2), so prefer 2^a 3^b 5^c lengths). There is no upper bound
+ * other than memory: all scratch is heap allocated with the plan.
+ */
+int Is_fft_length_supported(const int fft_len);
+int Is_fft_format_supported(TFFTFormat format); // one of the TFFTFormat values
+
+/*
+ * FFT plan: holds the spectrum scratch for one transform length and refers to
+ * the twiddle/factor tables of that length, which are built once per process
+ * and shared by all plans. Create it once per size, execute it for every frame
+ * and destroy it at shutdown. A plan must not be executed by two threads at once.
+ */
+typedef struct _TFFTPlan TFFTPlan;
+
+TFFTPlan* Create_fft_plan(const int fft_len); // NULL if unsupported or out of memory
+void Destroy_fft_plan(TFFTPlan* plan);
+int Get_fft_plan_length(const TFFTPlan* plan);
+TFFTResult Set_fft_plan_scaling(TFFTPlan* plan, TFFTScaling scaling);
+TFFTScaling Get_fft_plan_scaling(const TFFTPlan* plan);
+/*
+ * kIntelCCS, kIntelPerm and kSplitComplex are written (and read) by the FFT kernels
+ * directly, with no intermediate copy. data_out may equal data_in for every format;
+ * in-place forward kIntelCCS and kSplitComplex transforms need fft_len + 2 floats.
+ */
+TFFTResult Do_fftr_plan(TFFTPlan* plan, float* data_out, float* data_in, TFFTFormat format);
+TFFTResult Do_ifftr_plan(TFFTPlan* plan, float* data_out, float* data_in, TFFTFormat format);
+
+/*
+ * One-shot transforms. Plans are looked up in a small per-thread cache keyed by
+ * fft_len, so repeated calls with the same size do not allocate or recompute
+ * twiddles. Release_fft_plan_cache frees the cache of the calling thread.
+ */
+TFFTResult Do_fftr(float* data_out, float* data_in, const int fft_len, TFFTFormat format);
+TFFTResult Do_ifftr(float* data_out, float* data_in, const int fft_len, TFFTFormat format);
+void Release_fft_plan_cache(void);
+
+/*
+ * Batched transforms of 'channels' frames of the same length. frame_len (see
+ * TFFTLayout) is fft_len for signals and Get_fft_spectrum_length for spectra.
+ * Interleaved channels are transformed several per pass, one per SIMD lane with
+ * shared twiddles, without de-interleaving them first; planar channels reuse
+ * one plan and its scratch across the whole batch.
+ */
+int Get_fft_spectrum_length(const int fft_len, TFFTFormat format); // floats per channel
+TFFTResult Do_fftr_batch_plan(TFFTPlan* plan, float* data_out, float* data_in, const int channels, TFFTLayout layout, TFFTFormat format);
+TFFTResult Do_ifftr_batch_plan(TFFTPlan* plan, float* data_out, float* data_in, const int channels, TFFTLayout layout, TFFTFormat format);
+TFFTResult Do_fftr_batch(float* data_out, float* data_in, const int fft_len, const int channels, TFFTLayout layout, TFFTFormat format);
+TFFTResult Do_ifftr_batch(float* data_out, float* data_in, const int fft_len, const int channels, TFFTLayout layout, TFFTFormat format);
+
+/*
+ * Fixed-point transforms of 16-bit (short) and 32-bit (int) samples, in integer
+ * arithmetic only, for power-of-two fft_len >= 4 (kFFTErrUnsupportedLength otherwise).
+ * They use block floating point: each stage shifts the whole frame just enough to rule
+ * out overflow, and the forward transform returns the total as a block exponent, so
+ * the spectrum is data_out * 2^exponent. The inverse takes that exponent back and
+ * returns saturated samples at the scale of the input; the plan scaling applies as for
+ * floats. Spectra use the float formats and lengths, in samples instead of floats.
+ */
+TFFTResult Do_fftr_s16_plan(TFFTPlan* plan, short* data_out, const short* data_in, int* exponent, TFFTFormat format);
+TFFTResult Do_ifftr_s16_plan(TFFTPlan* plan, short* data_out, const short* data_in, const int exponent, TFFTFormat format);
+TFFTResult Do_fftr_s32_plan(TFFTPlan* plan, int* data_out, const int* data_in, int* exponent, TFFTFormat format);
+TFFTResult Do_ifftr_s32_plan(TFFTPlan* plan, int* data_out, const int* data_in, const int exponent, TFFTFormat format);
+TFFTResult Do_fftr_s16(short* data_out, const short* data_in, const int fft_len, int* exponent, TFFTFormat format);
+TFFTResult Do_ifftr_s16(short* data_out, const short* data_in, const int fft_len, const int exponent, TFFTFormat format);
+TFFTResult Do_fftr_s32(int* data_out, const int* data_in, const int fft_len, int* exponent, TFFTFormat format);
+TFFTResult Do_ifftr_s32(int* data_out, const int* data_in, const int fft_len, const int exponent, TFFTFormat format);
 #ifdef __cplusplus
 }
 #endif
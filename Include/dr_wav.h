@@ -92,6 +92,9 @@ Build Options
 #define DR_WAV_NO_STDIO
   Disables APIs that initialize a decoder from a file such as `drwav_init_file()`, `drwav_init_file_write()`, etc.
 
+#define DR_WAV_NO_MMAP
+  Disables the memory-mapped file loader, `drwav_init_file_mmap()`, which needs mmap() or the Win32 file mapping API.
+
 
 
 Notes
@@ -878,6 +881,9 @@ typedef struct
     drwav__memory_stream memoryStream;
     drwav__memory_stream_write memoryStreamWrite;
 
+    /* Set when memoryStream is a view of a file mapped by drwav_init_file_mmap(), which drwav_uninit() unmaps. */
+    drwav_bool32 isMemoryMapped;
+
 
     /* Microsoft ADPCM specific data. */
     struct
@@ -1217,6 +1223,32 @@ DRWAV_API drwav_bool32 drwav_init_memory(drwav* pWav, const void* data, size_t d
 DRWAV_API drwav_bool32 drwav_init_memory_ex(drwav* pWav, const void* data, size_t dataSize, drwav_chunk_proc onChunk, void* pChunkUserData, drwav_uint32 flags, const drwav_allocation_callbacks* pAllocationCallbacks);
 DRWAV_API drwav_bool32 drwav_init_memory_with_metadata(drwav* pWav, const void* data, size_t dataSize, drwav_uint32 flags, const drwav_allocation_callbacks* pAllocationCallbacks);
 
+#ifndef DR_WAV_NO_MMAP
+/*
+Helper for initializing a loader from a read-only memory mapping of a whole file.
+
+The headers are parsed exactly as drwav_init_memory() would parse them, so RIFF, RF64 and W64 files all work,
+including ones larger than 4GB on 64-bit builds. The mapping is hinted for sequential access and released by
+drwav_uninit(). All the drwav_read_pcm_frames*() APIs work as usual; use drwav_map_pcm_frames() to read
+without copying.
+*/
+DRWAV_API drwav_bool32 drwav_init_file_mmap(drwav* pWav, const char* filename, const drwav_allocation_callbacks* pAllocationCallbacks);
+DRWAV_API drwav_bool32 drwav_init_file_mmap_ex(drwav* pWav, const char* filename, drwav_chunk_proc onChunk, void* pChunkUserData, drwav_uint32 flags, const drwav_allocation_callbacks* pAllocationCallbacks);
+#endif
+
+/*
+Returns a pointer to up to framesToMap PCM frames at the read cursor and advances the cursor past them, as
+drwav_read_pcm_frames() would, but without copying.
+
+pFramesMapped receives the number of frames the pointer covers, which is fewer than requested at the end of
+the data chunk. The frames are in the file's own format, interleaved and little-endian, exactly as
+drwav_read_pcm_frames() would return them. The pointer stays valid until drwav_uninit().
+
+Only loaders backed by memory (drwav_init_memory() or drwav_init_file_mmap()) with an uncompressed format
+can be mapped; NULL is returned otherwise, and at the end of the data.
+*/
+DRWAV_API const void* drwav_map_pcm_frames(drwav* pWav, drwav_uint64 framesToMap, drwav_uint64* pFramesMapped);
+
 /*
 Helper for initializing a writer which outputs data to a memory buffer.
 
@@ -1300,12 +1332,24 @@ DRWAV_API drwav_bool32 drwav_fourcc_equal(const drwav_uint8* a, const char* b);
 #include <stdlib.h>
 #include <string.h> /* For memcpy(), memset() */
 #include <limits.h> /* For INT_MAX */
+#include "pcm_convert.h" /* Vectorised sample format conversions */
 
 #ifndef DR_WAV_NO_STDIO
 #include <stdio.h>
 #include <wchar.h>
 #endif
 
+#ifndef DR_WAV_NO_MMAP
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#endif
+
 /* Standard library stuff. */
 #ifndef DRWAV_ASSERT
 #include <assert.h>
@@ -5092,6 +5136,157 @@ DRWAV_API drwav_bool32 drwav_init_memory_with_metadata(drwav* pWav, const void*
     return drwav_init__internal(pWav, NULL, NULL, flags);
 }
 
+#ifndef DR_WAV_NO_MMAP
+DRWAV_PRIVATE drwav_bool32 drwav__map_file(const char* filename, void** ppData, size_t* pDataSize)
+{
+    void* pData = NULL;
+    drwav_uint64 fileSize;
+
+#if defined(_WIN32)
+    HANDLE hFile;
+    HANDLE hMapping;
+    LARGE_INTEGER size;
+
+    hFile = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (hFile == INVALID_HANDLE_VALUE) {
+        return DRWAV_FALSE;
+    }
+
+    if (!GetFileSizeEx(hFile, &size) || size.QuadPart <= 0 || (drwav_uint64)size.QuadPart > (drwav_uint64)((size_t)-1)) {
+        CloseHandle(hFile);
+        return DRWAV_FALSE;
+    }
+    fileSize = (drwav_uint64)size.QuadPart;
+
+    /* The view keeps the mapping object alive, so neither handle is needed once it exists. */
+    hMapping = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (hMapping != NULL) {
+        pData = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(hMapping);
+    }
+    CloseHandle(hFile);
+
+    if (pData == NULL) {
+        return DRWAV_FALSE;
+    }
+#else
+    int fd;
+    struct stat st;
+
+    fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return DRWAV_FALSE;
+    }
+
+    if (fstat(fd, &st) != 0 || st.st_size <= 0 || (drwav_uint64)st.st_size > (drwav_uint64)((size_t)-1)) {
+        close(fd);
+        return DRWAV_FALSE;
+    }
+    fileSize = (drwav_uint64)st.st_size;
+
+    /* The mapping holds its own reference to the file. */
+    pData = mmap(NULL, (size_t)fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (pData == MAP_FAILED) {
+        return DRWAV_FALSE;
+    }
+
+#if defined(MADV_SEQUENTIAL)
+    /* Aggressive read-ahead, and pages behind the cursor may be dropped early. Purely a hint, so failure is ignored. */
+    madvise(pData, (size_t)fileSize, MADV_SEQUENTIAL);
+#endif
+#endif
+
+    *ppData    = pData;
+    *pDataSize = (size_t)fileSize;
+    return DRWAV_TRUE;
+}
+
+DRWAV_PRIVATE void drwav__unmap_file(const void* pData, size_t dataSize)
+{
+#if defined(_WIN32)
+    (void)dataSize;
+    UnmapViewOfFile(pData);
+#else
+    munmap((void*)pData, dataSize);
+#endif
+}
+
+DRWAV_API drwav_bool32 drwav_init_file_mmap(drwav* pWav, const char* filename, const drwav_allocation_callbacks* pAllocationCallbacks)
+{
+    return drwav_init_file_mmap_ex(pWav, filename, NULL, NULL, 0, pAllocationCallbacks);
+}
+
+DRWAV_API drwav_bool32 drwav_init_file_mmap_ex(drwav* pWav, const char* filename, drwav_chunk_proc onChunk, void* pChunkUserData, drwav_uint32 flags, const drwav_allocation_callbacks* pAllocationCallbacks)
+{
+    void* pData;
+    size_t dataSize;
+
+    if (pWav == NULL || filename == NULL) {
+        return DRWAV_FALSE;
+    }
+
+    if (!drwav__map_file(filename, &pData, &dataSize)) {
+        return DRWAV_FALSE;
+    }
+
+    if (!drwav_init_memory_ex(pWav, pData, dataSize, onChunk, pChunkUserData, flags, pAllocationCallbacks)) {
+        drwav__unmap_file(pData, dataSize);
+        return DRWAV_FALSE;
+    }
+
+    pWav->isMemoryMapped = DRWAV_TRUE;
+    return DRWAV_TRUE;
+}
+#endif  /* DR_WAV_NO_MMAP */
+
+DRWAV_API const void* drwav_map_pcm_frames(drwav* pWav, drwav_uint64 framesToMap, drwav_uint64* pFramesMapped)
+{
+    const void* pFrames;
+    drwav_uint32 bytesPerFrame;
+    drwav_uint64 bytesAvailable;
+    drwav_uint64 framesMapped;
+
+    if (pFramesMapped != NULL) {
+        *pFramesMapped = 0;
+    }
+
+    if (pWav == NULL || pWav->onRead != drwav__on_read_memory || drwav__is_compressed_format_tag(pWav->translatedFormatTag)) {
+        return NULL;
+    }
+
+    bytesPerFrame = drwav_get_bytes_per_pcm_frame(pWav);
+    if (bytesPerFrame == 0) {
+        return NULL;
+    }
+
+    /* A truncated file can claim a data chunk longer than what is actually there. */
+    bytesAvailable = pWav->memoryStream.dataSize - pWav->memoryStream.currentReadPos;
+    if (bytesAvailable > pWav->bytesRemaining) {
+        bytesAvailable = pWav->bytesRemaining;
+    }
+
+    framesMapped = bytesAvailable / bytesPerFrame;
+    if (framesMapped > framesToMap) {
+        framesMapped = framesToMap;
+    }
+
+    if (framesMapped == 0) {
+        return NULL;
+    }
+
+    /* Passing no buffer to drwav_read_raw() only moves the cursor, which keeps the seek bookkeeping in one place. */
+    pFrames = pWav->memoryStream.data + pWav->memoryStream.currentReadPos;
+    drwav_read_raw(pWav, (size_t)(framesMapped * bytesPerFrame), NULL);
+
+    if (pFramesMapped != NULL) {
+        *pFramesMapped = framesMapped;
+    }
+
+    return pFrames;
+}
+
 
 DRWAV_PRIVATE drwav_bool32 drwav_init_memory_write__internal(drwav* pWav, void** ppData, size_t* pDataSize, const drwav_data_format* pFormat, drwav_uint64 totalSampleCount, drwav_bool32 isSequential, const drwav_allocation_callbacks* pAllocationCallbacks)
 {
@@ -5233,6 +5428,13 @@ DRWAV_API drwav_result drwav_uninit(drwav* pWav)
     }
 #endif
 
+#ifndef DR_WAV_NO_MMAP
+    if (pWav->isMemoryMapped) {
+        drwav__unmap_file(pWav->memoryStream.data, pWav->memoryStream.dataSize);
+        pWav->isMemoryMapped = DRWAV_FALSE;
+    }
+#endif
+
     return result;
 }
 
@@ -6045,9 +6247,7 @@ DRWAV_PRIVATE void drwav__pcm_to_s16(drwav_int16* pOut, const drwav_uint8* pIn,
 
     /* Slightly more optimal implementation for common formats. */
     if (bytesPerSample == 2) {
-        for (i = 0; i < totalSampleCount; ++i) {
-           *pOut++ = ((const drwav_int16*)pIn)[i];
-        }
+        DRWAV_COPY_MEMORY(pOut, pIn, totalSampleCount * sizeof(*pOut));
         return;
     }
     if (bytesPerSample == 3) {
@@ -6377,39 +6577,18 @@ DRWAV_API void drwav_u8_to_s16(drwav_int16* pOut, const drwav_uint8* pIn, size_t
 
 DRWAV_API void drwav_s24_to_s16(drwav_int16* pOut, const drwav_uint8* pIn, size_t sampleCount)
 {
-    int r;
-    size_t i;
-    for (i = 0; i < sampleCount; ++i) {
-        int x = ((int)(((unsigned int)(((const drwav_uint8*)pIn)[i*3+0]) << 8) | ((unsigned int)(((const drwav_uint8*)pIn)[i*3+1]) << 16) | ((unsigned int)(((const drwav_uint8*)pIn)[i*3+2])) << 24)) >> 8;
-        r = x >> 8;
-        pOut[i] = (short)r;
-    }
+    Pcm_s24_to_s16(pOut, pIn, sampleCount);
 }
 
 DRWAV_API void drwav_s32_to_s16(drwav_int16* pOut, const drwav_int32* pIn, size_t sampleCount)
 {
-    int r;
-    size_t i;
-    for (i = 0; i < sampleCount; ++i) {
-        int x = pIn[i];
-        r = x >> 16;
-        pOut[i] = (short)r;
-    }
+    Pcm_s32_to_s16(pOut, pIn, sampleCount);
 }
 
 DRWAV_API void drwav_f32_to_s16(drwav_int16* pOut, const float* pIn, size_t sampleCount)
 {
-    int r;
-    size_t i;
-    for (i = 0; i < sampleCount; ++i) {
-        float x = pIn[i];
-        float c;
-        c = ((x < -1) ? -1 : ((x > 1) ? 1 : x));
-        c = c + 1;
-        r = (int)(c * 32767.5f);
-        r = r - 32768;
-        pOut[i] = (short)r;
-    }
+    /* Rounds to nearest, so 0 maps to 0 and +/-1 to 32767/-32768 (the scalar original truncated). */
+    Pcm_f32_to_s16(pOut, pIn, sampleCount);
 }
 
 DRWAV_API void drwav_f64_to_s16(drwav_int16* pOut, const double* pIn, size_t sampleCount)
@@ -6822,46 +7001,29 @@ DRWAV_API void drwav_u8_to_f32(float* pOut, const drwav_uint8* pIn, size_t sampl
 
 DRWAV_API void drwav_s16_to_f32(float* pOut, const drwav_int16* pIn, size_t sampleCount)
 {
-    size_t i;
-
     if (pOut == NULL || pIn == NULL) {
         return;
     }
 
-    for (i = 0; i < sampleCount; ++i) {
-        *pOut++ = pIn[i] * 0.000030517578125f;
-    }
+    Pcm_s16_to_f32(pOut, pIn, sampleCount);
 }
 
 DRWAV_API void drwav_s24_to_f32(float* pOut, const drwav_uint8* pIn, size_t sampleCount)
 {
-    size_t i;
-
     if (pOut == NULL || pIn == NULL) {
         return;
     }
 
-    for (i = 0; i < sampleCount; ++i) {
-        double x;
-        drwav_uint32 a = ((drwav_uint32)(pIn[i*3+0]) <<  8);
-        drwav_uint32 b = ((drwav_uint32)(pIn[i*3+1]) << 16);
-        drwav_uint32 c = ((drwav_uint32)(pIn[i*3+2]) << 24);
-
-        x = (double)((drwav_int32)(a | b | c) >> 8);
-        *pOut++ = (float)(x * 0.00000011920928955078125);
-    }
+    Pcm_s24_to_f32(pOut, pIn, sampleCount);
 }
 
 DRWAV_API void drwav_s32_to_f32(float* pOut, const drwav_int32* pIn, size_t sampleCount)
 {
-    size_t i;
     if (pOut == NULL || pIn == NULL) {
         return;
     }
 
-    for (i = 0; i < sampleCount; ++i) {
-        *pOut++ = (float)(pIn[i] / 2147483648.0);
-    }
+    Pcm_s32_to_f32(pOut, pIn, sampleCount);
 }
 
 DRWAV_API void drwav_f64_to_f32(float* pOut, const double* pIn, size_t sampleCount)
@@ -7263,46 +7425,29 @@ DRWAV_API void drwav_u8_to_s32(drwav_int32* pOut, const drwav_uint8* pIn, size_t
 
 DRWAV_API void drwav_s16_to_s32(drwav_int32* pOut, const drwav_int16* pIn, size_t sampleCount)
 {
-    size_t i;
-
     if (pOut == NULL || pIn == NULL) {
         return;
     }
 
-    for (i = 0; i < sampleCount; ++i) {
-        *pOut++ = pIn[i] << 16;
-    }
+    Pcm_s16_to_s32(pOut, pIn, sampleCount);
 }
 
 DRWAV_API void drwav_s24_to_s32(drwav_int32* pOut, const drwav_uint8* pIn, size_t sampleCount)
 {
-    size_t i;
-
     if (pOut == NULL || pIn == NULL) {
         return;
     }
 
-    for (i = 0; i < sampleCount; ++i) {
-        unsigned int s0 = pIn[i*3 + 0];
-        unsigned int s1 = pIn[i*3 + 1];
-        unsigned int s2 = pIn[i*3 + 2];
-
-        drwav_int32 sample32 = (drwav_int32)((s0 << 8) | (s1 << 16) | (s2 << 24));
-        *pOut++ = sample32;
-    }
+    Pcm_s24_to_s32(pOut, pIn, sampleCount);
 }
 
 DRWAV_API void drwav_f32_to_s32(drwav_int32* pOut, const float* pIn, size_t sampleCount)
 {
-    size_t i;
-
     if (pOut == NULL || pIn == NULL) {
         return;
     }
 
-    for (i = 0; i < sampleCount; ++i) {
-        *pOut++ = (drwav_int32)(2147483648.0 * pIn[i]);
-    }
+    Pcm_f32_to_s32(pOut, pIn, sampleCount);
 }
 
 DRWAV_API void drwav_f64_to_s32(drwav_int32* pOut, const double* pIn, size_t sampleCount)
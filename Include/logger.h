@@ -13,12 +13,155 @@ extern "C" {
 #else
  #define __FILENAME__ (strrchr(__FILE__, '/') ? strrchr(__FILE__, '/') + 1 : __FILE__)
 #endif /* defined(_WIN32) || defined(_WIN64) */
-#define LOG_TRACE(fmt, ...) logger_log(LogLevel_TRACE, __FILENAME__, __LINE__, fmt, ##__VA_ARGS__)
-#define LOG_DEBUG(fmt, ...) logger_log(LogLevel_DEBUG, __FILENAME__, __LINE__, fmt, ##__VA_ARGS__)
-#define LOG_INFO(fmt, ...)  logger_log(LogLevel_INFO , __FILENAME__, __LINE__, fmt, ##__VA_ARGS__)
-#define LOG_WARN(fmt, ...)  logger_log(LogLevel_WARN , __FILENAME__, __LINE__, fmt, ##__VA_ARGS__)
-#define LOG_ERROR(fmt, ...) logger_log(LogLevel_ERROR, __FILENAME__, __LINE__, fmt, ##__VA_ARGS__)
-#define LOG_FATAL(fmt, ...) logger_log(LogLevel_FATAL, __FILENAME__, __LINE__, fmt, ##__VA_ARGS__)
+
+/*
+ * LOGGER_MIN_LEVEL removes the calls below a level at compile time: define it to the
+ * number of a LogLevel (0 TRACE, 1 DEBUG, ... 5 FATAL) and lower LOG_* macros expand
+ * to nothing that runs. Their arguments are still type-checked but never evaluated.
+ */
+#ifndef LOGGER_MIN_LEVEL
+ #define LOGGER_MIN_LEVEL 0
+#endif /* LOGGER_MIN_LEVEL */
+
+/*
+ * The module the LOG_* macros of a file belong to, for logger_setModuleLevel().
+ * Defaults to the file name; define it before including this header to group files,
+ * e.g. #define LOGGER_MODULE "resampler".
+ */
+#ifndef LOGGER_MODULE
+ #define LOGGER_MODULE __FILENAME__
+#endif /* LOGGER_MODULE */
+
+#if defined(__GNUC__) || defined(__clang__)
+ #define LOGGER_LOAD_LEVEL_(ref) __atomic_load_n((ref), __ATOMIC_RELAXED)
+ #define LOGGER_LOAD_REF_(site) __atomic_load_n((site), __ATOMIC_ACQUIRE)
+ #define LOGGER_STORE_REF_(site, ref) __atomic_store_n((site), (ref), __ATOMIC_RELEASE)
+#else
+ #define LOGGER_LOAD_LEVEL_(ref) (*(const volatile int*) (ref))
+ #define LOGGER_LOAD_REF_(site) (*(const int* const volatile*) (site))
+ #define LOGGER_STORE_REF_(site, ref) (*(const int* volatile*) (site) = (ref))
+#endif /* defined(__GNUC__) || defined(__clang__) */
+
+/*
+ * Each call site caches a pointer to the level of its module on its first run, so
+ * a disabled message costs one load and a compare, with no call and no evaluation
+ * of the arguments.
+ */
+#define LOGGER_LOG_(level, fmt, ...) do { \
+        static const int* loggerSiteLevel_ = NULL; \
+        const int* loggerLevel_ = LOGGER_LOAD_REF_(&loggerSiteLevel_); \
+        if (loggerLevel_ == NULL) { \
+            loggerLevel_ = logger_getModuleLevelRef(LOGGER_MODULE); \
+            LOGGER_STORE_REF_(&loggerSiteLevel_, loggerLevel_); \
+        } \
+        if ((int) (level) >= LOGGER_LOAD_LEVEL_(loggerLevel_)) { \
+            logger_logStatic(level, __FILENAME__, __LINE__, "" fmt, ##__VA_ARGS__); \
+        } \
+    } while (0)
+
+/*
+ * Rate-limited variant: the call site keeps a LogRateState, and logger_rateLimit()
+ * decides whether this message goes out. When it does after others were held back,
+ * a line with their count goes out first.
+ */
+#define LOGGER_LOG_RATE_(level, kind, param, fmt, ...) do { \
+        static LogRateState loggerRate_; \
+        static const int* loggerSiteLevel_ = NULL; \
+        const int* loggerLevel_ = LOGGER_LOAD_REF_(&loggerSiteLevel_); \
+        long long loggerSuppressed_; \
+        if (loggerLevel_ == NULL) { \
+            loggerLevel_ = logger_getModuleLevelRef(LOGGER_MODULE); \
+            LOGGER_STORE_REF_(&loggerSiteLevel_, loggerLevel_); \
+        } \
+        if ((int) (level) >= LOGGER_LOAD_LEVEL_(loggerLevel_)) { \
+            loggerSuppressed_ = logger_rateLimit(&loggerRate_, kind, param); \
+            if (loggerSuppressed_ > 0) { \
+                logger_logStatic(level, __FILENAME__, __LINE__, "(%lld similar messages suppressed)", loggerSuppressed_); \
+            } \
+            if (loggerSuppressed_ >= 0) { \
+                logger_logStatic(level, __FILENAME__, __LINE__, "" fmt, ##__VA_ARGS__); \
+            } \
+        } \
+    } while (0)
+
+#define LOGGER_DISCARD_(level, fmt, ...) do { \
+        if (0) { \
+            logger_logStatic(level, __FILENAME__, __LINE__, "" fmt, ##__VA_ARGS__); \
+        } \
+    } while (0)
+
+/*
+ * Rate-limited logging for per-frame code, with state per call site:
+ * LOG_*_EVERY_N(n, ...) logs the 1st, (n+1)th, (2n+1)th... call, LOG_*_EVERY_MS(ms, ...)
+ * at most one call per ms milliseconds, and LOG_*_FIRST_N(n, ...) the first n calls
+ * only. Calls made while the level is disabled don't count.
+ */
+#if LOGGER_MIN_LEVEL <= 0
+ #define LOG_TRACE(fmt, ...) LOGGER_LOG_(LogLevel_TRACE, fmt, ##__VA_ARGS__)
+ #define LOG_TRACE_EVERY_N(n, fmt, ...) LOGGER_LOG_RATE_(LogLevel_TRACE, LogRate_EVERY_N, n, fmt, ##__VA_ARGS__)
+ #define LOG_TRACE_EVERY_MS(ms, fmt, ...) LOGGER_LOG_RATE_(LogLevel_TRACE, LogRate_EVERY_MS, ms, fmt, ##__VA_ARGS__)
+ #define LOG_TRACE_FIRST_N(n, fmt, ...) LOGGER_LOG_RATE_(LogLevel_TRACE, LogRate_FIRST_N, n, fmt, ##__VA_ARGS__)
+#else
+ #define LOG_TRACE(fmt, ...) LOGGER_DISCARD_(LogLevel_TRACE, fmt, ##__VA_ARGS__)
+ #define LOG_TRACE_EVERY_N(n, fmt, ...) LOGGER_DISCARD_(LogLevel_TRACE, fmt, ##__VA_ARGS__)
+ #define LOG_TRACE_EVERY_MS(ms, fmt, ...) LOGGER_DISCARD_(LogLevel_TRACE, fmt, ##__VA_ARGS__)
+ #define LOG_TRACE_FIRST_N(n, fmt, ...) LOGGER_DISCARD_(LogLevel_TRACE, fmt, ##__VA_ARGS__)
+#endif
+#if LOGGER_MIN_LEVEL <= 1
+ #define LOG_DEBUG(fmt, ...) LOGGER_LOG_(LogLevel_DEBUG, fmt, ##__VA_ARGS__)
+ #define LOG_DEBUG_EVERY_N(n, fmt, ...) LOGGER_LOG_RATE_(LogLevel_DEBUG, LogRate_EVERY_N, n, fmt, ##__VA_ARGS__)
+ #define LOG_DEBUG_EVERY_MS(ms, fmt, ...) LOGGER_LOG_RATE_(LogLevel_DEBUG, LogRate_EVERY_MS, ms, fmt, ##__VA_ARGS__)
+ #define LOG_DEBUG_FIRST_N(n, fmt, ...) LOGGER_LOG_RATE_(LogLevel_DEBUG, LogRate_FIRST_N, n, fmt, ##__VA_ARGS__)
+#else
+ #define LOG_DEBUG(fmt, ...) LOGGER_DISCARD_(LogLevel_DEBUG, fmt, ##__VA_ARGS__)
+ #define LOG_DEBUG_EVERY_N(n, fmt, ...) LOGGER_DISCARD_(LogLevel_DEBUG, fmt, ##__VA_ARGS__)
+ #define LOG_DEBUG_EVERY_MS(ms, fmt, ...) LOGGER_DISCARD_(LogLevel_DEBUG, fmt, ##__VA_ARGS__)
+ #define LOG_DEBUG_FIRST_N(n, fmt, ...) LOGGER_DISCARD_(LogLevel_DEBUG, fmt, ##__VA_ARGS__)
+#endif
+#if LOGGER_MIN_LEVEL <= 2
+ #define LOG_INFO(fmt, ...)  LOGGER_LOG_(LogLevel_INFO , fmt, ##__VA_ARGS__)
+ #define LOG_INFO_EVERY_N(n, fmt, ...) LOGGER_LOG_RATE_(LogLevel_INFO , LogRate_EVERY_N, n, fmt, ##__VA_ARGS__)
+ #define LOG_INFO_EVERY_MS(ms, fmt, ...) LOGGER_LOG_RATE_(LogLevel_INFO , LogRate_EVERY_MS, ms, fmt, ##__VA_ARGS__)
+ #define LOG_INFO_FIRST_N(n, fmt, ...) LOGGER_LOG_RATE_(LogLevel_INFO , LogRate_FIRST_N, n, fmt, ##__VA_ARGS__)
+#else
+ #define LOG_INFO(fmt, ...)  LOGGER_DISCARD_(LogLevel_INFO , fmt, ##__VA_ARGS__)
+ #define LOG_INFO_EVERY_N(n, fmt, ...) LOGGER_DISCARD_(LogLevel_INFO , fmt, ##__VA_ARGS__)
+ #define LOG_INFO_EVERY_MS(ms, fmt, ...) LOGGER_DISCARD_(LogLevel_INFO , fmt, ##__VA_ARGS__)
+ #define LOG_INFO_FIRST_N(n, fmt, ...) LOGGER_DISCARD_(LogLevel_INFO , fmt, ##__VA_ARGS__)
+#endif
+#if LOGGER_MIN_LEVEL <= 3
+ #define LOG_WARN(fmt, ...)  LOGGER_LOG_(LogLevel_WARN , fmt, ##__VA_ARGS__)
+ #define LOG_WARN_EVERY_N(n, fmt, ...) LOGGER_LOG_RATE_(LogLevel_WARN , LogRate_EVERY_N, n, fmt, ##__VA_ARGS__)
+ #define LOG_WARN_EVERY_MS(ms, fmt, ...) LOGGER_LOG_RATE_(LogLevel_WARN , LogRate_EVERY_MS, ms, fmt, ##__VA_ARGS__)
+ #define LOG_WARN_FIRST_N(n, fmt, ...) LOGGER_LOG_RATE_(LogLevel_WARN , LogRate_FIRST_N, n, fmt, ##__VA_ARGS__)
+#else
+ #define LOG_WARN(fmt, ...)  LOGGER_DISCARD_(LogLevel_WARN , fmt, ##__VA_ARGS__)
+ #define LOG_WARN_EVERY_N(n, fmt, ...) LOGGER_DISCARD_(LogLevel_WARN , fmt, ##__VA_ARGS__)
+ #define LOG_WARN_EVERY_MS(ms, fmt, ...) LOGGER_DISCARD_(LogLevel_WARN , fmt, ##__VA_ARGS__)
+ #define LOG_WARN_FIRST_N(n, fmt, ...) LOGGER_DISCARD_(LogLevel_WARN , fmt, ##__VA_ARGS__)
+#endif
+#if LOGGER_MIN_LEVEL <= 4
+ #define LOG_ERROR(fmt, ...) LOGGER_LOG_(LogLevel_ERROR, fmt, ##__VA_ARGS__)
+ #define LOG_ERROR_EVERY_N(n, fmt, ...) LOGGER_LOG_RATE_(LogLevel_ERROR, LogRate_EVERY_N, n, fmt, ##__VA_ARGS__)
+ #define LOG_ERROR_EVERY_MS(ms, fmt, ...) LOGGER_LOG_RATE_(LogLevel_ERROR, LogRate_EVERY_MS, ms, fmt, ##__VA_ARGS__)
+ #define LOG_ERROR_FIRST_N(n, fmt, ...) LOGGER_LOG_RATE_(LogLevel_ERROR, LogRate_FIRST_N, n, fmt, ##__VA_ARGS__)
+#else
+ #define LOG_ERROR(fmt, ...) LOGGER_DISCARD_(LogLevel_ERROR, fmt, ##__VA_ARGS__)
+ #define LOG_ERROR_EVERY_N(n, fmt, ...) LOGGER_DISCARD_(LogLevel_ERROR, fmt, ##__VA_ARGS__)
+ #define LOG_ERROR_EVERY_MS(ms, fmt, ...) LOGGER_DISCARD_(LogLevel_ERROR, fmt, ##__VA_ARGS__)
+ #define LOG_ERROR_FIRST_N(n, fmt, ...) LOGGER_DISCARD_(LogLevel_ERROR, fmt, ##__VA_ARGS__)
+#endif
+#if LOGGER_MIN_LEVEL <= 5
+ #define LOG_FATAL(fmt, ...) LOGGER_LOG_(LogLevel_FATAL, fmt, ##__VA_ARGS__)
+ #define LOG_FATAL_EVERY_N(n, fmt, ...) LOGGER_LOG_RATE_(LogLevel_FATAL, LogRate_EVERY_N, n, fmt, ##__VA_ARGS__)
+ #define LOG_FATAL_EVERY_MS(ms, fmt, ...) LOGGER_LOG_RATE_(LogLevel_FATAL, LogRate_EVERY_MS, ms, fmt, ##__VA_ARGS__)
+ #define LOG_FATAL_FIRST_N(n, fmt, ...) LOGGER_LOG_RATE_(LogLevel_FATAL, LogRate_FIRST_N, n, fmt, ##__VA_ARGS__)
+#else
+ #define LOG_FATAL(fmt, ...) LOGGER_DISCARD_(LogLevel_FATAL, fmt, ##__VA_ARGS__)
+ #define LOG_FATAL_EVERY_N(n, fmt, ...) LOGGER_DISCARD_(LogLevel_FATAL, fmt, ##__VA_ARGS__)
+ #define LOG_FATAL_EVERY_MS(ms, fmt, ...) LOGGER_DISCARD_(LogLevel_FATAL, fmt, ##__VA_ARGS__)
+ #define LOG_FATAL_FIRST_N(n, fmt, ...) LOGGER_DISCARD_(LogLevel_FATAL, fmt, ##__VA_ARGS__)
+#endif
 
 typedef enum {
     LogLevel_TRACE,
@@ -29,6 +172,24 @@ typedef enum {
     LogLevel_FATAL,
 } LogLevel;
 
+typedef enum {
+    LogRate_EVERY_N,
+    LogRate_EVERY_MS,
+    LogRate_FIRST_N,
+} LogRateKind;
+
+/* State of a rate-limited call site; zero-initialized, as a static is */
+typedef struct {
+    long long count; /* calls seen */
+    long long next; /* EVERY_MS: msec on the logger's clock when the window reopens */
+    long long suppressed; /* EVERY_MS: calls held back since the last one logged */
+} LogRateState;
+
+typedef enum {
+    LogOverflow_DROP,  /* discard the message and count it */
+    LogOverflow_BLOCK, /* wait for the writer thread to make room */
+} LogOverflowPolicy;
+
 /**
  * Initialize the logger as a console logger.
  * If the file pointer is NULL, stdout will be used.
@@ -41,6 +202,9 @@ int logger_initConsoleLogger(FILE* output);
 /**
  * Initialize the logger as a file logger.
  * If the filename is NULL, return without doing anything.
+ * When the file reaches maxFileSize it is rotated: it becomes <filename>.1, older
+ * backups move up by one, and the oldest beyond maxBackupFiles is deleted (with
+ * no backups, the full file is). This is done on a background thread.
  *
  * @param[in] filename The name of the output file
  * @param[in] maxFileSize The maximum number of bytes to write to any one file
@@ -49,6 +213,35 @@ int logger_initConsoleLogger(FILE* output);
  */
 int logger_initFileLogger(const char* filename, long maxFileSize, unsigned char maxBackupFiles);
 
+/**
+ * Compresses a full log file; runs on the rotator thread.
+ *
+ * @param[in] src The file to compress
+ * @param[in] dst Where to write the compressed file
+ * @param[in] user As passed to logger_setRotationCompressor()
+ * @return Non-zero value upon success or 0 on error (the backup is then kept uncompressed)
+ */
+typedef int (*LogCompressor)(const char* src, const char* dst, void* user);
+
+/**
+ * Compress backups of the file logger when they are rotated out.
+ * Rotation itself never blocks logging: a full file is renamed and replaced at
+ * once, and a background thread shifts the backups, so compression (gzip, zstd or
+ * whatever the compressor does) costs the logging threads nothing. Backups are
+ * then named <filename>.<index><extension>; maxBackupFiles still bounds their number.
+ * Off by default.
+ *
+ * @param[in] compress The compressor, or NULL to switch compression off
+ * @param[in] extension Appended to the names of compressed backups, e.g. ".gz" (up to 15 characters)
+ * @param[in] user Passed to the compressor
+ */
+void logger_setRotationCompressor(LogCompressor compress, const char* extension, void* user);
+
+/**
+ * Wait until the backups of every rotation so far are in place.
+ */
+void logger_waitRotation(void);
+
 /**
  * Set the log level.
  * Message levels lower than this value will be discarded.
@@ -66,6 +259,45 @@ void logger_setLevel(LogLevel level);
  */
 LogLevel logger_getLevel(void);
 
+/**
+ * Set the log level of one module, overriding the global level for the LOG_* macros
+ * of its files (see LOGGER_MODULE). Takes effect at every call site immediately.
+ *
+ * @param[in] module A module name, the file name by default
+ * @param[in] level A log level
+ * @return Non-zero value upon success or 0 if too many modules have been set
+ */
+int logger_setModuleLevel(const char* module, LogLevel level);
+
+/**
+ * Make a module follow the global log level again.
+ *
+ * @param[in] module A module name
+ */
+void logger_resetModuleLevel(const char* module);
+
+/**
+ * Get the level in effect for a module, for the LOG_* macros.
+ * The returned pointer stays valid and follows logger_setLevel() and
+ * logger_setModuleLevel(); read it atomically.
+ *
+ * @param[in] module A module name
+ * @return A pointer to the module's level
+ */
+const int* logger_getModuleLevelRef(const char* module);
+
+/**
+ * Decide whether a rate-limited call site logs this time; used by the
+ * LOG_*_EVERY_N, LOG_*_EVERY_MS and LOG_*_FIRST_N macros. Thread-safe.
+ *
+ * @param[in,out] state The call site's state
+ * @param[in] kind How the call site is limited
+ * @param[in] param The N or the interval in milliseconds
+ * @return -1 to skip the message, otherwise the number of calls suppressed since the last one logged
+ *         (always 0 for EVERY_N and FIRST_N, whose gaps are known)
+ */
+long long logger_rateLimit(LogRateState* state, LogRateKind kind, long long param);
+
 /**
  * Check if a message of the level would actually be logged.
  *
@@ -86,6 +318,69 @@ void logger_autoFlush(long interval);
  */
 void logger_flush(void);
 
+/**
+ * Switch to asynchronous logging.
+ * From now on logger_log() only formats the message and copies it, with its
+ * timestamp, into a lock-free ring owned by the calling thread. A background thread
+ * writes the rings to the outputs, oldest message first, and does the rotation, so
+ * logging takes no lock and does no I/O on the caller's thread.
+ * A message that finds its ring full is handled according to the overflow policy;
+ * dropped messages are counted and reported in the log by the writer thread.
+ * Call after one of the initialize functions. logger_flush() waits for the writer.
+ *
+ * @param[in] ringSize Bytes per thread ring, rounded up to a power of two (0 for 64 KB)
+ * @param[in] policy What to do when a ring is full
+ * @return Non-zero value upon success or 0 on error
+ */
+int logger_startAsync(size_t ringSize, LogOverflowPolicy policy);
+
+/**
+ * Defer formatting to the writer thread in async mode.
+ * Messages logged through the LOG_* macros then only capture the raw arguments:
+ * numbers as they are and strings copied (up to 255 bytes each). The format string,
+ * which the macros require to be a literal, is parsed once per call site and kept by
+ * pointer. Formats using %n, %ls or %lc are still formatted at the call.
+ * Off by default.
+ *
+ * @param[in] enable Non-zero to defer formatting
+ */
+void logger_setDeferredFormatting(int enable);
+
+/**
+ * Initialize a binary file logger, written by the async writer thread.
+ * Deferred messages are stored as their format string (written once) and raw
+ * arguments, which makes the file much smaller and cheaper to write than text.
+ * Only messages logged in async mode reach it. Decode with logger_decodeBinaryFile()
+ * (or the LogDecode tool) on a machine of the same byte order.
+ *
+ * @param[in] filename The name of the output file
+ * @return Non-zero value upon success or 0 on error
+ */
+int logger_initBinaryFileLogger(const char* filename);
+
+/**
+ * Decode a binary log file into the same text lines as the file logger writes.
+ *
+ * @param[in] filename The name of the binary log file
+ * @param[in] output Where to write the text
+ * @return The number of messages decoded, or -1 if the file can't be read
+ */
+long logger_decodeBinaryFile(const char* filename, FILE* output);
+
+/**
+ * Write out every pending message, stop the writer thread and go back to
+ * synchronous logging.
+ * No other thread should be logging while this runs.
+ */
+void logger_stopAsync(void);
+
+/**
+ * Get the number of messages dropped by full rings since the program started.
+ *
+ * @return The number of dropped messages
+ */
+unsigned long long logger_getDroppedCount(void);
+
 /**
  * Log a message.
  * Make sure to call one of the following initialize functions before starting logging.
@@ -100,6 +395,14 @@ void logger_flush(void);
  */
 void logger_log(LogLevel level, const char* file, int line, const char* fmt, ...);
 
+/**
+ * Log a message whose format string has static storage duration, as a string
+ * literal does; used by the LOG_* macros, which check the module level first. Takes
+ * the same arguments as logger_log() but does not check the level, and lets the async
+ * logger defer the formatting (see logger_setDeferredFormatting()).
+ */
+void logger_logStatic(LogLevel level, const char* file, int line, const char* fmt, ...);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif /* __cplusplus */
@@ -0,0 +1,56 @@
+#ifndef __PCM_CONVERT_H__
+#define __PCM_CONVERT_H__
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+#include <stddef.h>
+
+/*
+ * PCM sample format conversions, dispatched at run time to SSE2 or AVX2 kernels
+ * where the CPU supports them. dr_wav's read helpers route their conversions here.
+ *
+ * Integer to float scales by 2^-(bits - 1), which is exact. Float to integer scales
+ * by 2^(bits - 1), rounds to nearest even and saturates, so -1.0 maps to the most
+ * negative value and anything at or above 1.0 to the most positive one.
+ */
+typedef enum _TPcmIsa
+{
+    kPcmIsaC = 0,
+    kPcmIsaSSE2,
+    kPcmIsaAVX2
+}TPcmIsa;
+
+/*
+ * TPDF dither for float to 16-bit conversion: the sum of two uniform random values,
+ * +/- 1 LSB peak, from eight xorshift generators used in turn, so every instruction
+ * set produces the same output from the same state.
+ */
+typedef struct _TPcmDither
+{
+    unsigned int state[8];
+}TPcmDither;
+
+void Pcm_init_dither(TPcmDither* dither, const unsigned int seed);
+
+void Pcm_s16_to_f32(float* data_out, const short* data_in, const size_t count);
+void Pcm_s24_to_f32(float* data_out, const unsigned char* data_in, const size_t count); // packed little-endian, 3 bytes per sample
+void Pcm_s32_to_f32(float* data_out, const int* data_in, const size_t count);
+void Pcm_f32_to_s16(short* data_out, const float* data_in, const size_t count);
+void Pcm_f32_to_s16_dither(short* data_out, const float* data_in, const size_t count, TPcmDither* dither);
+void Pcm_f32_to_s32(int* data_out, const float* data_in, const size_t count);
+void Pcm_s16_to_s32(int* data_out, const short* data_in, const size_t count); // x << 16
+void Pcm_s24_to_s32(int* data_out, const unsigned char* data_in, const size_t count); // x << 8
+void Pcm_s24_to_s16(short* data_out, const unsigned char* data_in, const size_t count); // truncates, as dr_wav
+void Pcm_s32_to_s16(short* data_out, const int* data_in, const size_t count); // x >> 16
+
+TPcmIsa Pcm_get_isa(void);
+/*
+ * Restricts the kernels to at most the given instruction set and returns the one
+ * selected, which may be narrower if the CPU or the build lacks it. Meant for tests
+ * and benchmarks; must not be called while another thread is converting.
+ */
+TPcmIsa Pcm_set_isa(TPcmIsa isa);
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,175 @@
+/*
+ * Kernel table of the PCM conversions (pcm_convert.h), filled in by pcm_convert.cpp
+ * (C), pcm_convert_sse2.cpp and pcm_convert_avx2.cpp. Each vector translation unit is
+ * built with its own instruction set flags and returns NULL from its getter when the
+ * flags were not available.
+ *
+ * The vector kernels convert whole blocks of eight samples and leave the rest to the
+ * scalar helpers below, which define the exact results the vector code must match.
+ */
+#ifndef __PCM_CONVERT_SIMD_H__
+#define __PCM_CONVERT_SIMD_H__
+
+#include <stddef.h>
+#include <math.h>
+#include "pcm_convert.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PCM_CONVERT_X86 1
+#endif
+
+typedef struct
+{
+    TPcmIsa isa;
+    void (*s16_to_f32) (float* data_out, const short* data_in, size_t count);
+    void (*s24_to_f32) (float* data_out, const unsigned char* data_in, size_t count);
+    void (*s32_to_f32) (float* data_out, const int* data_in, size_t count);
+    void (*f32_to_s16) (short* data_out, const float* data_in, size_t count);
+    void (*f32_to_s16_dither) (short* data_out, const float* data_in, size_t count, TPcmDither* dither);
+    void (*f32_to_s32) (int* data_out, const float* data_in, size_t count);
+    void (*s16_to_s32) (int* data_out, const short* data_in, size_t count);
+    void (*s24_to_s32) (int* data_out, const unsigned char* data_in, size_t count);
+    void (*s24_to_s16) (short* data_out, const unsigned char* data_in, size_t count);
+    void (*s32_to_s16) (short* data_out, const int* data_in, size_t count);
+} TPcmKernels;
+
+const TPcmKernels* Pcm_kernels_c(void);
+const TPcmKernels* Pcm_kernels_sse2(void);
+const TPcmKernels* Pcm_kernels_avx2(void);
+
+namespace
+{
+
+inline int pcm_s24_at(const unsigned char* p)
+{
+    return (int)(((unsigned int)p[0] << 8) | ((unsigned int)p[1] << 16) | ((unsigned int)p[2] << 24)) >> 8;
+}
+
+// Round to nearest even of a value already clamped to the int range, as cvtps2dq does
+inline int pcm_round(const float x)
+{
+    return (int)nearbyintf(x);
+}
+
+inline short pcm_f32_to_s16_1(const float x, const float dither)
+{
+    float v = x * 32768.0f + dither;
+    // Clamped as maxps/minps do, so that NaN becomes the lower bound
+    v = (v > -32768.0f) ? v : -32768.0f;
+    v = (v < 32767.0f) ? v : 32767.0f;
+    return (short)pcm_round(v);
+}
+
+inline int pcm_f32_to_s32_1(const float x)
+{
+    float v = x * 2147483648.0f;
+    // 2^31 does not fit an int, so it and anything above saturate here rather than in the clamp
+    if (v >= 2147483648.0f) {
+        return 2147483647;
+    }
+    v = (v > -2147483648.0f) ? v : -2147483648.0f;
+    return pcm_round(v);
+}
+
+inline unsigned int pcm_xorshift(unsigned int x)
+{
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+// Two draws of a generator, as a triangular value in (-1, 1)
+inline float pcm_tpdf(unsigned int* state)
+{
+    const unsigned int a = pcm_xorshift(*state);
+    const unsigned int b = pcm_xorshift(a);
+    *state = b;
+    return (float)(int)(a >> 8) * (1.0f / 16777216.0f) - (float)(int)(b >> 8) * (1.0f / 16777216.0f);
+}
+
+inline void pcm_s16_to_f32_c(float* data_out, const short* data_in, size_t count)
+{
+    for (size_t idx = 0; idx < count; idx++)
+    {
+        data_out[idx] = data_in[idx] * (1.0f / 32768.0f);
+    }
+}
+
+inline void pcm_s24_to_f32_c(float* data_out, const unsigned char* data_in, size_t count)
+{
+    for (size_t idx = 0; idx < count; idx++)
+    {
+        data_out[idx] = (float)pcm_s24_at(data_in + 3 * idx) * (1.0f / 8388608.0f);
+    }
+}
+
+inline void pcm_s32_to_f32_c(float* data_out, const int* data_in, size_t count)
+{
+    for (size_t idx = 0; idx < count; idx++)
+    {
+        data_out[idx] = (float)data_in[idx] * (1.0f / 2147483648.0f);
+    }
+}
+
+inline void pcm_f32_to_s16_c(short* data_out, const float* data_in, size_t count)
+{
+    for (size_t idx = 0; idx < count; idx++)
+    {
+        data_out[idx] = pcm_f32_to_s16_1(data_in[idx], 0.0f);
+    }
+}
+
+// Sample idx takes generator idx % 8, which holds for the blocks of eight of the vector code
+inline void pcm_f32_to_s16_dither_c(short* data_out, const float* data_in, size_t count, TPcmDither* dither)
+{
+    for (size_t idx = 0; idx < count; idx++)
+    {
+        data_out[idx] = pcm_f32_to_s16_1(data_in[idx], pcm_tpdf(&dither->state[idx & 7]));
+    }
+}
+
+inline void pcm_f32_to_s32_c(int* data_out, const float* data_in, size_t count)
+{
+    for (size_t idx = 0; idx < count; idx++)
+    {
+        data_out[idx] = pcm_f32_to_s32_1(data_in[idx]);
+    }
+}
+
+inline void pcm_s16_to_s32_c(int* data_out, const short* data_in, size_t count)
+{
+    for (size_t idx = 0; idx < count; idx++)
+    {
+        data_out[idx] = (int)((unsigned int)(int)data_in[idx] << 16);
+    }
+}
+
+inline void pcm_s24_to_s32_c(int* data_out, const unsigned char* data_in, size_t count)
+{
+    for (size_t idx = 0; idx < count; idx++)
+    {
+        const unsigned char* p = data_in + 3 * idx;
+        data_out[idx] = (int)(((unsigned int)p[0] << 8) | ((unsigned int)p[1] << 16) | ((unsigned int)p[2] << 24));
+    }
+}
+
+inline void pcm_s24_to_s16_c(short* data_out, const unsigned char* data_in, size_t count)
+{
+    for (size_t idx = 0; idx < count; idx++)
+    {
+        data_out[idx] = (short)(pcm_s24_at(data_in + 3 * idx) >> 8);
+    }
+}
+
+inline void pcm_s32_to_s16_c(short* data_out, const int* data_in, size_t count)
+{
+    for (size_t idx = 0; idx < count; idx++)
+    {
+        data_out[idx] = (short)(data_in[idx] >> 16);
+    }
+}
+
+} // namespace
+
+#endif
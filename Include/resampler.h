@@ -0,0 +1,47 @@
+#ifndef __RESAMPLER_H__
+#define __RESAMPLER_H__
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+#include "./do_fft.h"
+typedef enum _TResampleQuality
+{
+    kResampleLow = 0, // 16 taps, ~60 dB stopband, 85% of the passband
+    kResampleMedium, // 32 taps, ~85 dB stopband, 90% of the passband
+    kResampleHigh // 64 taps, ~100 dB stopband, 94.5% of the passband
+}TResampleQuality;
+
+/*
+ * Streaming polyphase resampler of one channel. The filter is a Kaiser-windowed sinc
+ * tabulated as a bank of phases; the tap counts above are per output sample when
+ * upsampling and grow by in_rate / out_rate when downsampling, so that the cutoff
+ * tracks the lower of the two Nyquist rates.
+ *
+ * Create_resampler takes integer rates: out_rate / in_rate is reduced to L / M and,
+ * if L is small enough to tabulate every phase, the phase is stepped exactly in
+ * integers. Create_resampler_ratio takes any out / in ratio, and so do integer rates
+ * with a large L (e.g. 44100 -> 44101): the position is then kept in 32.32 fixed
+ * point and the taps are linearly interpolated between adjacent phases.
+ *
+ * Output sample k is the input interpolated at position k * in_rate / out_rate, and
+ * is written once Get_resampler_delay input samples past that position have been
+ * pushed. All buffers are allocated on creation.
+ */
+typedef struct _TResampler TResampler;
+
+TResampler* Create_resampler(const int in_rate, const int out_rate, TResampleQuality quality); // NULL if invalid or out of memory
+TResampler* Create_resampler_ratio(const double ratio, TResampleQuality quality); // ratio = out / in, in [1/256, 256]
+void Destroy_resampler(TResampler* rs);
+void Reset_resampler(TResampler* rs);
+int Get_resampler_delay(const TResampler* rs); // look-ahead, in input samples
+int Get_resampler_max_output(const TResampler* rs, const int in_count); // bound on *out_count for in_count inputs
+
+/*
+ * Consumes in_count samples of data_in and writes the *out_count output samples they
+ * complete to data_out, which must hold Get_resampler_max_output(in_count) samples.
+ */
+TFFTResult Do_resample(TResampler* rs, float* data_out, int* out_count, const float* data_in, const int in_count);
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,89 @@
+#ifndef __STFT_H__
+#define __STFT_H__
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+#include "./do_fft.h"
+#include "./thread_pool.h"
+typedef enum _TSTFTWindow
+{
+    kWindowHann = 0, // periodic Hann on analysis, none on synthesis
+    kWindowSqrtHann, // periodic sqrt-Hann on both analysis and synthesis
+    kWindowHamming, // periodic Hamming on analysis, none on synthesis
+    kWindowCustom // analysis_window and synthesis_window of TSTFTConfig
+}TSTFTWindow;
+
+typedef struct _TSTFTConfig
+{
+    int frame_len; // fft_len, see Is_fft_length_supported
+    int hop; // 1..frame_len new samples per frame
+    TSTFTWindow window;
+    const float* analysis_window; // kWindowCustom: frame_len taps
+    const float* synthesis_window; // kWindowCustom: frame_len taps, or NULL for none
+    TFFTFormat format; // of the spectra handed to the callback
+}TSTFTConfig;
+
+/*
+ * Called once per hop with the spectrum of the latest windowed frame, in the format
+ * of the configuration and Get_fft_spectrum_length floats long. It may modify the
+ * spectrum in place; the result is what gets resynthesised.
+ */
+typedef void (*TSTFTCallback)(void* user, float* spectrum, const int spectrum_len);
+
+/*
+ * Streaming STFT analysis and weighted overlap-add synthesis of one channel. Input
+ * goes into a ring of the last frame_len samples; every hop samples a frame is
+ * windowed, transformed, handed to the callback, transformed back, windowed again
+ * and added into the output ring, whose oldest hop samples are then complete.
+ * All buffers and the FFT plan are allocated by Create_stft; processing never
+ * allocates. An STFT must not be used by two threads at once.
+ */
+typedef struct _TSTFT TSTFT;
+
+/*
+ * Validates a configuration. kFFTErrInvalidArgument if hop or format is out of range
+ * or the windows do not satisfy the constant overlap-add condition
+ * sum_m wa[n + m * hop] * ws[n + m * hop] = c != 0 for all n (to within 1e-3 of c), so that an untouched spectrum is reconstructed
+ * exactly once the output is divided by c, which Create_stft folds into the
+ * synthesis window. The built-in windows satisfy it for hop = frame_len / R with an
+ * integer R >= 2.
+ */
+TFFTResult Check_stft_config(const TSTFTConfig* config);
+TSTFT* Create_stft(const TSTFTConfig* config); // NULL if Check_stft_config fails or out of memory
+void Destroy_stft(TSTFT* stft);
+void Reset_stft(TSTFT* stft); // clears the input and output history
+int Get_stft_latency(const TSTFT* stft); // in samples, frame_len
+int Get_stft_spectrum_length(const TSTFT* stft);
+
+/*
+ * Pushes count (any number of) samples of data_in and writes as many samples of
+ * output, delayed by Get_stft_latency, to data_out. data_out may equal data_in.
+ * process may be NULL, in which case the output is the delayed input.
+ */
+TFFTResult Do_stft_process(TSTFT* stft, float* data_out, const float* data_in, const int count, TSTFTCallback process, void* user);
+
+/*
+ * Multi-channel STFT: one TSTFT per channel, sharing a configuration. Each call fans
+ * the channels out over a thread pool and joins them before returning, so the
+ * callback runs concurrently for different channels (never for the same one). The
+ * pool is not owned and may be shared with other work run from the same thread; a
+ * NULL pool processes the channels in order on the calling thread, with the same
+ * results.
+ */
+typedef void (*TMultiSTFTCallback)(void* user, const int channel, float* spectrum, const int spectrum_len);
+
+typedef struct _TMultiSTFT TMultiSTFT;
+
+TMultiSTFT* Create_multi_stft(const TSTFTConfig* config, const int channels, TThreadPool* pool); // NULL as Create_stft
+void Destroy_multi_stft(TMultiSTFT* stft);
+void Reset_multi_stft(TMultiSTFT* stft);
+
+/*
+ * Do_stft_process on every channel, count samples each: channel c at
+ * data[c * count + t] (kPlanar) or data[t * channels + c] (kInterleaved).
+ */
+TFFTResult Do_multi_stft_process(TMultiSTFT* stft, float* data_out, const float* data_in, const int count, TFFTLayout layout, TMultiSTFTCallback process, void* user);
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,40 @@
+#ifndef __THREAD_POOL_H__
+#define __THREAD_POOL_H__
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * Fixed pool of persistent worker threads for fanning short, independent tasks (one
+ * per channel frame, say) out and joining them again. Workers are started once by
+ * Create_thread_pool and optionally pinned to one CPU each. A run is handed over
+ * through a single atomic word from which the threads claim task indices, with no
+ * lock; workers spin for a while after each run and only park on a condition
+ * variable once idle, so back-to-back runs do not pay for a wake-up.
+ */
+typedef struct _TThreadPool TThreadPool;
+
+typedef void (*TThreadPoolTask)(void* user, const int index);
+
+/*
+ * threads counts the calling thread, which takes part in every run, so threads - 1
+ * workers are started; 0 uses one thread per logical CPU, and 1 starts none.
+ * With pin_threads, worker k (1..threads - 1) is bound to CPU k, leaving CPU 0 to the
+ * caller (where the platform supports it).
+ * NULL if out of memory.
+ */
+TThreadPool* Create_thread_pool(const int threads, const int pin_threads);
+void Destroy_thread_pool(TThreadPool* pool);
+int Get_thread_pool_size(const TThreadPool* pool); // threads, 1 for a NULL pool
+
+/*
+ * Calls task(user, index) once for every index in [0, count) and returns when all
+ * have finished. With a NULL pool, or one thread, the calls are made in order by the
+ * calling thread. Tasks must not run the same pool themselves, and only one thread
+ * may run a pool at a time.
+ */
+void Run_thread_pool(TThreadPool* pool, TThreadPoolTask task, void* user, const int count);
+#ifdef __cplusplus
+}
+#endif
+#endif
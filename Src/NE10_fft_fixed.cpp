@@ -0,0 +1,534 @@
+/*
+ * NE10 Library : dsp/NE10_fft_fixed.cpp
+ *
+ * Fixed-point real-to-complex and complex-to-real FFT of power-of-two lengths, on 16-bit
+ * samples with Q15 twiddles or 32-bit samples with Q31 twiddles, in integer arithmetic
+ * only. The factoring and the stage layout are those of the generic float butterflies
+ * (NE10_fft_generic.h), restricted to radix 2 and 4.
+ *
+ * Instead of scaling every stage by 1/radix, the transforms use block floating point:
+ * before each stage the block is shifted just far enough that the worst-case growth of
+ * that stage cannot overflow (or shifted left if it has headroom to spare), and the sum
+ * of the shifts is returned as the block exponent. Quiet signals thus keep their full
+ * precision, and loud ones never wrap.
+ */
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "../Include/NE10_fft.h"
+#include "../Include/NE10_fft_generic.h"
+
+namespace
+{
+
+template <class S> struct ne10_fft_fixed_traits;
+
+template <> struct ne10_fft_fixed_traits<ne10_int16_t>
+{
+    typedef ne10_fft_cpx_int16_t cpx_t;
+    typedef ne10_fft_r2c_state_int16_t state_t;
+    typedef ne10_int32_t acc_t;     // holds a sample shifted by up to 15 bits either way
+    enum { Q = 15 };
+};
+
+template <> struct ne10_fft_fixed_traits<ne10_int32_t>
+{
+    typedef ne10_fft_cpx_int32_t cpx_t;
+    typedef ne10_fft_r2c_state_int32_t state_t;
+    typedef ne10_int64_t acc_t;
+    enum { Q = 31 };
+};
+
+template <class A>
+struct ne10_fft_acc_cpx
+{
+    A r;
+    A i;
+};
+
+// x * 2^-shift, rounded to nearest even (no bias that the stages would accumulate)
+template <class A>
+static inline A ne10_fixed_shift (A x, ne10_int32_t shift)
+{
+    if (shift > 0)
+    {
+        return (x + ( ( (A) 1 << (shift - 1)) - 1) + ( (x >> shift) & 1)) >> shift;
+    }
+    return x * ( (A) 1 << -shift);
+}
+
+// x * w with w in Q format, rounded to nearest
+template <class S, class A>
+static inline A ne10_fixed_mul (A x, S w)
+{
+    const ne10_int32_t q = ne10_fft_fixed_traits<S>::Q;
+    return (A) ( ( (ne10_int64_t) x * w + ( (ne10_int64_t) 1 << (q - 1))) >> q);
+}
+
+template <class A>
+static inline A ne10_fixed_abs (A x)
+{
+    return (x < 0) ? -x : x;
+}
+
+/*
+ * Picks the shift for a stage whose outputs can grow to 'growth' times the largest real
+ * or imaginary part of its inputs, 'peak': the smallest one (possibly negative) that
+ * keeps the outputs, rounding included, inside the sample range.
+ */
+template <class S>
+static ne10_int32_t ne10_fft_block_shift (typename ne10_fft_fixed_traits<S>::acc_t peak, ne10_float64_t growth)
+{
+    const ne10_int32_t q = ne10_fft_fixed_traits<S>::Q;
+    const ne10_float64_t limit = ldexp (1.0, q) - 8.0;
+    ne10_int32_t shift = 0;
+
+    if (peak == 0)
+    {
+        return 0;
+    }
+    // Rounding a right shift may add half an LSB
+    while (growth * (ldexp ( (ne10_float64_t) peak, -shift) + (shift > 0 ? 0.5 : 0.0)) > limit)
+    {
+        shift++;
+    }
+    while (shift > -q && growth * ldexp ( (ne10_float64_t) peak, 1 - shift) <= limit)
+    {
+        shift--;
+    }
+    return shift;
+}
+
+/*
+ * One radix-2/4 stage, with the indexing of ne10_radix_stage_c. The inputs are scaled by
+ * 2^-shift as they are loaded. Returns the largest real or imaginary part written.
+ */
+template <class S, ne10_int32_t radix, bool inverse>
+static typename ne10_fft_fixed_traits<S>::acc_t ne10_radix_stage_fixed (typename ne10_fft_fixed_traits<S>::cpx_t *dst,
+        const typename ne10_fft_fixed_traits<S>::cpx_t *src,
+        const typename ne10_fft_fixed_traits<S>::cpx_t *twiddles,
+        ne10_int32_t fstride,
+        ne10_int32_t mstride,
+        ne10_int32_t shift)
+{
+    typedef typename ne10_fft_fixed_traits<S>::acc_t A;
+    ne10_int32_t f_count, m_count, k;
+    ne10_int32_t step = fstride * mstride;
+    ne10_fft_acc_cpx<A> x[radix], t[4];
+    A a_r, a_i, peak = 0;
+    S tw_r, tw_i;
+
+    for (f_count = 0; f_count < fstride; f_count++)
+    {
+        for (m_count = 0; m_count < mstride; m_count++)
+        {
+            for (k = 0; k < radix; k++)
+            {
+                a_r = ne10_fixed_shift<A> (src[m_count + k * step].r, shift);
+                a_i = ne10_fixed_shift<A> (src[m_count + k * step].i, shift);
+                if (k == 0 || twiddles == NULL)
+                {
+                    x[k].r = a_r;
+                    x[k].i = a_i;
+                    continue;
+                }
+                tw_r = twiddles[m_count + (k - 1) * mstride].r;
+                tw_i = twiddles[m_count + (k - 1) * mstride].i;
+                if (inverse)
+                {
+                    tw_i = -tw_i;
+                }
+                x[k].r = ne10_fixed_mul<S, A> (a_r, tw_r) - ne10_fixed_mul<S, A> (a_i, tw_i);
+                x[k].i = ne10_fixed_mul<S, A> (a_i, tw_r) + ne10_fixed_mul<S, A> (a_r, tw_i);
+            }
+
+            if (radix == 2)
+            {
+                t[0] = x[0];
+                x[0].r = t[0].r + x[1].r;
+                x[0].i = t[0].i + x[1].i;
+                x[1].r = t[0].r - x[1].r;
+                x[1].i = t[0].i - x[1].i;
+            }
+            else
+            {
+                t[0].r = x[0].r + x[2].r;
+                t[0].i = x[0].i + x[2].i;
+                t[1].r = x[0].r - x[2].r;
+                t[1].i = x[0].i - x[2].i;
+                t[2].r = x[1].r + x[3].r;
+                t[2].i = x[1].i + x[3].i;
+                // (x[1] - x[3]) * -i (forward) or i (inverse)
+                t[3].r = inverse ? x[3].i - x[1].i : x[1].i - x[3].i;
+                t[3].i = inverse ? x[1].r - x[3].r : x[3].r - x[1].r;
+
+                x[0].r = t[0].r + t[2].r;
+                x[0].i = t[0].i + t[2].i;
+                x[1].r = t[1].r + t[3].r;
+                x[1].i = t[1].i + t[3].i;
+                x[2].r = t[0].r - t[2].r;
+                x[2].i = t[0].i - t[2].i;
+                x[3].r = t[1].r - t[3].r;
+                x[3].i = t[1].i - t[3].i;
+            }
+
+            for (k = 0; k < radix; k++)
+            {
+                dst[m_count + k * mstride].r = (S) x[k].r;
+                dst[m_count + k * mstride].i = (S) x[k].i;
+                peak = NE10_MAX (peak, NE10_MAX (ne10_fixed_abs (x[k].r), ne10_fixed_abs (x[k].i)));
+            }
+        }
+        src += mstride;
+        dst += mstride * radix;
+    }
+    return peak;
+}
+
+/*
+ * The complex transform of ncfft points, stage by stage as in
+ * ne10_mixed_radix_generic_butterfly_c: out and buffer must not overlap, while 'in' is
+ * only read by the first stage and may be buffer. 'peak' is the largest real or
+ * imaginary part of 'in'; the shifts applied are added to *exponent.
+ */
+template <class S, bool inverse>
+static typename ne10_fft_fixed_traits<S>::acc_t ne10_mixed_radix_butterfly_fixed (typename ne10_fft_fixed_traits<S>::cpx_t *out,
+        const typename ne10_fft_fixed_traits<S>::cpx_t *in,
+        typename ne10_fft_fixed_traits<S>::cpx_t *buffer,
+        const ne10_int32_t *factors,
+        const typename ne10_fft_fixed_traits<S>::cpx_t *twiddles,
+        typename ne10_fft_fixed_traits<S>::acc_t peak,
+        ne10_int32_t *exponent)
+{
+    typedef typename ne10_fft_fixed_traits<S>::cpx_t T;
+    // Worst-case growth of a real or imaginary part: radix without twiddles, and
+    // 1 + (radix - 1) * sqrt (2) with them
+    const ne10_float64_t sqrt2 = 1.41421356237309504880;
+    ne10_int32_t stage_count = factors[0];
+    ne10_int32_t fstride = factors[1];
+    ne10_int32_t radix = factors[stage_count << 1];
+    ne10_int32_t mstride = 1;
+    ne10_int32_t shift;
+    T *out_final = out;
+    T *dst, *tmp;
+
+    shift = ne10_fft_block_shift<S> (peak, radix);
+    *exponent += shift;
+    if (radix == 2)
+    {
+        peak = ne10_radix_stage_fixed<S, 2, inverse> (out, in, NULL, fstride, 1, shift);
+    }
+    else
+    {
+        peak = ne10_radix_stage_fixed<S, 4, inverse> (out, in, NULL, fstride, 1, shift);
+    }
+
+    in = out;
+    out = buffer;
+    for (stage_count--; stage_count > 0; stage_count--)
+    {
+        mstride *= radix;
+        radix = factors[stage_count << 1];
+        fstride /= radix;
+        dst = (stage_count == 1) ? out_final : out;
+
+        shift = ne10_fft_block_shift<S> (peak, 1.0 + (radix - 1) * sqrt2);
+        *exponent += shift;
+        if (radix == 2)
+        {
+            peak = ne10_radix_stage_fixed<S, 2, inverse> (dst, in, twiddles, fstride, mstride, shift);
+        }
+        else
+        {
+            peak = ne10_radix_stage_fixed<S, 4, inverse> (dst, in, twiddles, fstride, mstride, shift);
+        }
+        twiddles += mstride * (radix - 1);
+
+        tmp = (T*) in;
+        in = out;
+        out = tmp;
+    }
+    return peak;
+}
+
+template <class S>
+static typename ne10_fft_fixed_traits<S>::state_t* ne10_fft_alloc_r2c_fixed (ne10_int32_t nfft)
+{
+    typedef typename ne10_fft_fixed_traits<S>::cpx_t T;
+    typedef typename ne10_fft_fixed_traits<S>::state_t state_t;
+    const ne10_float64_t one = ldexp (1.0, ne10_fft_fixed_traits<S>::Q);
+    state_t *st = NULL;
+    ne10_fft_cpx_float64_t *tables = NULL;
+    ne10_int32_t ncfft = nfft >> 1;
+    ne10_int32_t j;
+
+    // Power-of-two lengths only, so that every stage is radix 2 or 4
+    if ((nfft < 4) || (nfft & (nfft - 1)))
+    {
+        return NULL;
+    }
+
+    size_t memneeded = sizeof (state_t)
+                       + sizeof (ne10_int32_t) * (NE10_MAXFACTORS * 2)        /* factors */
+                       + sizeof (T) * ncfft                                   /* twiddle */
+                       + sizeof (T) * (ncfft / 2)                      /* super twiddles */
+                       + sizeof (T) * nfft                                     /* buffer */
+                       + NE10_FFT_BYTE_ALIGNMENT;                    /* 64-bit alignment */
+
+    st = (state_t*) NE10_MALLOC (memneeded);
+    tables = (ne10_fft_cpx_float64_t*) NE10_MALLOC (sizeof (ne10_fft_cpx_float64_t) * (ncfft + ncfft / 2));
+    if ((st == NULL) || (tables == NULL))
+    {
+        NE10_FREE (st);
+        NE10_FREE (tables);
+        return NULL;
+    }
+
+    uintptr_t address = (uintptr_t) st + sizeof (state_t);
+    NE10_BYTE_ALIGNMENT (address, NE10_FFT_BYTE_ALIGNMENT);
+    st->factors = (ne10_int32_t*) address;
+    st->twiddles = (T*) (st->factors + (NE10_MAXFACTORS * 2));
+    st->super_twiddles = st->twiddles + ncfft;
+    st->buffer = st->super_twiddles + (ncfft / 2);
+    st->ncfft = ncfft;
+
+    // The tables are computed in double and rounded once. +/-1 saturate to +/-(2^Q - 1), so
+    // that the inverse can conjugate them without overflow
+    if (ne10_fft_r2c_init_tables_c (ncfft, st->factors, tables, tables + ncfft, NE10_FACTOR_DEFAULT) == NE10_ERR)
+    {
+        NE10_FREE (st);
+        NE10_FREE (tables);
+        return NULL;
+    }
+    for (j = 0; j < ncfft + ncfft / 2; j++)
+    {
+        st->twiddles[j].r = (S) NE10_MAX (NE10_MIN (floor (tables[j].r * one + 0.5), one - 1.0), 1.0 - one);
+        st->twiddles[j].i = (S) NE10_MAX (NE10_MIN (floor (tables[j].i * one + 0.5), one - 1.0), 1.0 - one);
+    }
+    NE10_FREE (tables);
+
+    return st;
+}
+
+template <class S>
+static ne10_int32_t ne10_fft_r2c_fixed (typename ne10_fft_fixed_traits<S>::cpx_t *fout,
+                                        const S *fin,
+                                        typename ne10_fft_fixed_traits<S>::state_t *cfg)
+{
+    typedef typename ne10_fft_fixed_traits<S>::cpx_t T;
+    typedef typename ne10_fft_fixed_traits<S>::acc_t A;
+    T *tmpbuf1 = cfg->buffer;
+    T *tmpbuf2 = cfg->buffer + cfg->ncfft;
+    const T *twiddles = cfg->super_twiddles;
+    ne10_int32_t ncfft = cfg->ncfft;
+    ne10_int32_t exponent = 0;
+    ne10_int32_t shift, k;
+    ne10_fft_acc_cpx<A> fpk, fpnk, f1k, f2k, tw, tdc;
+    A peak = 0;
+
+    for (k = 0; k < 2 * ncfft; k++)
+    {
+        peak = NE10_MAX (peak, ne10_fixed_abs ( (A) fin[k]));
+    }
+    peak = ne10_mixed_radix_butterfly_fixed<S, false> (tmpbuf1, (const T*) fin, tmpbuf2, cfg->factors, cfg->twiddles,
+            peak, &exponent);
+
+    // Split, as ne10_fft_split_r2c_c; no output exceeds (1 + sqrt (2)) times the peak
+    shift = ne10_fft_block_shift<S> (peak, 2.41421356237309504880);
+    exponent += shift;
+    for (k = 1; k <= ncfft / 2; k++)
+    {
+        fpk.r = ne10_fixed_shift<A> (tmpbuf1[k].r, shift);
+        fpk.i = ne10_fixed_shift<A> (tmpbuf1[k].i, shift);
+        fpnk.r = ne10_fixed_shift<A> (tmpbuf1[ncfft - k].r, shift);
+        fpnk.i = -ne10_fixed_shift<A> (tmpbuf1[ncfft - k].i, shift);
+
+        f1k.r = fpk.r + fpnk.r;
+        f1k.i = fpk.i + fpnk.i;
+        f2k.r = fpk.r - fpnk.r;
+        f2k.i = fpk.i - fpnk.i;
+
+        tw.r = ne10_fixed_mul<S, A> (f2k.r, twiddles[k - 1].r) - ne10_fixed_mul<S, A> (f2k.i, twiddles[k - 1].i);
+        tw.i = ne10_fixed_mul<S, A> (f2k.r, twiddles[k - 1].i) + ne10_fixed_mul<S, A> (f2k.i, twiddles[k - 1].r);
+
+        fout[k].r = (S) ne10_fixed_shift<A> (f1k.r + tw.r, 1);
+        fout[k].i = (S) ne10_fixed_shift<A> (f1k.i + tw.i, 1);
+        fout[ncfft - k].r = (S) ne10_fixed_shift<A> (f1k.r - tw.r, 1);
+        fout[ncfft - k].i = (S) ne10_fixed_shift<A> (tw.i - f1k.i, 1);
+    }
+
+    tdc.r = ne10_fixed_shift<A> (tmpbuf1[0].r, shift);
+    tdc.i = ne10_fixed_shift<A> (tmpbuf1[0].i, shift);
+    fout[0].r = (S) (tdc.r + tdc.i);
+    fout[0].i = 0;
+    fout[ncfft].r = (S) (tdc.r - tdc.i);
+    fout[ncfft].i = 0;
+
+    return exponent;
+}
+
+template <class S>
+static ne10_int32_t ne10_fft_c2r_fixed (S *fout,
+                                        const typename ne10_fft_fixed_traits<S>::cpx_t *fin,
+                                        ne10_int32_t exponent,
+                                        typename ne10_fft_fixed_traits<S>::state_t *cfg)
+{
+    typedef typename ne10_fft_fixed_traits<S>::cpx_t T;
+    typedef typename ne10_fft_fixed_traits<S>::acc_t A;
+    T *tmpbuf1 = cfg->buffer;
+    T *tmpbuf2 = cfg->buffer + cfg->ncfft;
+    const T *twiddles = cfg->super_twiddles;
+    ne10_int32_t ncfft = cfg->ncfft;
+    ne10_int32_t shift, k;
+    ne10_fft_acc_cpx<A> fk, fnkc, fek, fok, tmp, x[4];
+    A dc, nyquist, peak = 0;
+
+    for (k = 1; k < ncfft; k++)
+    {
+        peak = NE10_MAX (peak, NE10_MAX (ne10_fixed_abs ( (A) fin[k].r), ne10_fixed_abs ( (A) fin[k].i)));
+    }
+    peak = NE10_MAX (peak, NE10_MAX (ne10_fixed_abs ( (A) fin[0].r), ne10_fixed_abs ( (A) fin[ncfft].r)));
+
+    // Merge, as ne10_fft_split_c2r_c, with the same bound as the split
+    shift = ne10_fft_block_shift<S> (peak, 2.41421356237309504880);
+    exponent += shift;
+    dc = ne10_fixed_shift<A> (fin[0].r, shift);
+    nyquist = ne10_fixed_shift<A> (fin[ncfft].r, shift);
+    tmpbuf1[0].r = (S) ne10_fixed_shift<A> (dc + nyquist, 1);
+    tmpbuf1[0].i = (S) ne10_fixed_shift<A> (dc - nyquist, 1);
+    peak = NE10_MAX (ne10_fixed_abs ( (A) tmpbuf1[0].r), ne10_fixed_abs ( (A) tmpbuf1[0].i));
+    for (k = 1; k <= ncfft / 2; k++)
+    {
+        fk.r = ne10_fixed_shift<A> (fin[k].r, shift);
+        fk.i = ne10_fixed_shift<A> (fin[k].i, shift);
+        fnkc.r = ne10_fixed_shift<A> (fin[ncfft - k].r, shift);
+        fnkc.i = -ne10_fixed_shift<A> (fin[ncfft - k].i, shift);
+
+        fek.r = fk.r + fnkc.r;
+        fek.i = fk.i + fnkc.i;
+        tmp.r = fk.r - fnkc.r;
+        tmp.i = fk.i - fnkc.i;
+
+        fok.r = ne10_fixed_mul<S, A> (tmp.r, twiddles[k - 1].r) + ne10_fixed_mul<S, A> (tmp.i, twiddles[k - 1].i);
+        fok.i = ne10_fixed_mul<S, A> (tmp.i, twiddles[k - 1].r) - ne10_fixed_mul<S, A> (tmp.r, twiddles[k - 1].i);
+
+        x[0].r = ne10_fixed_shift<A> (fek.r + fok.r, 1);
+        x[0].i = ne10_fixed_shift<A> (fek.i + fok.i, 1);
+        x[1].r = ne10_fixed_shift<A> (fek.r - fok.r, 1);
+        x[1].i = ne10_fixed_shift<A> (fok.i - fek.i, 1);
+        tmpbuf1[k].r = (S) x[0].r;
+        tmpbuf1[k].i = (S) x[0].i;
+        tmpbuf1[ncfft - k].r = (S) x[1].r;
+        tmpbuf1[ncfft - k].i = (S) x[1].i;
+        peak = NE10_MAX (peak, NE10_MAX (NE10_MAX (ne10_fixed_abs (x[0].r), ne10_fixed_abs (x[0].i)),
+                                         NE10_MAX (ne10_fixed_abs (x[1].r), ne10_fixed_abs (x[1].i))));
+    }
+
+    ne10_mixed_radix_butterfly_fixed<S, true> ( (T*) fout, tmpbuf1, tmpbuf2, cfg->factors, cfg->twiddles,
+            peak, &exponent);
+
+    // A complex IFFT of ncfft points yields 1 / 2 of the unscaled real inverse
+    return exponent + 1;
+}
+
+} // namespace
+
+/**
+ * @ingroup R2C_FFT_IFFT
+ * @brief Creates a configuration structure for @ref ne10_fft_r2c_1d_int16_c and @ref ne10_fft_c2r_1d_int16_c.
+ *
+ * @param[in]   nfft             input length, a power of two >= 4
+ * @retval      st               pointer to an FFT configuration structure (allocated with `malloc`), or `NULL` to indicate an error
+ *
+ * To free the returned structure, call @ref ne10_fft_destroy_r2c_int16.
+ */
+ne10_fft_r2c_cfg_int16_t ne10_fft_alloc_r2c_int16 (ne10_int32_t nfft)
+{
+    return ne10_fft_alloc_r2c_fixed<ne10_int16_t> (nfft);
+}
+
+void ne10_fft_destroy_r2c_int16 (ne10_fft_r2c_cfg_int16_t cfg)
+{
+    free (cfg);
+}
+
+/**
+ * @ingroup R2C_FFT_IFFT
+ * @brief Real-to-complex FFT of 16-bit samples with block floating point.
+ *
+ * @param[out]  fout             ncfft + 1 bins
+ * @param[in]   fin              input, nfft samples
+ * @param[in]   cfg              configuration structure
+ * @retval      the block exponent e: the unscaled spectrum is fout * 2^e
+ *
+ * fout may be fin (which then needs room for nfft + 2 samples).
+ */
+ne10_int32_t ne10_fft_r2c_1d_int16_c (ne10_fft_cpx_int16_t *fout,
+                                      const ne10_int16_t *fin,
+                                      ne10_fft_r2c_cfg_int16_t cfg)
+{
+    return ne10_fft_r2c_fixed<ne10_int16_t> (fout, fin, cfg);
+}
+
+/**
+ * @ingroup R2C_FFT_IFFT
+ * @brief Complex-to-real IFFT of 16-bit spectra with block floating point.
+ *
+ * @param[out]  fout             output, nfft samples
+ * @param[in]   fin              ncfft + 1 bins, the spectrum being fin * 2^exponent
+ * @param[in]   exponent         block exponent of fin
+ * @param[in]   cfg              configuration structure
+ * @retval      the block exponent e: the unscaled inverse (nfft times the signal) is fout * 2^e
+ *
+ * fin is left untouched and may be fout.
+ */
+ne10_int32_t ne10_fft_c2r_1d_int16_c (ne10_int16_t *fout,
+                                      const ne10_fft_cpx_int16_t *fin,
+                                      ne10_int32_t exponent,
+                                      ne10_fft_r2c_cfg_int16_t cfg)
+{
+    return ne10_fft_c2r_fixed<ne10_int16_t> (fout, fin, exponent, cfg);
+}
+
+/**
+ * @ingroup R2C_FFT_IFFT
+ * @brief Creates a configuration structure for @ref ne10_fft_r2c_1d_int32_c and @ref ne10_fft_c2r_1d_int32_c.
+ *
+ * @param[in]   nfft             input length, a power of two >= 4
+ * @retval      st               pointer to an FFT configuration structure (allocated with `malloc`), or `NULL` to indicate an error
+ *
+ * To free the returned structure, call @ref ne10_fft_destroy_r2c_int32.
+ */
+ne10_fft_r2c_cfg_int32_t ne10_fft_alloc_r2c_int32 (ne10_int32_t nfft)
+{
+    return ne10_fft_alloc_r2c_fixed<ne10_int32_t> (nfft);
+}
+
+void ne10_fft_destroy_r2c_int32 (ne10_fft_r2c_cfg_int32_t cfg)
+{
+    free (cfg);
+}
+
+/**
+ * @ingroup R2C_FFT_IFFT
+ * @brief 32-bit counterpart of @ref ne10_fft_r2c_1d_int16_c.
+ */
+ne10_int32_t ne10_fft_r2c_1d_int32_c (ne10_fft_cpx_int32_t *fout,
+                                      const ne10_int32_t *fin,
+                                      ne10_fft_r2c_cfg_int32_t cfg)
+{
+    return ne10_fft_r2c_fixed<ne10_int32_t> (fout, fin, cfg);
+}
+
+/**
+ * @ingroup R2C_FFT_IFFT
+ * @brief 32-bit counterpart of @ref ne10_fft_c2r_1d_int16_c.
+ */
+ne10_int32_t ne10_fft_c2r_1d_int32_c (ne10_int32_t *fout,
+                                      const ne10_fft_cpx_int32_t *fin,
+                                      ne10_int32_t exponent,
+                                      ne10_fft_r2c_cfg_int32_t cfg)
+{
+    return ne10_fft_c2r_fixed<ne10_int32_t> (fout, fin, exponent, cfg);
+}
@@ -45,10 +45,18 @@ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
  */
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <stddef.h>
 #include <math.h>
 #include <assert.h>
+#include <atomic>
+#include <mutex>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 #include "../Include/NE10_fft.h"
+#include "../Include/NE10_fft_simd.h"
+#include "../Include/NE10_fft_generic.h"
 #include "../Include/do_fft.h"
 
  /*
@@ -188,12 +196,14 @@ static void ne10_mixed_radix_butterfly_float32_c (ne10_fft_cpx_float32_t *out,
         ne10_fft_cpx_float32_t *in,
         ne10_int32_t *factors,
         ne10_fft_cpx_float32_t *twiddles,
-        ne10_fft_cpx_float32_t *buffer)
+        ne10_fft_cpx_float32_t *buffer,
+        ne10_float32_t scale)
 {
     ne10_int32_t stage_count = factors[0];
     ne10_int32_t fstride = factors[1];
     ne10_int32_t mstride = factors[(stage_count << 1) - 1];
     ne10_int32_t first_radix = factors[stage_count << 1];
+    ne10_int32_t nfft = fstride * first_radix;
     ne10_int32_t step, f_count, m_count;
     ne10_fft_cpx_float32_t *src = in;
     ne10_fft_cpx_float32_t *dst = out;
@@ -361,10 +371,10 @@ static void ne10_mixed_radix_butterfly_float32_c (ne10_fft_cpx_float32_t *out,
     }
     else if (first_radix == 2) // nfft = 2
     {
-        dst[0].r = src[0].r + src[1].r;
-        dst[0].i = src[0].i + src[1].i;
-        dst[1].r = src[0].r - src[1].r;
-        dst[1].i = src[0].i - src[1].i;
+        dst[0].r = (src[0].r + src[1].r) * scale;
+        dst[0].i = (src[0].i + src[1].i) * scale;
+        dst[1].r = (src[0].r - src[1].r) * scale;
+        dst[1].i = (src[0].i - src[1].i) * scale;
         return;
     }
     else // nfft = 1
@@ -518,6 +528,16 @@ static void ne10_mixed_radix_butterfly_float32_c (ne10_fft_cpx_float32_t *out,
             } // m_count
         } // f_count
     } // last stage
+
+    // The forward transform is normally unscaled, so scale (if asked to) in a separate pass
+    if (scale != 1.0f)
+    {
+        for (f_count = 0; f_count < nfft; f_count++)
+        {
+            out_final[f_count].r *= scale;
+            out_final[f_count].i *= scale;
+        }
+    }
 }
 
 /*
@@ -528,13 +548,14 @@ static void ne10_mixed_radix_butterfly_inverse_float32_c (ne10_fft_cpx_float32_t
         ne10_fft_cpx_float32_t *in,
         ne10_int32_t *factors,
         ne10_fft_cpx_float32_t *twiddles,
-        ne10_fft_cpx_float32_t *buffer)
+        ne10_fft_cpx_float32_t *buffer,
+        ne10_float32_t scale)
 {
     ne10_int32_t stage_count = factors[0];
     ne10_int32_t fstride = factors[1];
     ne10_int32_t mstride = factors[(stage_count << 1) - 1];
     ne10_int32_t first_radix = factors[stage_count << 1];
-    ne10_float32_t one_by_nfft = (1.0f / (ne10_float32_t) (fstride * first_radix));
+    ne10_float32_t one_by_nfft = scale;
     ne10_int32_t step, f_count, m_count;
     ne10_fft_cpx_float32_t *src = in;
     ne10_fft_cpx_float32_t *dst = out;
@@ -868,77 +889,148 @@ static void ne10_mixed_radix_butterfly_inverse_float32_c (ne10_fft_cpx_float32_t
     } // last stage
 }
 
-static void ne10_fft_split_r2c_1d_float32 (ne10_fft_cpx_float32_t *dst,
-        const ne10_fft_cpx_float32_t *src,
-        ne10_fft_cpx_float32_t *twiddles,
-        ne10_int32_t ncfft)
+static void ne10_transpose_float32_c (ne10_float32_t *dst,
+        ne10_int32_t dst_stride,
+        const ne10_float32_t *src,
+        ne10_int32_t src_stride,
+        ne10_int32_t rows,
+        ne10_int32_t cols)
 {
-    ne10_int32_t k;
-    ne10_fft_cpx_float32_t fpnk, fpk, f1k, f2k, tw, tdc;
-
-    tdc.r = src[0].r;
-    tdc.i = src[0].i;
-
-    dst[0].r = tdc.r + tdc.i;
-    dst[ncfft].r = tdc.r - tdc.i;
-    dst[ncfft].i = dst[0].i = 0;
+    ne10_int32_t r, c;
 
-    for (k = 1; k <= ncfft / 2 ; ++k)
+    for (r = 0; r < rows; r++)
     {
-        fpk    = src[k];
-        fpnk.r =   src[ncfft - k].r;
-        fpnk.i = - src[ncfft - k].i;
-
-        f1k.r = fpk.r + fpnk.r;
-        f1k.i = fpk.i + fpnk.i;
-
-        f2k.r = fpk.r - fpnk.r;
-        f2k.i = fpk.i - fpnk.i;
-
-        tw.r = f2k.r * (twiddles[k - 1]).r - f2k.i * (twiddles[k - 1]).i;
-        tw.i = f2k.r * (twiddles[k - 1]).i + f2k.i * (twiddles[k - 1]).r;
-
-        dst[k].r = (f1k.r + tw.r) * 0.5f;
-        dst[k].i = (f1k.i + tw.i) * 0.5f;
-        dst[ncfft - k].r = (f1k.r - tw.r) * 0.5f;
-        dst[ncfft - k].i = (tw.i - f1k.i) * 0.5f;
+        for (c = 0; c < cols; c++)
+        {
+            dst[c * dst_stride + r] = src[r * src_stride + c];
+        }
     }
 }
 
-static void ne10_fft_split_c2r_1d_float32 (ne10_fft_cpx_float32_t *dst,
-        const ne10_fft_cpx_float32_t *src,
-        ne10_fft_cpx_float32_t *twiddles,
-        ne10_int32_t ncfft)
+static const ne10_fft_kernels_float32_t s_kernels_c =
 {
+    NE10_FFT_ISA_C,
+    ne10_mixed_radix_butterfly_float32_c,
+    ne10_mixed_radix_butterfly_inverse_float32_c,
+    ne10_fft_split_r2c_c<ne10_fft_cpx_float32_t>,
+    ne10_fft_split_c2r_c<ne10_fft_cpx_float32_t>,
+    ne10_fft_split_r2c_soa<ne10_fft_scalar_traits>,
+    ne10_fft_split_c2r_soa<ne10_fft_scalar_traits>,
+    {
+        { 0, NULL, NULL },
+    },
+    ne10_transpose_float32_c,
+    ne10_cvt_float16_float32_c,
+    ne10_cvt_float32_float16_c,
+};
 
-    ne10_int32_t k;
-    ne10_fft_cpx_float32_t fk, fnkc, fek, fok, tmp;
-
-
-    dst[0].r = (src[0].r + src[ncfft].r) * 0.5f;
-    dst[0].i = (src[0].r - src[ncfft].r) * 0.5f;
+static std::atomic<const ne10_fft_kernels_float32_t*> s_kernels (NULL);
 
-    for (k = 1; k <= ncfft / 2; k++)
+static ne10_int32_t ne10_fft_cpu_isa (void)
+{
+#if defined(NE10_FFT_X86) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init ();
+    if (__builtin_cpu_supports ("avx512f"))
+    {
+        return NE10_FFT_ISA_AVX512;
+    }
+    if (__builtin_cpu_supports ("avx2") && __builtin_cpu_supports ("fma") && __builtin_cpu_supports ("f16c"))
     {
-        fk = src[k];
-        fnkc.r = src[ncfft - k].r;
-        fnkc.i = -src[ncfft - k].i;
+        return NE10_FFT_ISA_AVX2;
+    }
+    if (__builtin_cpu_supports ("sse2"))
+    {
+        return NE10_FFT_ISA_SSE2;
+    }
+#elif defined(NE10_FFT_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid (info, 0);
+    int max_leaf = info[0];
+    __cpuid (info, 1);
+    int has_sse2 = (info[3] >> 26) & 1;
+    int has_fma = (info[2] >> 12) & 1;
+    int has_f16c = (info[2] >> 29) & 1;
+    int has_os_avx = ( (info[2] >> 27) & 1) && ( (_xgetbv (0) & 0x06) == 0x06);
+    int has_os_avx512 = has_os_avx && ( (_xgetbv (0) & 0xe6) == 0xe6);
+    if (max_leaf >= 7)
+    {
+        __cpuidex (info, 7, 0);
+        if (has_os_avx512 && ( (info[1] >> 16) & 1))
+        {
+            return NE10_FFT_ISA_AVX512;
+        }
+        if (has_os_avx && has_fma && has_f16c && ( (info[1] >> 5) & 1))
+        {
+            return NE10_FFT_ISA_AVX2;
+        }
+    }
+    if (has_sse2)
+    {
+        return NE10_FFT_ISA_SSE2;
+    }
+#endif
+    return NE10_FFT_ISA_C;
+}
 
-        fek.r = fk.r + fnkc.r;
-        fek.i = fk.i + fnkc.i;
+/*
+ * Picks the widest kernel table that is compiled in, supported by the CPU and not
+ * wider than 'isa'.
+ */
+static const ne10_fft_kernels_float32_t* ne10_fft_select_kernels (ne10_int32_t isa)
+{
+    const ne10_fft_kernels_float32_t *kernels = NULL;
+    ne10_int32_t cpu_isa = ne10_fft_cpu_isa ();
 
-        tmp.r = fk.r - fnkc.r;
-        tmp.i = fk.i - fnkc.i;
+    isa = NE10_MIN (isa, cpu_isa);
+    if (isa >= NE10_FFT_ISA_AVX512 && (kernels = ne10_fft_kernels_avx512_float32 ()) != NULL)
+    {
+        return kernels;
+    }
+    if (isa >= NE10_FFT_ISA_AVX2 && (kernels = ne10_fft_kernels_avx2_float32 ()) != NULL)
+    {
+        return kernels;
+    }
+    if (isa >= NE10_FFT_ISA_SSE2 && (kernels = ne10_fft_kernels_sse2_float32 ()) != NULL)
+    {
+        return kernels;
+    }
+    return &s_kernels_c;
+}
 
-        fok.r = tmp.r * twiddles[k - 1].r + tmp.i * twiddles[k - 1].i;
-        fok.i = tmp.i * twiddles[k - 1].r - tmp.r * twiddles[k - 1].i;
+static inline const ne10_fft_kernels_float32_t* ne10_fft_kernels (void)
+{
+    const ne10_fft_kernels_float32_t *kernels = s_kernels.load (std::memory_order_acquire);
+    if (kernels == NULL)
+    {
+        kernels = ne10_fft_select_kernels (NE10_FFT_ISA_AVX512);
+        s_kernels.store (kernels, std::memory_order_release);
+    }
+    return kernels;
+}
 
-        dst[k].r = (fek.r + fok.r) * 0.5f;
-        dst[k].i = (fek.i + fok.i) * 0.5f;
+/**
+ * @brief Returns the instruction set (NE10_FFT_ISA_*) of the kernels currently in use.
+ */
+ne10_int32_t ne10_fft_get_isa_float32 (void)
+{
+    return ne10_fft_kernels ()->isa;
+}
 
-        dst[ncfft - k].r = (fek.r - fok.r) * 0.5f;
-        dst[ncfft - k].i = (fok.i - fek.i) * 0.5f;
-    }
+/**
+ * @brief Restricts the FFT kernels to at most the given instruction set.
+ *
+ * @param[in]   isa              one of NE10_FFT_ISA_*
+ * @retval      the instruction set actually selected, which may be narrower than requested
+ *              if the CPU or the build does not support it
+ *
+ * Mainly meant for testing and benchmarking the C reference against the vector kernels.
+ * Must not be called while another thread is executing a transform.
+ */
+ne10_int32_t ne10_fft_set_isa_float32 (ne10_int32_t isa)
+{
+    const ne10_fft_kernels_float32_t *kernels = ne10_fft_select_kernels (isa);
+    s_kernels.store (kernels, std::memory_order_release);
+    return kernels->isa;
 }
 
 // For NE10_UNROLL_LEVEL > 0, please refer to NE10_rfft_float.c
@@ -963,6 +1055,12 @@ ne10_fft_r2c_cfg_float32_t ne10_fft_alloc_r2c_float32 (ne10_int32_t nfft)
     ne10_fft_r2c_cfg_float32_t st = NULL;
     ne10_int32_t ncfft = nfft >> 1;
 
+    // The real transform is computed as a complex transform of half the length
+    if ((ncfft <= 0) || (nfft & 1))
+    {
+        return NULL;
+    }
+
     ne10_uint32_t memneeded = sizeof (ne10_fft_r2c_state_float32_t)
                               + sizeof (ne10_int32_t) * (NE10_MAXFACTORS * 2)        /* factors */
                               + sizeof (ne10_fft_cpx_float32_t) * ncfft              /* twiddle */
@@ -981,85 +1079,805 @@ ne10_fft_r2c_cfg_float32_t ne10_fft_alloc_r2c_float32 (ne10_int32_t nfft)
         st->super_twiddles = st->twiddles + ncfft;
         st->buffer = st->super_twiddles + (ncfft / 2);
         st->ncfft = ncfft;
-
-        ne10_int32_t result = ne10_factor (ncfft, st->factors, NE10_FACTOR_EIGHT_FIRST_STAGE);
-        if (result == NE10_ERR)
+        st->forward_scale = 1.0f;
+#ifdef NE10_DSP_RFFT_SCALING
+        st->backward_scale = 1.0f / nfft;
+#else
+        st->backward_scale = 1.0f;
+#endif
+
+        if (ne10_fft_r2c_init_tables_c (ncfft, st->factors, st->twiddles, st->super_twiddles, NE10_FACTOR_EIGHT_FIRST_STAGE) == NE10_ERR)
         {
             NE10_FREE (st);
             return NULL;
         }
+    }
 
-        ne10_int32_t j, k;
-        ne10_int32_t *factors = st->factors;
-        ne10_fft_cpx_float32_t *twiddles = st->twiddles;
-        ne10_int32_t stage_count = factors[0];
-        ne10_int32_t fstride = factors[1];
-        ne10_int32_t mstride;
-        ne10_int32_t cur_radix;
-        ne10_float32_t phase;
-        const ne10_float32_t pi = NE10_PI;
-
-        // Don't generate any twiddles for the first stage
-        stage_count --;
-
-        // Generate twiddles for the other stages
-        for (; stage_count > 0; stage_count --)
-        {
-            cur_radix = factors[2 * stage_count];
-            fstride /= cur_radix;
-            mstride = factors[2 * stage_count + 1];
-            for (j = 0; j < mstride; j++)
-            {
-                for (k = 1; k < cur_radix; k++) // phase = 1 when k = 0
-                {
-                    phase = -2 * pi * fstride * k * j / ncfft;
-                    twiddles[mstride * (k - 1) + j].r = (ne10_float32_t) cos (phase);
-                    twiddles[mstride * (k - 1) + j].i = (ne10_float32_t) sin (phase);
-                }
-            }
-            twiddles += mstride * (cur_radix - 1);
-        }
+    return st;
+}
 
-        twiddles = st->super_twiddles;
-        for (j = 0; j < ncfft / 2; j++)
+/*
+ * Process-wide cache of r2c factor/twiddle tables.
+ *
+ * Tables are immutable once built, so they are shared by every configuration
+ * of the same length (forward and backward transforms use the same tables).
+ * Entries are kept in a singly-linked list that is only ever prepended to:
+ * lookups walk it without locking, and inserts are serialised by a mutex and
+ * published with a release store of the list head.
+ */
+#define NE10_FFT_TABLE_R2C 0
+
+typedef struct ne10_fft_table_float32
+{
+    ne10_int32_t nfft;
+    ne10_int32_t kind;
+    ne10_int32_t *factors;
+    ne10_fft_cpx_float32_t *twiddles;
+    ne10_fft_cpx_float32_t *super_twiddles;
+    struct ne10_fft_table_float32 *next;
+} ne10_fft_table_float32_t;
+
+static std::atomic<ne10_fft_table_float32_t*> s_fft_tables (NULL);
+static std::mutex s_fft_tables_mutex;
+
+static ne10_fft_table_float32_t* ne10_fft_find_table_float32 (ne10_int32_t nfft, ne10_int32_t kind)
+{
+    ne10_fft_table_float32_t *table = s_fft_tables.load (std::memory_order_acquire);
+    for (; table != NULL; table = table->next)
+    {
+        if ((table->nfft == nfft) && (table->kind == kind))
         {
-            phase = -pi * ( (ne10_float32_t) (j + 1) / ncfft + 0.5f);
-            twiddles->r = (ne10_float32_t) cos (phase);
-            twiddles->i = (ne10_float32_t) sin (phase);
-            twiddles++;
+            return table;
         }
     }
+    return NULL;
+}
+
+static ne10_fft_table_float32_t* ne10_fft_get_r2c_table_float32 (ne10_int32_t nfft)
+{
+    ne10_fft_table_float32_t *table = ne10_fft_find_table_float32 (nfft, NE10_FFT_TABLE_R2C);
+    if (table != NULL)
+    {
+        return table;
+    }
+
+    std::lock_guard<std::mutex> guard (s_fft_tables_mutex);
+
+    // Another thread may have built it while we were waiting for the lock
+    table = ne10_fft_find_table_float32 (nfft, NE10_FFT_TABLE_R2C);
+    if (table != NULL)
+    {
+        return table;
+    }
+
+    ne10_int32_t ncfft = nfft >> 1;
+    ne10_uint32_t memneeded = sizeof (ne10_fft_table_float32_t)
+                              + sizeof (ne10_int32_t) * (NE10_MAXFACTORS * 2)        /* factors */
+                              + sizeof (ne10_fft_cpx_float32_t) * ncfft              /* twiddle */
+                              + sizeof (ne10_fft_cpx_float32_t) * (ncfft / 2) /* super twiddles */
+                              + NE10_FFT_BYTE_ALIGNMENT;                    /* 64-bit alignment */
+
+    table = (ne10_fft_table_float32_t*) NE10_MALLOC (memneeded);
+    if (table == NULL)
+    {
+        return NULL;
+    }
+
+    uintptr_t address = (uintptr_t) table + sizeof (ne10_fft_table_float32_t);
+    NE10_BYTE_ALIGNMENT (address, NE10_FFT_BYTE_ALIGNMENT);
+    table->nfft = nfft;
+    table->kind = NE10_FFT_TABLE_R2C;
+    table->factors = (ne10_int32_t*) address;
+    table->twiddles = (ne10_fft_cpx_float32_t*) (table->factors + (NE10_MAXFACTORS * 2));
+    table->super_twiddles = table->twiddles + ncfft;
+
+    if (ne10_fft_r2c_init_tables_c (ncfft, table->factors, table->twiddles, table->super_twiddles, NE10_FACTOR_EIGHT_FIRST_STAGE) == NE10_ERR)
+    {
+        NE10_FREE (table);
+        return NULL;
+    }
+
+    table->next = s_fft_tables.load (std::memory_order_relaxed);
+    s_fft_tables.store (table, std::memory_order_release);
+    return table;
+}
+
+/**
+ * @ingroup R2C_FFT_IFFT
+ * @brief Creates a configuration structure whose factor and twiddle tables are shared.
+ *
+ * @param[in]   nfft             input length
+ * @retval      st               pointer to an FFT configuration structure, or `NULL` to indicate an error
+ *
+ * Behaves like @ref ne10_fft_alloc_r2c_float32, but the factors, twiddles and super twiddles
+ * point into a process-wide cache that is built once per length and shared between threads.
+ * Only the scratch buffer is owned by the returned structure, so a configuration must not be
+ * used by two threads at once, while any number of configurations of the same length may be.
+ *
+ * Free the returned structure with @ref ne10_fft_destory_r2c_float32 as usual.
+ */
+ne10_fft_r2c_cfg_float32_t ne10_fft_alloc_r2c_shared_float32 (ne10_int32_t nfft)
+{
+    ne10_fft_r2c_cfg_float32_t st = NULL;
+    ne10_fft_table_float32_t *table = NULL;
+    ne10_int32_t ncfft = nfft >> 1;
+
+    if ((ncfft <= 0) || (nfft & 1))
+    {
+        return NULL;
+    }
+
+    table = ne10_fft_get_r2c_table_float32 (nfft);
+    if (table == NULL)
+    {
+        return NULL;
+    }
+
+    ne10_uint32_t memneeded = sizeof (ne10_fft_r2c_state_float32_t)
+                              + sizeof (ne10_fft_cpx_float32_t) * nfft                /* buffer */
+                              + NE10_FFT_BYTE_ALIGNMENT;                    /* 64-bit alignment */
+
+    st = (ne10_fft_r2c_cfg_float32_t) NE10_MALLOC (memneeded);
+
+    if (st)
+    {
+        uintptr_t address = (uintptr_t) st + sizeof (ne10_fft_r2c_state_float32_t);
+        NE10_BYTE_ALIGNMENT (address, NE10_FFT_BYTE_ALIGNMENT);
+        st->buffer = (ne10_fft_cpx_float32_t*) address;
+        st->ncfft = ncfft;
+        st->factors = table->factors;
+        st->twiddles = table->twiddles;
+        st->super_twiddles = table->super_twiddles;
+        st->forward_scale = 1.0f;
+#ifdef NE10_DSP_RFFT_SCALING
+        st->backward_scale = 1.0f / nfft;
+#else
+        st->backward_scale = 1.0f;
+#endif
+    }
 
     return st;
 }
 
+/**
+ * @brief Frees every table held by the shared cache.
+ *
+ * Only call this at shutdown, once no configuration created by
+ * @ref ne10_fft_alloc_r2c_shared_float32 is alive any more.
+ */
+void ne10_fft_release_shared_float32 (void)
+{
+    std::lock_guard<std::mutex> guard (s_fft_tables_mutex);
+
+    ne10_fft_table_float32_t *table = s_fft_tables.exchange (NULL, std::memory_order_acq_rel);
+    while (table != NULL)
+    {
+        ne10_fft_table_float32_t *next = table->next;
+        NE10_FREE (table);
+        table = next;
+    }
+}
+
+/*
+ * Real-to-complex transform shared by the public entry points. DC and Nyquist are both
+ * real: with 'packed' set, the Nyquist bin is stored in the imaginary part of DC and fout
+ * holds ncfft bins instead of ncfft + 1. fin is only read by the first butterfly stage,
+ * while fout serves as scratch from the second stage on, so fout may be fin.
+ */
+static void ne10_fft_r2c_float32 (ne10_fft_cpx_float32_t *fout,
+                                  ne10_float32_t *fin,
+                                  ne10_fft_r2c_cfg_float32_t cfg,
+                                  ne10_int32_t packed)
+{
+    ne10_fft_cpx_float32_t * tmpbuf = cfg->buffer;
+    ne10_fft_cpx_float32_t tdc;
+
+    const ne10_fft_kernels_float32_t *kernels = ne10_fft_kernels ();
+
+    // The vectorised butterflies only handle power-of-two lengths
+    if (cfg->factors[2 * cfg->factors[0] + 2] == NE10_FFT_ALG_ANY)
+    {
+        ne10_mixed_radix_generic_butterfly_c<ne10_fft_cpx_float32_t, false> (tmpbuf, (ne10_fft_cpx_float32_t*) fin,
+                cfg->factors, cfg->twiddles, fout, cfg->forward_scale);
+    }
+    else
+    {
+        kernels->butterfly (tmpbuf, (ne10_fft_cpx_float32_t*) fin, cfg->factors, cfg->twiddles, fout,
+                            cfg->forward_scale);
+    }
+    kernels->split_r2c (fout, tmpbuf, cfg->super_twiddles, cfg->ncfft);
+
+    tdc = tmpbuf[0];
+    fout[0].r = tdc.r + tdc.i;
+    if (packed)
+    {
+        fout[0].i = tdc.r - tdc.i;
+    }
+    else
+    {
+        fout[0].i = 0;
+        fout[cfg->ncfft].r = tdc.r - tdc.i;
+        fout[cfg->ncfft].i = 0;
+    }
+}
+
+// Inverse of ne10_fft_r2c_float32, for either packing. fin is left untouched and may be fout.
+static void ne10_fft_c2r_float32 (ne10_float32_t *fout,
+                                  ne10_fft_cpx_float32_t *fin,
+                                  ne10_fft_r2c_cfg_float32_t cfg,
+                                  ne10_int32_t packed)
+{
+    ne10_fft_cpx_float32_t * tmpbuf1 = cfg->buffer;
+    ne10_fft_cpx_float32_t * tmpbuf2 = cfg->buffer + cfg->ncfft;
+    ne10_float32_t dc = fin[0].r;
+    ne10_float32_t nyquist = packed ? fin[0].i : fin[cfg->ncfft].r;
+    // A complex IFFT of ncfft points yields ncfft / nfft = 1 / 2 of the unscaled real inverse
+    ne10_float32_t scale = 2.0f * cfg->backward_scale;
+
+    const ne10_fft_kernels_float32_t *kernels = ne10_fft_kernels ();
+
+    tmpbuf1[0].r = (dc + nyquist) * 0.5f;
+    tmpbuf1[0].i = (dc - nyquist) * 0.5f;
+    kernels->split_c2r (tmpbuf1, fin, cfg->super_twiddles, cfg->ncfft);
+    if (cfg->factors[2 * cfg->factors[0] + 2] == NE10_FFT_ALG_ANY)
+    {
+        ne10_mixed_radix_generic_butterfly_c<ne10_fft_cpx_float32_t, true> ( (ne10_fft_cpx_float32_t*) fout, tmpbuf1,
+                cfg->factors, cfg->twiddles, tmpbuf2, scale);
+    }
+    else
+    {
+        kernels->butterfly_inverse ( (ne10_fft_cpx_float32_t*) fout, tmpbuf1, cfg->factors, cfg->twiddles, tmpbuf2,
+                                     scale);
+    }
+}
+
 /**
  * @ingroup R2C_FFT_IFFT
  * Specific implementation of @ref ne10_fft_r2c_1d_float32 using plain C.
+ *
+ * fout receives ncfft + 1 bins and may be fin (which then needs room for them). The output
+ * is multiplied by cfg->forward_scale.
  */
 void ne10_fft_r2c_1d_float32_c (ne10_fft_cpx_float32_t *fout,
                                 ne10_float32_t *fin,
                                 ne10_fft_r2c_cfg_float32_t cfg)
 {
-    ne10_fft_cpx_float32_t * tmpbuf = cfg->buffer;
-
-    ne10_mixed_radix_butterfly_float32_c (tmpbuf, (ne10_fft_cpx_float32_t*) fin, cfg->factors, cfg->twiddles, fout);
-    ne10_fft_split_r2c_1d_float32 (fout, tmpbuf, cfg->super_twiddles, cfg->ncfft);
+    ne10_fft_r2c_float32 (fout, fin, cfg, 0);
 }
 
 /**
  * @ingroup R2C_FFT_IFFT
  * Specific implementation of @ref ne10_fft_c2r_1d_float32 using plain C.
+ *
+ * The output is multiplied by cfg->backward_scale relative to an unscaled inverse; fout may be fin.
  */
 void ne10_fft_c2r_1d_float32_c (ne10_float32_t *fout,
                                 ne10_fft_cpx_float32_t *fin,
                                 ne10_fft_r2c_cfg_float32_t cfg)
+{
+    ne10_fft_c2r_float32 (fout, fin, cfg, 0);
+}
+
+/**
+ * @ingroup R2C_FFT_IFFT
+ * @brief Real-to-complex FFT with the Nyquist bin packed into the imaginary part of DC.
+ *
+ * Same as @ref ne10_fft_r2c_1d_float32_c, but fout holds only ncfft bins, i.e. as many floats
+ * as fin, so the transform can run in place on a buffer of nfft floats.
+ */
+void ne10_fft_r2c_1d_packed_float32_c (ne10_fft_cpx_float32_t *fout,
+                                       ne10_float32_t *fin,
+                                       ne10_fft_r2c_cfg_float32_t cfg)
+{
+    ne10_fft_r2c_float32 (fout, fin, cfg, 1);
+}
+
+/**
+ * @ingroup R2C_FFT_IFFT
+ * @brief Complex-to-real IFFT of the packed spectrum of @ref ne10_fft_r2c_1d_packed_float32_c.
+ */
+void ne10_fft_c2r_1d_packed_float32_c (ne10_float32_t *fout,
+                                       ne10_fft_cpx_float32_t *fin,
+                                       ne10_fft_r2c_cfg_float32_t cfg)
+{
+    ne10_fft_c2r_float32 (fout, fin, cfg, 1);
+}
+
+/**
+ * @ingroup R2C_FFT_IFFT
+ * @brief Real-to-complex FFT producing separate real and imaginary arrays.
+ *
+ * @param[out]  re               real parts of bins 0 .. ncfft (ncfft + 1 floats)
+ * @param[out]  im               imaginary parts of bins 0 .. ncfft (ncfft + 1 floats)
+ * @param[in]   fin              input, nfft floats
+ * @param[in]   cfg              configuration structure
+ *
+ * The final (split) stage stores straight into re and im, so no de-interleaving pass is
+ * needed. fin is only read by the first butterfly stage and may overlap re or im.
+ */
+void ne10_fft_r2c_1d_split_float32_c (ne10_float32_t *re,
+                                      ne10_float32_t *im,
+                                      ne10_float32_t *fin,
+                                      ne10_fft_r2c_cfg_float32_t cfg)
 {
     ne10_fft_cpx_float32_t * tmpbuf1 = cfg->buffer;
     ne10_fft_cpx_float32_t * tmpbuf2 = cfg->buffer + cfg->ncfft;
+    ne10_fft_cpx_float32_t tdc;
+
+    const ne10_fft_kernels_float32_t *kernels = ne10_fft_kernels ();
+
+    if (cfg->factors[2 * cfg->factors[0] + 2] == NE10_FFT_ALG_ANY)
+    {
+        ne10_mixed_radix_generic_butterfly_c<ne10_fft_cpx_float32_t, false> (tmpbuf1, (ne10_fft_cpx_float32_t*) fin,
+                cfg->factors, cfg->twiddles, tmpbuf2, cfg->forward_scale);
+    }
+    else
+    {
+        kernels->butterfly (tmpbuf1, (ne10_fft_cpx_float32_t*) fin, cfg->factors, cfg->twiddles, tmpbuf2,
+                            cfg->forward_scale);
+    }
+    kernels->split_r2c_soa (re, im, tmpbuf1, cfg->super_twiddles, cfg->ncfft);
+
+    tdc = tmpbuf1[0];
+    re[0] = tdc.r + tdc.i;
+    im[0] = 0;
+    re[cfg->ncfft] = tdc.r - tdc.i;
+    im[cfg->ncfft] = 0;
+}
 
-    ne10_fft_split_c2r_1d_float32 (tmpbuf1, fin, cfg->super_twiddles, cfg->ncfft);
-    ne10_mixed_radix_butterfly_inverse_float32_c ( (ne10_fft_cpx_float32_t*) fout, tmpbuf1, cfg->factors, cfg->twiddles, tmpbuf2);
+/**
+ * @ingroup R2C_FFT_IFFT
+ * @brief Complex-to-real IFFT of the separate real and imaginary arrays of @ref ne10_fft_r2c_1d_split_float32_c.
+ *
+ * re and im are only read, by the first (merge) stage; fout may overlap them.
+ */
+void ne10_fft_c2r_1d_split_float32_c (ne10_float32_t *fout,
+                                      const ne10_float32_t *re,
+                                      const ne10_float32_t *im,
+                                      ne10_fft_r2c_cfg_float32_t cfg)
+{
+    ne10_fft_cpx_float32_t * tmpbuf1 = cfg->buffer;
+    ne10_fft_cpx_float32_t * tmpbuf2 = cfg->buffer + cfg->ncfft;
+    ne10_float32_t scale = 2.0f * cfg->backward_scale;
+
+    const ne10_fft_kernels_float32_t *kernels = ne10_fft_kernels ();
+
+    tmpbuf1[0].r = (re[0] + re[cfg->ncfft]) * 0.5f;
+    tmpbuf1[0].i = (re[0] - re[cfg->ncfft]) * 0.5f;
+    kernels->split_c2r_soa (tmpbuf1, re, im, cfg->super_twiddles, cfg->ncfft);
+    if (cfg->factors[2 * cfg->factors[0] + 2] == NE10_FFT_ALG_ANY)
+    {
+        ne10_mixed_radix_generic_butterfly_c<ne10_fft_cpx_float32_t, true> ( (ne10_fft_cpx_float32_t*) fout, tmpbuf1,
+                cfg->factors, cfg->twiddles, tmpbuf2, scale);
+    }
+    else
+    {
+        kernels->butterfly_inverse ( (ne10_fft_cpx_float32_t*) fout, tmpbuf1, cfg->factors, cfg->twiddles, tmpbuf2,
+                                     scale);
+    }
+}
+
+/**
+ * @ingroup R2C_FFT_IFFT
+ * @brief Converts count IEEE binary16 values to floats.
+ */
+void ne10_cvt_float16_float32 (ne10_float32_t *dst,
+                               const ne10_float16_t *src,
+                               ne10_int32_t count)
+{
+    ne10_fft_kernels ()->cvt_float16_float32 (dst, src, count);
+}
+
+/**
+ * @ingroup R2C_FFT_IFFT
+ * @brief Converts count floats to IEEE binary16, rounding to nearest even.
+ */
+void ne10_cvt_float32_float16 (ne10_float16_t *dst,
+                               const ne10_float32_t *src,
+                               ne10_int32_t count)
+{
+    ne10_fft_kernels ()->cvt_float32_float16 (dst, src, count);
+}
+
+/**
+ * @ingroup R2C_FFT_IFFT
+ * @brief Real-to-complex FFT of half precision data.
+ *
+ * @param[out]  fout             spectrum in CCS order (re[0], im[0], ..., re[ncfft], im[ncfft]),
+ *                               nfft + 2 halves
+ * @param[in]   fin              input, nfft halves
+ * @param[in]   cfg              an FP32 configuration structure
+ *
+ * Only the storage is half precision: fin is widened into the scratch buffer of cfg, the
+ * transform runs on the FP32 kernels and the spectrum is rounded back on the way out. This
+ * halves the size of stored signals and spectra; the result is accurate to the half
+ * precision rounding of the output (about 3e-4 of the peak magnitude). fout may be fin.
+ */
+void ne10_fft_r2c_1d_float16_c (ne10_float16_t *fout,
+                                const ne10_float16_t *fin,
+                                ne10_fft_r2c_cfg_float32_t cfg)
+{
+    ne10_fft_cpx_float32_t * tmpbuf1 = cfg->buffer;
+    ne10_fft_cpx_float32_t * tmpbuf2 = cfg->buffer + cfg->ncfft;
+    ne10_fft_cpx_float32_t tdc;
+    ne10_fft_cpx_float32_t nyquist;
+    ne10_int32_t ncfft = cfg->ncfft;
+
+    const ne10_fft_kernels_float32_t *kernels = ne10_fft_kernels ();
+
+    // The butterfly only reads its input in the first stage, so the input may be its scratch
+    kernels->cvt_float16_float32 ( (ne10_float32_t*) tmpbuf2, fin, 2 * ncfft);
+    if (cfg->factors[2 * cfg->factors[0] + 2] == NE10_FFT_ALG_ANY)
+    {
+        ne10_mixed_radix_generic_butterfly_c<ne10_fft_cpx_float32_t, false> (tmpbuf1, tmpbuf2,
+                cfg->factors, cfg->twiddles, tmpbuf2, cfg->forward_scale);
+    }
+    else
+    {
+        kernels->butterfly (tmpbuf1, tmpbuf2, cfg->factors, cfg->twiddles, tmpbuf2, cfg->forward_scale);
+    }
+    kernels->split_r2c (tmpbuf2, tmpbuf1, cfg->super_twiddles, ncfft);
+
+    tdc = tmpbuf1[0];
+    tmpbuf2[0].r = tdc.r + tdc.i;
+    tmpbuf2[0].i = 0;
+    nyquist.r = tdc.r - tdc.i;
+    nyquist.i = 0;
+    kernels->cvt_float32_float16 (fout, (ne10_float32_t*) tmpbuf2, 2 * ncfft);
+    kernels->cvt_float32_float16 (fout + 2 * ncfft, (ne10_float32_t*) &nyquist, 2);
+}
+
+/**
+ * @ingroup R2C_FFT_IFFT
+ * @brief Complex-to-real IFFT of the half precision spectrum of @ref ne10_fft_r2c_1d_float16_c.
+ *
+ * fin holds nfft + 2 halves in CCS order, fout receives nfft halves and may be fin.
+ */
+void ne10_fft_c2r_1d_float16_c (ne10_float16_t *fout,
+                                const ne10_float16_t *fin,
+                                ne10_fft_r2c_cfg_float32_t cfg)
+{
+    ne10_fft_cpx_float32_t * tmpbuf1 = cfg->buffer;
+    ne10_fft_cpx_float32_t * tmpbuf2 = cfg->buffer + cfg->ncfft;
+    ne10_fft_cpx_float32_t nyquist;
+    ne10_int32_t ncfft = cfg->ncfft;
+    ne10_float32_t scale = 2.0f * cfg->backward_scale;
+
+    const ne10_fft_kernels_float32_t *kernels = ne10_fft_kernels ();
+
+    // Bins 0 .. ncfft - 1 fill tmpbuf2; the Nyquist bin only enters the DC merge below
+    kernels->cvt_float16_float32 ( (ne10_float32_t*) tmpbuf2, fin, 2 * ncfft);
+    kernels->cvt_float16_float32 ( (ne10_float32_t*) &nyquist, fin + 2 * ncfft, 2);
+
+    tmpbuf1[0].r = (tmpbuf2[0].r + nyquist.r) * 0.5f;
+    tmpbuf1[0].i = (tmpbuf2[0].r - nyquist.r) * 0.5f;
+    kernels->split_c2r (tmpbuf1, tmpbuf2, cfg->super_twiddles, ncfft);
+    if (cfg->factors[2 * cfg->factors[0] + 2] == NE10_FFT_ALG_ANY)
+    {
+        ne10_mixed_radix_generic_butterfly_c<ne10_fft_cpx_float32_t, true> (tmpbuf2, tmpbuf1,
+                cfg->factors, cfg->twiddles, tmpbuf1, scale);
+    }
+    else
+    {
+        kernels->butterfly_inverse (tmpbuf2, tmpbuf1, cfg->factors, cfg->twiddles, tmpbuf1, scale);
+    }
+    kernels->cvt_float32_float16 (fout, (ne10_float32_t*) tmpbuf2, 2 * ncfft);
+}
+
+static const ne10_fft_lanes_kernels_float32_t* ne10_fft_find_lanes_float32 (ne10_fft_r2c_cfg_float32_t cfg,
+        ne10_int32_t lanes)
+{
+    const ne10_fft_kernels_float32_t *kernels = ne10_fft_kernels ();
+    ne10_int32_t i;
+
+    // The across-channel kernels reuse the power-of-two butterflies, whose first stage is radix 4 or 8
+    if (cfg->ncfft < 4 || cfg->factors[2 * cfg->factors[0] + 2] == NE10_FFT_ALG_ANY)
+    {
+        return NULL;
+    }
+    for (i = 0; i < NE10_FFT_LANES_KERNELS && kernels->lanes[i].lanes > 0; i++)
+    {
+        if (kernels->lanes[i].lanes == lanes)
+        {
+            return &kernels->lanes[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @ingroup R2C_FFT_IFFT
+ * @brief Chooses how many channels @ref ne10_fft_r2c_1d_lanes_float32_c should transform per call.
+ *
+ * @param[in]   cfg              configuration of the transform
+ * @param[in]   channels         number of channels to transform
+ * @retval      the widest across-channel kernel that is not wider than 'channels', or 1 if there
+ *              is none for this length and instruction set
+ *
+ * The across-channel kernels need no shuffles, but keep ncfft * lanes complex values in flight.
+ * Past roughly 2048 of them the data leaves the L1 cache, and for channels that are already
+ * planar the single-channel kernels become faster than transposing into lanes.
+ */
+ne10_int32_t ne10_fft_r2c_lanes_float32 (ne10_fft_r2c_cfg_float32_t cfg, ne10_int32_t channels)
+{
+    const ne10_fft_kernels_float32_t *kernels = ne10_fft_kernels ();
+    ne10_int32_t i;
+
+    if (ne10_fft_find_lanes_float32 (cfg, kernels->lanes[0].lanes) == NULL)
+    {
+        return 1;
+    }
+    for (i = 0; i < NE10_FFT_LANES_KERNELS && kernels->lanes[i].lanes > 0; i++)
+    {
+        if (kernels->lanes[i].lanes <= channels)
+        {
+            return kernels->lanes[i].lanes;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @ingroup R2C_FFT_IFFT
+ * @brief Real-to-complex FFT of several channels at once.
+ *
+ * @param[out]  fout             ncfft + 1 bins, each as 'lanes' real parts followed by 'lanes'
+ *                               imaginary parts
+ * @param[in]   fin              'lanes' sample-interleaved input channels (fin[t * lanes + l])
+ * @param[in]   lanes            1, or a width returned by @ref ne10_fft_r2c_lanes_float32
+ * @param[in]   cfg              configuration of the transform
+ * @param[in]   buffer           scratch of 2 * ncfft * lanes complex values
+ * @retval      NE10_OK, or NE10_ERR if 'lanes' is not supported for this configuration
+ *
+ * One pass runs all channels through the same butterflies with one channel per SIMD lane, so
+ * every twiddle is loaded once per pass and no shuffles are needed. With lanes = 1 this is
+ * @ref ne10_fft_r2c_1d_float32_c.
+ */
+ne10_result_t ne10_fft_r2c_1d_lanes_float32_c (ne10_float32_t *fout,
+        ne10_float32_t *fin,
+        ne10_int32_t lanes,
+        ne10_fft_r2c_cfg_float32_t cfg,
+        ne10_fft_cpx_float32_t *buffer)
+{
+    const ne10_fft_lanes_kernels_float32_t *kernel;
+
+    if (lanes == 1)
+    {
+        ne10_fft_r2c_1d_float32_c ( (ne10_fft_cpx_float32_t*) fout, fin, cfg);
+        return NE10_OK;
+    }
+    kernel = ne10_fft_find_lanes_float32 (cfg, lanes);
+    if (kernel == NULL)
+    {
+        return NE10_ERR;
+    }
+    kernel->r2c (fout, fin, cfg->factors, cfg->twiddles, cfg->super_twiddles, cfg->ncfft, buffer,
+                 cfg->forward_scale);
+    return NE10_OK;
+}
+
+/**
+ * @ingroup R2C_FFT_IFFT
+ * @brief Complex-to-real IFFT of several channels at once, the inverse of @ref ne10_fft_r2c_1d_lanes_float32_c.
+ *
+ * Input and output use the layouts of @ref ne10_fft_r2c_1d_lanes_float32_c, swapped. The output is
+ * scaled by cfg->backward_scale like @ref ne10_fft_c2r_1d_float32_c. 'fin' is not modified.
+ */
+ne10_result_t ne10_fft_c2r_1d_lanes_float32_c (ne10_float32_t *fout,
+        ne10_float32_t *fin,
+        ne10_int32_t lanes,
+        ne10_fft_r2c_cfg_float32_t cfg,
+        ne10_fft_cpx_float32_t *buffer)
+{
+    const ne10_fft_lanes_kernels_float32_t *kernel;
+
+    if (lanes == 1)
+    {
+        ne10_fft_c2r_1d_float32_c (fout, (ne10_fft_cpx_float32_t*) fin, cfg);
+        return NE10_OK;
+    }
+    kernel = ne10_fft_find_lanes_float32 (cfg, lanes);
+    if (kernel == NULL)
+    {
+        return NE10_ERR;
+    }
+    kernel->c2r (fout, fin, cfg->factors, cfg->twiddles, cfg->super_twiddles, cfg->ncfft, buffer,
+                 2.0f * cfg->backward_scale);
+    return NE10_OK;
+}
+
+/**
+ * @brief Transposes a rows x cols matrix of floats: dst[c * dst_stride + r] = src[r * src_stride + c].
+ *
+ * Converts between planar and interleaved channels for the batched transforms, with the
+ * vector width of the FFT kernels in use. Strides may be negative.
+ */
+void ne10_transpose_float32 (ne10_float32_t *dst,
+        ne10_int32_t dst_stride,
+        const ne10_float32_t *src,
+        ne10_int32_t src_stride,
+        ne10_int32_t rows,
+        ne10_int32_t cols)
+{
+    ne10_fft_kernels ()->transpose (dst, dst_stride, src, src_stride, rows, cols);
+}
+
+/**
+ * @ingroup C2C_FFT_IFFT
+ * @brief Creates a configuration structure for @ref ne10_fft_c2c_1d_float32_c.
+ *
+ * @param[in]   nfft             input length
+ * @retval      st               pointer to an FFT configuration structure (allocated with `malloc`), or `NULL` to indicate an error
+ *
+ * Allocates and initialises an @ref ne10_fft_cfg_float32_t configuration structure for the FP32
+ * complex-to-complex FFT/IFFT: the factors, the twiddle table and a scratch buffer. Any nfft >= 1
+ * is supported; like the real transforms, power-of-two lengths use the vectorised kernels.
+ *
+ * The forward transform is unscaled and the backward one is scaled by 1 / nfft (unless
+ * NE10_DSP_CFFT_SCALING is undefined). Change is_forward_scaled / is_backward_scaled of the
+ * returned structure to select otherwise.
+ *
+ * To free the returned structure, call @ref ne10_fft_destroy_c2c_float32.
+ */
+ne10_fft_cfg_float32_t ne10_fft_alloc_c2c_float32 (ne10_int32_t nfft)
+{
+    ne10_fft_cfg_float32_t st = NULL;
+
+    if (nfft <= 0)
+    {
+        return NULL;
+    }
+
+    ne10_uint32_t memneeded = sizeof (ne10_fft_state_float32_t)
+                              + sizeof (ne10_int32_t) * (NE10_MAXFACTORS * 2)        /* factors */
+                              + sizeof (ne10_fft_cpx_float32_t) * nfft               /* twiddle */
+                              + sizeof (ne10_fft_cpx_float32_t) * nfft * 2            /* buffer */
+                              + NE10_FFT_BYTE_ALIGNMENT;                    /* 64-bit alignment */
+
+    st = (ne10_fft_cfg_float32_t) NE10_MALLOC (memneeded);
+
+    if (st)
+    {
+        uintptr_t address = (uintptr_t) st + sizeof (ne10_fft_state_float32_t);
+        NE10_BYTE_ALIGNMENT (address, NE10_FFT_BYTE_ALIGNMENT);
+        st->factors = (ne10_int32_t*) address;
+        st->twiddles = (ne10_fft_cpx_float32_t*) (st->factors + (NE10_MAXFACTORS * 2));
+        st->buffer = st->twiddles + nfft;
+        st->last_twiddles = NULL;
+        st->nfft = nfft;
+        st->is_forward_scaled = 0;
+#ifdef NE10_DSP_CFFT_SCALING
+        st->is_backward_scaled = 1;
+#else
+        st->is_backward_scaled = 0;
+#endif
+
+        if (ne10_fft_c2c_init_tables_c (nfft, st->factors, st->twiddles, NE10_FACTOR_EIGHT_FIRST_STAGE) == NE10_ERR)
+        {
+            NE10_FREE (st);
+            return NULL;
+        }
+    }
+
+    return st;
+}
+
+/**
+ * @ingroup C2C_FFT_IFFT
+ * @brief Creates a configuration structure whose factor and twiddle tables are shared.
+ *
+ * @param[in]   nfft             input length
+ * @retval      st               pointer to an FFT configuration structure, or `NULL` to indicate an error
+ *
+ * Behaves like @ref ne10_fft_alloc_c2c_float32, but the tables live in the process-wide cache
+ * used by @ref ne10_fft_alloc_r2c_shared_float32: a complex transform of nfft points uses
+ * exactly the tables of a real transform of 2 * nfft points, so the two share one entry.
+ *
+ * Free the returned structure with @ref ne10_fft_destroy_c2c_float32 as usual.
+ */
+ne10_fft_cfg_float32_t ne10_fft_alloc_c2c_shared_float32 (ne10_int32_t nfft)
+{
+    ne10_fft_cfg_float32_t st = NULL;
+    ne10_fft_table_float32_t *table = NULL;
+
+    if ((nfft <= 0) || (nfft > INT32_MAX / 2))
+    {
+        return NULL;
+    }
+
+    table = ne10_fft_get_r2c_table_float32 (nfft * 2);
+    if (table == NULL)
+    {
+        return NULL;
+    }
+
+    ne10_uint32_t memneeded = sizeof (ne10_fft_state_float32_t)
+                              + sizeof (ne10_fft_cpx_float32_t) * nfft * 2            /* buffer */
+                              + NE10_FFT_BYTE_ALIGNMENT;                    /* 64-bit alignment */
+
+    st = (ne10_fft_cfg_float32_t) NE10_MALLOC (memneeded);
+
+    if (st)
+    {
+        uintptr_t address = (uintptr_t) st + sizeof (ne10_fft_state_float32_t);
+        NE10_BYTE_ALIGNMENT (address, NE10_FFT_BYTE_ALIGNMENT);
+        st->buffer = (ne10_fft_cpx_float32_t*) address;
+        st->last_twiddles = NULL;
+        st->nfft = nfft;
+        st->factors = table->factors;
+        st->twiddles = table->twiddles;
+        st->is_forward_scaled = 0;
+#ifdef NE10_DSP_CFFT_SCALING
+        st->is_backward_scaled = 1;
+#else
+        st->is_backward_scaled = 0;
+#endif
+    }
+
+    return st;
+}
+
+/**
+ * @ingroup C2C_FFT_IFFT
+ * @brief Complex-to-complex FFT (inverse_fft = 0) or IFFT (inverse_fft = 1).
+ *
+ * @param[out]  fout             output, nfft complex values
+ * @param[in]   fin              input, nfft complex values; may be the same as fout
+ * @param[in]   cfg              configuration from @ref ne10_fft_alloc_c2c_float32 or
+ *                               @ref ne10_fft_alloc_c2c_shared_float32
+ * @param[in]   inverse_fft      selects the direction
+ *
+ * The output is scaled by 1 / nfft if is_forward_scaled (forward) or is_backward_scaled
+ * (backward) of cfg is set. Uses the same run-time selected kernels as the real transforms.
+ */
+void ne10_fft_c2c_1d_float32_c (ne10_fft_cpx_float32_t *fout,
+                                ne10_fft_cpx_float32_t *fin,
+                                ne10_fft_cfg_float32_t cfg,
+                                ne10_int32_t inverse_fft)
+{
+    const ne10_fft_kernels_float32_t *kernels = ne10_fft_kernels ();
+    ne10_int32_t scaled = inverse_fft ? cfg->is_backward_scaled : cfg->is_forward_scaled;
+    ne10_float32_t scale = scaled ? (1.0f / cfg->nfft) : 1.0f;
+
+    // The first stage writes fout while it is still reading fin
+    if (fout == fin)
+    {
+        memcpy (cfg->buffer + cfg->nfft, fin, sizeof (ne10_fft_cpx_float32_t) * cfg->nfft);
+        fin = cfg->buffer + cfg->nfft;
+    }
+
+    // The vectorised butterflies only handle power-of-two lengths
+    if (cfg->factors[2 * cfg->factors[0] + 2] == NE10_FFT_ALG_ANY)
+    {
+        if (inverse_fft)
+        {
+            ne10_mixed_radix_generic_butterfly_c<ne10_fft_cpx_float32_t, true> (fout, fin, cfg->factors, cfg->twiddles,
+                    cfg->buffer, scale);
+        }
+        else
+        {
+            ne10_mixed_radix_generic_butterfly_c<ne10_fft_cpx_float32_t, false> (fout, fin, cfg->factors, cfg->twiddles,
+                    cfg->buffer, scale);
+        }
+    }
+    else if (inverse_fft)
+    {
+        kernels->butterfly_inverse (fout, fin, cfg->factors, cfg->twiddles, cfg->buffer, scale);
+    }
+    else
+    {
+        kernels->butterfly (fout, fin, cfg->factors, cfg->twiddles, cfg->buffer, scale);
+    }
+}
+
+/**
+ * @ingroup C2C_FFT_IFFT
+ * @brief Frees a configuration structure allocated by @ref ne10_fft_alloc_c2c_float32 or
+ * @ref ne10_fft_alloc_c2c_shared_float32.
+ */
+void ne10_fft_destroy_c2c_float32 (ne10_fft_cfg_float32_t cfg)
+{
+    free (cfg);
 }
 
 void ne10_fft_destory_r2c_float32(ne10_fft_r2c_cfg_float32_t cfg)
@@ -0,0 +1,45 @@
+/*
+ * NE10 Library : dsp/NE10_fft_float32_avx2.cpp
+ *
+ * AVX2/FMA instantiation of the FFT kernels in NE10_fft_simd.h (four complex values per
+ * register). Built with -mavx2 -mfma -mf16c; only selected when the CPU supports all three.
+ */
+#include "../Include/NE10_fft_simd.h"
+
+#if defined(NE10_FFT_HAVE_AVX2)
+
+namespace
+{
+
+const ne10_fft_kernels_float32_t s_kernels_avx2 =
+{
+    NE10_FFT_ISA_AVX2,
+    ne10_fft_mixed_radix_butterfly<ne10_fft_avx2_traits, false>,
+    ne10_fft_mixed_radix_butterfly<ne10_fft_avx2_traits, true>,
+    ne10_fft_split_r2c<ne10_fft_avx2_traits>,
+    ne10_fft_split_c2r<ne10_fft_avx2_traits>,
+    ne10_fft_split_r2c_soa<ne10_fft_avx2_traits>,
+    ne10_fft_split_c2r_soa<ne10_fft_avx2_traits>,
+    {
+        { ne10_fft_avx2_ps::L, ne10_fft_lanes_r2c<ne10_fft_avx2_ps>, ne10_fft_lanes_c2r<ne10_fft_avx2_ps> },
+    },
+    ne10_transpose<ne10_fft_avx2_ps>,
+    ne10_cvt_float16_float32<ne10_fft_avx2_ps>,
+    ne10_cvt_float32_float16<ne10_fft_avx2_ps>,
+};
+
+} // namespace
+
+const ne10_fft_kernels_float32_t* ne10_fft_kernels_avx2_float32 (void)
+{
+    return &s_kernels_avx2;
+}
+
+#else
+
+const ne10_fft_kernels_float32_t* ne10_fft_kernels_avx2_float32 (void)
+{
+    return NULL;
+}
+
+#endif
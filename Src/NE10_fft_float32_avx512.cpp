@@ -0,0 +1,47 @@
+/*
+ * NE10 Library : dsp/NE10_fft_float32_avx512.cpp
+ *
+ * AVX-512F instantiation of the FFT kernels in NE10_fft_simd.h (eight complex values per
+ * register). Built with -mavx512f (plus the AVX2, FMA and F16C flags of the narrower lane
+ * kernels it reuses); only selected when the CPU and OS support it.
+ */
+#include "../Include/NE10_fft_simd.h"
+
+#if defined(NE10_FFT_HAVE_AVX512)
+
+namespace
+{
+
+const ne10_fft_kernels_float32_t s_kernels_avx512 =
+{
+    NE10_FFT_ISA_AVX512,
+    ne10_fft_mixed_radix_butterfly<ne10_fft_avx512_traits, false>,
+    ne10_fft_mixed_radix_butterfly<ne10_fft_avx512_traits, true>,
+    ne10_fft_split_r2c<ne10_fft_avx512_traits>,
+    ne10_fft_split_c2r<ne10_fft_avx512_traits>,
+    ne10_fft_split_r2c_soa<ne10_fft_avx512_traits>,
+    ne10_fft_split_c2r_soa<ne10_fft_avx512_traits>,
+    {
+        { ne10_fft_avx512_ps::L, ne10_fft_lanes_r2c<ne10_fft_avx512_ps>, ne10_fft_lanes_c2r<ne10_fft_avx512_ps> },
+        { ne10_fft_avx2_ps::L, ne10_fft_lanes_r2c<ne10_fft_avx2_ps>, ne10_fft_lanes_c2r<ne10_fft_avx2_ps> },
+    },
+    ne10_transpose<ne10_fft_avx2_ps>,
+    ne10_cvt_float16_float32<ne10_fft_avx512_ps>,
+    ne10_cvt_float32_float16<ne10_fft_avx512_ps>,
+};
+
+} // namespace
+
+const ne10_fft_kernels_float32_t* ne10_fft_kernels_avx512_float32 (void)
+{
+    return &s_kernels_avx512;
+}
+
+#else
+
+const ne10_fft_kernels_float32_t* ne10_fft_kernels_avx512_float32 (void)
+{
+    return NULL;
+}
+
+#endif
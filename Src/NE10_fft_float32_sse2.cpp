@@ -0,0 +1,44 @@
+/*
+ * NE10 Library : dsp/NE10_fft_float32_sse2.cpp
+ *
+ * SSE2 instantiation of the FFT kernels in NE10_fft_simd.h (two complex values per register).
+ */
+#include "../Include/NE10_fft_simd.h"
+
+#if defined(NE10_FFT_HAVE_SSE2)
+
+namespace
+{
+
+const ne10_fft_kernels_float32_t s_kernels_sse2 =
+{
+    NE10_FFT_ISA_SSE2,
+    ne10_fft_mixed_radix_butterfly<ne10_fft_sse2_traits, false>,
+    ne10_fft_mixed_radix_butterfly<ne10_fft_sse2_traits, true>,
+    ne10_fft_split_r2c<ne10_fft_sse2_traits>,
+    ne10_fft_split_c2r<ne10_fft_sse2_traits>,
+    ne10_fft_split_r2c_soa<ne10_fft_sse2_traits>,
+    ne10_fft_split_c2r_soa<ne10_fft_sse2_traits>,
+    {
+        { ne10_fft_sse2_ps::L, ne10_fft_lanes_r2c<ne10_fft_sse2_ps>, ne10_fft_lanes_c2r<ne10_fft_sse2_ps> },
+    },
+    ne10_transpose<ne10_fft_sse2_ps>,
+    ne10_cvt_float16_float32_c,
+    ne10_cvt_float32_float16_c,
+};
+
+} // namespace
+
+const ne10_fft_kernels_float32_t* ne10_fft_kernels_sse2_float32 (void)
+{
+    return &s_kernels_sse2;
+}
+
+#else
+
+const ne10_fft_kernels_float32_t* ne10_fft_kernels_sse2_float32 (void)
+{
+    return NULL;
+}
+
+#endif
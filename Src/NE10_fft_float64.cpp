@@ -0,0 +1,122 @@
+/*
+ * NE10 Library : dsp/NE10_fft_float64.cpp
+ *
+ * Double precision real-to-complex and complex-to-real FFT. Uses the same factoring,
+ * table layout and butterflies as the FP32 transforms (see NE10_fft_generic.h), in portable
+ * C only: it is meant for reference and for accumulations where FP32 round-off matters,
+ * not for the real-time paths.
+ */
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "../Include/NE10_fft.h"
+#include "../Include/NE10_fft_generic.h"
+
+/**
+ * @ingroup R2C_FFT_IFFT
+ * @brief Creates a configuration structure for @ref ne10_fft_r2c_1d_float64_c and @ref ne10_fft_c2r_1d_float64_c.
+ *
+ * @param[in]   nfft             input length, any even number >= 2
+ * @retval      st               pointer to an FFT configuration structure (allocated with `malloc`), or `NULL` to indicate an error
+ *
+ * The scale fields default to the ones of @ref ne10_fft_alloc_r2c_float32. To free the
+ * returned structure, call @ref ne10_fft_destroy_r2c_float64.
+ */
+ne10_fft_r2c_cfg_float64_t ne10_fft_alloc_r2c_float64 (ne10_int32_t nfft)
+{
+    ne10_fft_r2c_cfg_float64_t st = NULL;
+    ne10_int32_t ncfft = nfft >> 1;
+
+    if ((ncfft <= 0) || (nfft & 1))
+    {
+        return NULL;
+    }
+
+    size_t memneeded = sizeof (ne10_fft_r2c_state_float64_t)
+                       + sizeof (ne10_int32_t) * (NE10_MAXFACTORS * 2)        /* factors */
+                       + sizeof (ne10_fft_cpx_float64_t) * ncfft              /* twiddle */
+                       + sizeof (ne10_fft_cpx_float64_t) * (ncfft / 2) /* super twiddles */
+                       + sizeof (ne10_fft_cpx_float64_t) * nfft                /* buffer */
+                       + NE10_FFT_BYTE_ALIGNMENT;                    /* 64-bit alignment */
+
+    st = (ne10_fft_r2c_cfg_float64_t) NE10_MALLOC (memneeded);
+
+    if (st)
+    {
+        uintptr_t address = (uintptr_t) st + sizeof (ne10_fft_r2c_state_float64_t);
+        NE10_BYTE_ALIGNMENT (address, NE10_FFT_BYTE_ALIGNMENT);
+        st->factors = (ne10_int32_t*) address;
+        st->twiddles = (ne10_fft_cpx_float64_t*) (st->factors + (NE10_MAXFACTORS * 2));
+        st->super_twiddles = st->twiddles + ncfft;
+        st->buffer = st->super_twiddles + (ncfft / 2);
+        st->ncfft = ncfft;
+        st->forward_scale = 1.0;
+#ifdef NE10_DSP_RFFT_SCALING
+        st->backward_scale = 1.0 / nfft;
+#else
+        st->backward_scale = 1.0;
+#endif
+
+        // No radix-8 stage: the generic butterflies only implement radix 2, 3, 4 and 5
+        if (ne10_fft_r2c_init_tables_c (ncfft, st->factors, st->twiddles, st->super_twiddles, NE10_FACTOR_DEFAULT) == NE10_ERR)
+        {
+            NE10_FREE (st);
+            return NULL;
+        }
+    }
+
+    return st;
+}
+
+/**
+ * @ingroup R2C_FFT_IFFT
+ * @brief Double precision counterpart of @ref ne10_fft_r2c_1d_float32_c.
+ *
+ * fout receives ncfft + 1 bins and may be fin (which then needs room for them). The output
+ * is multiplied by cfg->forward_scale.
+ */
+void ne10_fft_r2c_1d_float64_c (ne10_fft_cpx_float64_t *fout,
+                                ne10_float64_t *fin,
+                                ne10_fft_r2c_cfg_float64_t cfg)
+{
+    ne10_fft_cpx_float64_t * tmpbuf = cfg->buffer;
+    ne10_fft_cpx_float64_t tdc;
+
+    ne10_mixed_radix_generic_butterfly_c<ne10_fft_cpx_float64_t, false> (tmpbuf, (ne10_fft_cpx_float64_t*) fin,
+            cfg->factors, cfg->twiddles, fout, cfg->forward_scale);
+    ne10_fft_split_r2c_c (fout, tmpbuf, cfg->super_twiddles, cfg->ncfft);
+
+    tdc = tmpbuf[0];
+    fout[0].r = tdc.r + tdc.i;
+    fout[0].i = 0;
+    fout[cfg->ncfft].r = tdc.r - tdc.i;
+    fout[cfg->ncfft].i = 0;
+}
+
+/**
+ * @ingroup R2C_FFT_IFFT
+ * @brief Double precision counterpart of @ref ne10_fft_c2r_1d_float32_c.
+ *
+ * The output is multiplied by cfg->backward_scale relative to an unscaled inverse; fout may be fin.
+ */
+void ne10_fft_c2r_1d_float64_c (ne10_float64_t *fout,
+                                ne10_fft_cpx_float64_t *fin,
+                                ne10_fft_r2c_cfg_float64_t cfg)
+{
+    ne10_fft_cpx_float64_t * tmpbuf1 = cfg->buffer;
+    ne10_fft_cpx_float64_t * tmpbuf2 = cfg->buffer + cfg->ncfft;
+    ne10_float64_t dc = fin[0].r;
+    ne10_float64_t nyquist = fin[cfg->ncfft].r;
+
+    tmpbuf1[0].r = (dc + nyquist) * 0.5;
+    tmpbuf1[0].i = (dc - nyquist) * 0.5;
+    ne10_fft_split_c2r_c (tmpbuf1, fin, cfg->super_twiddles, cfg->ncfft);
+    // A complex IFFT of ncfft points yields ncfft / nfft = 1 / 2 of the unscaled real inverse
+    ne10_mixed_radix_generic_butterfly_c<ne10_fft_cpx_float64_t, true> ( (ne10_fft_cpx_float64_t*) fout, tmpbuf1,
+            cfg->factors, cfg->twiddles, tmpbuf2, 2.0 * cfg->backward_scale);
+}
+
+void ne10_fft_destroy_r2c_float64 (ne10_fft_r2c_cfg_float64_t cfg)
+{
+    free (cfg);
+}
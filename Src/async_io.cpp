@@ -0,0 +1,337 @@
+#include <stdlib.h>
+#include <stddef.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+#include "../Include/async_io.h"
+
+typedef unsigned long long TBlockCount;
+
+/*
+ * Each ring is a pair of running block counts: head is advanced by its producer once a
+ * block is complete, tail by its consumer once the block is free again, and a block's
+ * slot is its count modulo the ring depth. The counts are 64-bit, so they never wrap.
+ *
+ * A side that finds nothing to do parks on its condition variable after raising its
+ * parked flag under the mutex and re-checking; the other side publishes with a
+ * sequentially consistent store and only takes the mutex to notify when it sees the
+ * flag, so a running ring costs no lock and no system call per block.
+ */
+struct _TAsyncIO
+{
+	TAsyncIOConfig config;
+	unsigned char* in_blocks;
+	unsigned char* out_blocks;
+	int* in_frames; // frames in each input slot
+	int* out_frames;
+	size_t in_block_bytes;
+	size_t out_block_bytes;
+	std::atomic<TBlockCount> in_head; // input blocks read by the I/O thread
+	std::atomic<TBlockCount> in_tail; // input blocks released by the processing thread
+	std::atomic<TBlockCount> out_head; // output blocks committed by the processing thread
+	std::atomic<TBlockCount> out_tail; // output blocks written by the I/O thread
+	std::atomic<bool> in_end; // the last input block has been published
+	std::atomic<bool> stop;
+	std::atomic<bool> io_parked;
+	std::atomic<bool> proc_parked;
+	std::mutex park_mutex;
+	std::condition_variable io_cv;
+	std::condition_variable proc_cv;
+	std::thread thread;
+
+	std::atomic<long long> blocks_read;
+	std::atomic<long long> blocks_written;
+	std::atomic<long long> input_stalls;
+	std::atomic<long long> output_stalls;
+	std::atomic<long long> input_stall_ns;
+	std::atomic<long long> output_stall_ns;
+	std::atomic<long long> read_ns;
+	std::atomic<long long> write_ns;
+	std::atomic<int> error;
+};
+
+static inline long long elapsed_ns(const std::chrono::steady_clock::time_point& start)
+{
+	return (long long)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <class TReady>
+static void park(TAsyncIO* io, std::condition_variable& cv, std::atomic<bool>& parked, TReady ready)
+{
+	std::unique_lock<std::mutex> lock(io->park_mutex);
+	parked.store(true);
+	while (!ready())
+	{
+		cv.wait(lock);
+	}
+	parked.store(false);
+}
+
+static inline void wake(TAsyncIO* io, std::condition_variable& cv, std::atomic<bool>& parked)
+{
+	if (parked.load()) {
+		std::lock_guard<std::mutex> guard(io->park_mutex);
+		cv.notify_one();
+	}
+}
+
+static inline bool input_room(TAsyncIO* io)
+{
+	return NULL != io->config.read && !io->in_end.load() && !io->stop.load()
+		&& io->in_head.load(std::memory_order_relaxed) - io->in_tail.load() < (TBlockCount)io->config.blocks;
+}
+
+static inline bool output_pending(TAsyncIO* io)
+{
+	return io->out_tail.load(std::memory_order_relaxed) != io->out_head.load();
+}
+
+static void read_block(TAsyncIO* io)
+{
+	const TBlockCount head = io->in_head.load(std::memory_order_relaxed);
+	const size_t slot = (size_t)(head % (TBlockCount)io->config.blocks);
+	int frames = -1;
+
+	if (0 == io->error.load(std::memory_order_relaxed)) {
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		frames = io->config.read(io->config.read_user, io->in_blocks + slot * io->in_block_bytes, io->config.block_frames);
+		io->read_ns.fetch_add(elapsed_ns(start), std::memory_order_relaxed);
+	}
+	if (frames < 0) {
+		io->error.store(1, std::memory_order_relaxed);
+		frames = 0;
+	}
+	frames = (frames < io->config.block_frames) ? frames : io->config.block_frames;
+	if (frames > 0) {
+		io->in_frames[slot] = frames;
+		io->in_head.store(head + 1);
+		io->blocks_read.fetch_add(1, std::memory_order_relaxed);
+	}
+	if (frames < io->config.block_frames) {
+		io->in_end.store(true);
+	}
+	wake(io, io->proc_cv, io->proc_parked);
+}
+
+static void write_block(TAsyncIO* io)
+{
+	const TBlockCount tail = io->out_tail.load(std::memory_order_relaxed);
+	const size_t slot = (size_t)(tail % (TBlockCount)io->config.blocks);
+
+	// After a failure the blocks are still consumed, so the processing thread never blocks on them
+	if (0 == io->error.load(std::memory_order_relaxed)) {
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		const int written = io->config.write(io->config.write_user, io->out_blocks + slot * io->out_block_bytes, io->out_frames[slot]);
+		io->write_ns.fetch_add(elapsed_ns(start), std::memory_order_relaxed);
+		if (written != io->out_frames[slot]) {
+			io->error.store(1, std::memory_order_relaxed);
+		}
+		io->blocks_written.fetch_add(1, std::memory_order_relaxed);
+	}
+	io->out_tail.store(tail + 1);
+	wake(io, io->proc_cv, io->proc_parked);
+}
+
+static void io_main(TAsyncIO* io)
+{
+	for (;;)
+	{
+		// Output goes first: a full output ring is what holds the processing thread back
+		const bool writing = output_pending(io);
+		if (writing) {
+			write_block(io);
+		}
+		const bool reading = input_room(io);
+		if (reading) {
+			read_block(io);
+		}
+		if (writing || reading) {
+			continue;
+		}
+		if (io->stop.load() && !output_pending(io)) {
+			return;
+		}
+		park(io, io->io_cv, io->io_parked, [io]() {
+			return output_pending(io) || input_room(io) || io->stop.load();
+		});
+	}
+}
+
+static void free_async_io(TAsyncIO* io)
+{
+	free(io->in_blocks);
+	free(io->out_blocks);
+	free(io->in_frames);
+	free(io->out_frames);
+	delete io;
+}
+
+TAsyncIO* Create_async_io(const TAsyncIOConfig* config)
+{
+	if (NULL == config || config->block_frames <= 0 || config->blocks < 2
+		|| (NULL != config->read && config->in_frame_bytes <= 0)
+		|| (NULL != config->write && config->out_frame_bytes <= 0)) {
+		return NULL;
+	}
+	TAsyncIO* io = new (std::nothrow) TAsyncIO;
+	if (NULL == io) {
+		return NULL;
+	}
+	io->config = *config;
+	io->in_block_bytes = (NULL != config->read) ? (size_t)config->block_frames * config->in_frame_bytes : 0;
+	io->out_block_bytes = (NULL != config->write) ? (size_t)config->block_frames * config->out_frame_bytes : 0;
+	io->in_blocks = (unsigned char*)malloc(io->in_block_bytes * config->blocks + 1);
+	io->out_blocks = (unsigned char*)malloc(io->out_block_bytes * config->blocks + 1);
+	io->in_frames = (int*)calloc(config->blocks, sizeof(int));
+	io->out_frames = (int*)calloc(config->blocks, sizeof(int));
+	if (NULL == io->in_blocks || NULL == io->out_blocks || NULL == io->in_frames || NULL == io->out_frames) {
+		free_async_io(io);
+		return NULL;
+	}
+
+	io->in_head.store(0);
+	io->in_tail.store(0);
+	io->out_head.store(0);
+	io->out_tail.store(0);
+	io->in_end.store(NULL == config->read);
+	io->stop.store(false);
+	io->io_parked.store(false);
+	io->proc_parked.store(false);
+	io->blocks_read.store(0);
+	io->blocks_written.store(0);
+	io->input_stalls.store(0);
+	io->output_stalls.store(0);
+	io->input_stall_ns.store(0);
+	io->output_stall_ns.store(0);
+	io->read_ns.store(0);
+	io->write_ns.store(0);
+	io->error.store(0);
+
+	try {
+		io->thread = std::thread(io_main, io);
+	}
+	catch (...) {
+		free_async_io(io);
+		return NULL;
+	}
+	return io;
+}
+
+void Destroy_async_io(TAsyncIO* io)
+{
+	if (NULL == io) {
+		return;
+	}
+	io->stop.store(true);
+	{
+		std::lock_guard<std::mutex> guard(io->park_mutex);
+		io->io_cv.notify_one();
+	}
+	io->thread.join();
+	free_async_io(io);
+}
+
+int Get_async_input(TAsyncIO* io, const void** frames)
+{
+	if (NULL != frames) {
+		*frames = NULL;
+	}
+	if (NULL == io || NULL == io->config.read) {
+		return 0;
+	}
+	const TBlockCount tail = io->in_tail.load(std::memory_order_relaxed);
+	if (tail == io->in_head.load() && !io->in_end.load()) {
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		park(io, io->proc_cv, io->proc_parked, [io, tail]() {
+			return tail != io->in_head.load() || io->in_end.load();
+		});
+		io->input_stalls.fetch_add(1, std::memory_order_relaxed);
+		io->input_stall_ns.fetch_add(elapsed_ns(start), std::memory_order_relaxed);
+	}
+	// in_end is raised after the last head update, so an empty ring now means the end
+	if (tail == io->in_head.load()) {
+		return 0;
+	}
+	const size_t slot = (size_t)(tail % (TBlockCount)io->config.blocks);
+	if (NULL != frames) {
+		*frames = io->in_blocks + slot * io->in_block_bytes;
+	}
+	return io->in_frames[slot];
+}
+
+void Release_async_input(TAsyncIO* io)
+{
+	if (NULL == io) {
+		return;
+	}
+	const TBlockCount tail = io->in_tail.load(std::memory_order_relaxed);
+	if (tail != io->in_head.load()) {
+		io->in_tail.store(tail + 1);
+		wake(io, io->io_cv, io->io_parked);
+	}
+}
+
+void* Get_async_output(TAsyncIO* io)
+{
+	if (NULL == io || NULL == io->config.write) {
+		return NULL;
+	}
+	const TBlockCount head = io->out_head.load(std::memory_order_relaxed);
+	const TBlockCount blocks = (TBlockCount)io->config.blocks;
+	if (head - io->out_tail.load() >= blocks) {
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		park(io, io->proc_cv, io->proc_parked, [io, head, blocks]() {
+			return head - io->out_tail.load() < blocks;
+		});
+		io->output_stalls.fetch_add(1, std::memory_order_relaxed);
+		io->output_stall_ns.fetch_add(elapsed_ns(start), std::memory_order_relaxed);
+	}
+	return io->out_blocks + (size_t)(head % blocks) * io->out_block_bytes;
+}
+
+void Commit_async_output(TAsyncIO* io, const int frame_count)
+{
+	if (NULL == io || NULL == io->config.write || frame_count <= 0) {
+		return;
+	}
+	const TBlockCount head = io->out_head.load(std::memory_order_relaxed);
+	io->out_frames[head % (TBlockCount)io->config.blocks] = (frame_count < io->config.block_frames) ? frame_count : io->config.block_frames;
+	io->out_head.store(head + 1);
+	wake(io, io->io_cv, io->io_parked);
+}
+
+void Flush_async_io(TAsyncIO* io)
+{
+	if (NULL == io) {
+		return;
+	}
+	const TBlockCount head = io->out_head.load(std::memory_order_relaxed);
+	if (io->out_tail.load() != head) {
+		park(io, io->proc_cv, io->proc_parked, [io, head]() {
+			return io->out_tail.load() == head;
+		});
+	}
+}
+
+void Get_async_io_stats(TAsyncIO* io, TAsyncIOStats* stats)
+{
+	if (NULL == stats) {
+		return;
+	}
+	if (NULL == io) {
+		*stats = TAsyncIOStats();
+		return;
+	}
+	stats->blocks_read = io->blocks_read.load(std::memory_order_relaxed);
+	stats->blocks_written = io->blocks_written.load(std::memory_order_relaxed);
+	stats->input_stalls = io->input_stalls.load(std::memory_order_relaxed);
+	stats->output_stalls = io->output_stalls.load(std::memory_order_relaxed);
+	stats->input_stall_ms = io->input_stall_ns.load(std::memory_order_relaxed) * 1e-6;
+	stats->output_stall_ms = io->output_stall_ns.load(std::memory_order_relaxed) * 1e-6;
+	stats->read_ms = io->read_ns.load(std::memory_order_relaxed) * 1e-6;
+	stats->write_ms = io->write_ns.load(std::memory_order_relaxed) * 1e-6;
+	stats->error = io->error.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,353 @@
+#if defined(_MSC_VER) && !defined(_CRT_SECURE_NO_WARNINGS)
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <new>
+#include <string>
+#include <vector>
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+#include "../Include/batch.h"
+
+#define BATCH_LINE_LEN 4096
+
+struct _TBatchList
+{
+	std::vector<std::string> inputs;
+	std::vector<std::string> outputs;
+	std::vector<int> results;
+	std::vector<int> rejected; // nonzero: the entry is failed with this result instead of being processed
+};
+
+namespace
+{
+
+bool is_directory(const char* path)
+{
+#if defined(_WIN32)
+	struct _stat st;
+	return 0 == _stat(path, &st) && 0 != (st.st_mode & _S_IFDIR);
+#else
+	struct stat st;
+	return 0 == stat(path, &st) && S_ISDIR(st.st_mode);
+#endif
+}
+
+bool is_separator(const char c)
+{
+	return '/' == c || '\\' == c;
+}
+
+std::string join_path(const std::string& dir, const std::string& name)
+{
+	if (dir.empty() || is_separator(dir[dir.size() - 1])) {
+		return dir + name;
+	}
+	return dir + "/" + name;
+}
+
+std::string base_name(const std::string& path)
+{
+	size_t pos = path.size();
+	while (pos > 0 && !is_separator(path[pos - 1]))
+	{
+		pos--;
+	}
+	return path.substr(pos);
+}
+
+// Whether both paths name the same file, which writing the output would destroy while it is read
+bool is_same_file(const char* a, const char* b)
+{
+	if (0 == strcmp(a, b)) {
+		return true;
+	}
+#if defined(_WIN32)
+	char full_a[_MAX_PATH], full_b[_MAX_PATH];
+	return NULL != _fullpath(full_a, a, sizeof(full_a)) && NULL != _fullpath(full_b, b, sizeof(full_b))
+		&& 0 == _stricmp(full_a, full_b);
+#else
+	// Catches other spellings of a path, symbolic and hard links; an output that doesn't exist yet is never the input
+	struct stat st_a, st_b;
+	return 0 == stat(a, &st_a) && 0 == stat(b, &st_b) && st_a.st_dev == st_b.st_dev && st_a.st_ino == st_b.st_ino;
+#endif
+}
+
+// A spelling of an output path that is the same for every spelling of the same file
+std::string output_key(const std::string& path)
+{
+#if defined(_WIN32)
+	char full[_MAX_PATH];
+	std::string key = (NULL != _fullpath(full, path.c_str(), sizeof(full))) ? full : path;
+	for (size_t idx = 0; idx < key.size(); idx++)
+	{
+		key[idx] = ('/' == key[idx]) ? '\\' : (char)tolower((unsigned char)key[idx]);
+	}
+	return key;
+#else
+	// The file may not exist yet, but its directory has to; resolving that catches other spellings and links of it
+	const std::string name = base_name(path);
+	const std::string dir = (name.size() == path.size()) ? "." : path.substr(0, path.size() - name.size());
+	char* real = realpath(dir.c_str(), NULL);
+	if (NULL == real) {
+		return path;
+	}
+	const std::string key = join_path(real, name);
+	free(real);
+	return key;
+#endif
+}
+
+// Fails every entry that writes an output an earlier entry writes too; processed concurrently, they would tear it
+void reject_duplicate_outputs(TBatchList* list)
+{
+	std::map<std::string, int> first;
+	for (size_t idx = 0; idx < list->outputs.size(); idx++)
+	{
+		if (!first.insert(std::make_pair(output_key(list->outputs[idx]), (int)idx)).second) {
+			list->rejected[idx] = BATCH_ERROR_DUPLICATE_OUTPUT;
+		}
+	}
+}
+
+bool has_wav_extension(const char* name)
+{
+	const size_t len = strlen(name);
+	if (len < 4) {
+		return false;
+	}
+	const char* ext = name + len - 4;
+	return '.' == ext[0] && ('w' == ext[1] || 'W' == ext[1]) && ('a' == ext[2] || 'A' == ext[2]) && ('v' == ext[3] || 'V' == ext[3]);
+}
+
+bool list_directory(const char* dir, std::vector<std::string>* names)
+{
+#if defined(_WIN32)
+	WIN32_FIND_DATAA data;
+	const HANDLE find = FindFirstFileA(join_path(dir, "*").c_str(), &data);
+	if (INVALID_HANDLE_VALUE == find) {
+		return false;
+	}
+	do
+	{
+		if (0 == (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) && has_wav_extension(data.cFileName)) {
+			names->push_back(data.cFileName);
+		}
+	} while (FindNextFileA(find, &data));
+	FindClose(find);
+#else
+	DIR* handle = opendir(dir);
+	if (NULL == handle) {
+		return false;
+	}
+	for (struct dirent* entry = readdir(handle); NULL != entry; entry = readdir(handle))
+	{
+		if (has_wav_extension(entry->d_name) && !is_directory(join_path(dir, entry->d_name).c_str())) {
+			names->push_back(entry->d_name);
+		}
+	}
+	closedir(handle);
+#endif
+	// Directory order is arbitrary; sorted, a batch always runs and reports the same way
+	std::sort(names->begin(), names->end());
+	return true;
+}
+
+bool read_manifest(const char* path, const std::string& out_dir, TBatchList* list)
+{
+	FILE* file = fopen(path, "r");
+	if (NULL == file) {
+		return false;
+	}
+	char line[BATCH_LINE_LEN];
+	while (NULL != fgets(line, sizeof(line), file))
+	{
+		size_t len = strlen(line);
+		while (len > 0 && ('\n' == line[len - 1] || '\r' == line[len - 1]))
+		{
+			line[--len] = '\0';
+		}
+		if (0 == len || '#' == line[0]) {
+			continue;
+		}
+		char* tab = strchr(line, '\t');
+		if (NULL != tab) {
+			*tab = '\0';
+			list->inputs.push_back(line);
+			list->outputs.push_back(tab + 1);
+		}
+		else {
+			list->inputs.push_back(line);
+			list->outputs.push_back(join_path(out_dir, base_name(line)));
+		}
+	}
+	fclose(file);
+	return true;
+}
+
+struct TBatchRun
+{
+	TBatchList* list;
+	const TBatchWorker* worker;
+	std::atomic<int> next; // next file to claim
+	std::atomic<int> files_ok;
+	std::atomic<int> files_failed;
+	std::atomic<long long> frames;
+	std::atomic<long long> audio_us; // microseconds of audio, so the sum can be atomic
+	void** states; // one per slot
+};
+
+// One thread slot: claims files until none are left, creating its state on the first
+void run_slot(void* user, const int slot)
+{
+	TBatchRun* run = (TBatchRun*)user;
+	const TBatchWorker* worker = run->worker;
+	const int count = (int)run->list->inputs.size();
+	bool tried = false;
+
+	for (int idx = run->next.fetch_add(1); idx < count; idx = run->next.fetch_add(1))
+	{
+		if (!tried) {
+			run->states[slot] = (NULL != worker->create) ? worker->create(worker->user) : NULL;
+			tried = true;
+		}
+		int result = BATCH_ERROR_NO_STATE;
+		TBatchFileInfo info = { 0, 0, 0 };
+		if (0 != run->list->rejected[idx]) {
+			result = run->list->rejected[idx];
+		}
+		else if (is_same_file(run->list->inputs[idx].c_str(), run->list->outputs[idx].c_str())) {
+			result = BATCH_ERROR_SAME_FILE;
+		}
+		else if (NULL != run->states[slot] || NULL == worker->create) {
+			result = worker->process(worker->user, run->states[slot], run->list->inputs[idx].c_str(), run->list->outputs[idx].c_str(), &info);
+		}
+		run->list->results[idx] = result;
+		if (0 == result) {
+			run->files_ok.fetch_add(1, std::memory_order_relaxed);
+			run->frames.fetch_add(info.frames, std::memory_order_relaxed);
+			if (info.sample_rate > 0) {
+				run->audio_us.fetch_add(info.frames * 1000000 / info.sample_rate, std::memory_order_relaxed);
+			}
+		}
+		else {
+			run->files_failed.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+}
+
+} // namespace
+
+TBatchList* Create_batch_list(const char* source, const char* out_dir)
+{
+	if (NULL == source) {
+		return NULL;
+	}
+	TBatchList* list = new (std::nothrow) TBatchList;
+	if (NULL == list) {
+		return NULL;
+	}
+	const std::string out = (NULL != out_dir) ? out_dir : "";
+	bool ok = false;
+	try {
+		if (is_directory(source)) {
+			std::vector<std::string> names;
+			ok = list_directory(source, &names);
+			for (size_t idx = 0; ok && idx < names.size(); idx++)
+			{
+				list->inputs.push_back(join_path(source, names[idx]));
+				list->outputs.push_back(join_path(out, names[idx]));
+			}
+		}
+		else {
+			ok = read_manifest(source, out, list);
+		}
+		list->results.assign(list->inputs.size(), 0);
+		list->rejected.assign(list->inputs.size(), 0);
+		reject_duplicate_outputs(list);
+	}
+	catch (...) {
+		ok = false;
+	}
+	if (!ok) {
+		delete list;
+		return NULL;
+	}
+	return list;
+}
+
+void Destroy_batch_list(TBatchList* list)
+{
+	delete list;
+}
+
+int Get_batch_count(const TBatchList* list)
+{
+	return (NULL == list) ? 0 : (int)list->inputs.size();
+}
+
+const char* Get_batch_input(const TBatchList* list, const int index)
+{
+	return (index >= 0 && index < Get_batch_count(list)) ? list->inputs[index].c_str() : NULL;
+}
+
+const char* Get_batch_output(const TBatchList* list, const int index)
+{
+	return (index >= 0 && index < Get_batch_count(list)) ? list->outputs[index].c_str() : NULL;
+}
+
+int Get_batch_result(const TBatchList* list, const int index)
+{
+	return (index >= 0 && index < Get_batch_count(list)) ? list->results[index] : 0;
+}
+
+void Run_batch(TBatchList* list, TThreadPool* pool, const TBatchWorker* worker, TBatchStats* stats)
+{
+	if (NULL != stats) {
+		memset(stats, 0, sizeof(*stats));
+	}
+	if (NULL == list || NULL == worker || NULL == worker->process) {
+		return;
+	}
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	const int slots = Get_thread_pool_size(pool);
+	std::vector<void*> states(slots, (void*)NULL);
+
+	TBatchRun run;
+	run.list = list;
+	run.worker = worker;
+	run.next.store(0);
+	run.files_ok.store(0);
+	run.files_failed.store(0);
+	run.frames.store(0);
+	run.audio_us.store(0);
+	run.states = &states[0];
+	// One task per slot; each keeps claiming files, so the slots stay busy until the list runs out
+	Run_thread_pool(pool, run_slot, &run, slots);
+
+	for (int slot = 0; slot < slots; slot++)
+	{
+		if (NULL != states[slot] && NULL != worker->destroy) {
+			worker->destroy(worker->user, states[slot]);
+		}
+	}
+	if (NULL != stats) {
+		stats->files_ok = run.files_ok.load();
+		stats->files_failed = run.files_failed.load();
+		stats->frames = run.frames.load();
+		stats->audio_seconds = run.audio_us.load() * 1e-6;
+		stats->wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+}
@@ -0,0 +1,315 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../Include/convolver.h"
+
+#define CONVOLVER_MAX_STAGES 32
+#define CONVOLVER_DEFAULT_GROWTH 32
+
+/*
+ * One uniformly partitioned overlap-save stage. Spectra are kSplitComplex, so the
+ * multiply-add runs over contiguous re and im arrays of block_len + 1 bins.
+ */
+typedef struct
+{
+	int block_len;
+	int parts;
+	int spectrum_len; // 2 * block_len + 2 floats
+	int out_offset; // where the output block of this stage lands, from the output ring front
+	TFFTPlan* plan; // 2 * block_len
+	float* ir_spectra; // parts * spectrum_len
+	float* fdl; // parts * spectrum_len, input spectra, newest at fdl_head
+	float* acc; // spectrum_len
+	float* in_buf; // 2 * block_len: the previous block, then the one being filled
+	float* time; // 2 * block_len + 2
+	int fdl_head;
+	int fill;
+}TConvolverStage;
+
+struct _TConvolver
+{
+	int block_len;
+	int stage_count;
+	int part_count;
+	TConvolverStage stages[CONVOLVER_MAX_STAGES];
+	float* out_ring; // ring_len, partial sums; the front block is at out_pos
+	float* out_ready; // block_len samples completed by the last block
+	float* in_block; // block_len
+	int ring_len;
+	int out_pos;
+	int fill;
+};
+
+// ring[(pos + idx) % ring_len] += data[idx], for idx < count <= ring_len
+static void add_to_ring(float* ring, const int ring_len, int pos, const float* data, const int count)
+{
+	const int head = (count < ring_len - pos) ? count : ring_len - pos;
+	int idx = 0;
+
+	for (idx = 0; idx < head; idx++)
+	{
+		ring[pos + idx] += data[idx];
+	}
+	for (idx = head; idx < count; idx++)
+	{
+		ring[idx - head] += data[idx];
+	}
+}
+
+static int init_stage(TConvolverStage* stage, const float* ir, const int ir_len, const int offset, const int block_len, const int parts)
+{
+	const int fft_len = 2 * block_len;
+	const int spectrum_len = fft_len + 2;
+	int part = 0;
+
+	stage->block_len = block_len;
+	stage->parts = parts;
+	stage->spectrum_len = spectrum_len;
+	stage->plan = Create_fft_plan(fft_len);
+	stage->ir_spectra = (float*)malloc(sizeof(float) * ((size_t)2 * parts * spectrum_len + 2 * spectrum_len + fft_len));
+	if (NULL == stage->plan || NULL == stage->ir_spectra) {
+		return 0;
+	}
+	stage->fdl = stage->ir_spectra + (size_t)parts * spectrum_len;
+	stage->acc = stage->fdl + (size_t)parts * spectrum_len;
+	stage->time = stage->acc + spectrum_len;
+	stage->in_buf = stage->time + spectrum_len;
+
+	// Partition p holds taps [offset + p * block_len, offset + (p + 1) * block_len), zero-padded to fft_len
+	for (part = 0; part < parts; part++)
+	{
+		const int first = offset + part * block_len;
+		const int taps = (ir_len - first < block_len) ? ir_len - first : block_len;
+		memset(stage->time, 0, sizeof(float) * fft_len);
+		if (taps > 0) {
+			memcpy(stage->time, ir + first, sizeof(float) * taps);
+		}
+		Do_fftr_plan(stage->plan, stage->ir_spectra + (size_t)part * spectrum_len, stage->time, kSplitComplex);
+	}
+	return 1;
+}
+
+static void destroy_stage(TConvolverStage* stage)
+{
+	Destroy_fft_plan(stage->plan);
+	free(stage->ir_spectra);
+}
+
+static void reset_stage(TConvolverStage* stage)
+{
+	memset(stage->fdl, 0, sizeof(float) * stage->parts * stage->spectrum_len);
+	memset(stage->in_buf, 0, sizeof(float) * 2 * stage->block_len);
+	stage->fdl_head = 0;
+	stage->fill = 0;
+}
+
+/*
+ * Splits [0, ir_len) into stages. Uniform: one stage of block_len. Non-uniform: a
+ * stage of size s may start at IR offset o only once o >= s - block_len, so that its
+ * output, which comes s samples after its input block, is still within the latency;
+ * each size is used at least twice before doubling.
+ */
+static int plan_stages(TConvolver* conv, const float* ir, const int ir_len, const TConvolverConfig* config)
+{
+	const int block_len = config->block_len;
+	int max_block_len = block_len;
+	int offset = 0, size = block_len, parts = 0;
+
+	if (kPartitionNonUniform == config->partition) {
+		max_block_len = (config->max_block_len > 0) ? config->max_block_len : block_len * CONVOLVER_DEFAULT_GROWTH;
+	}
+	while (offset < ir_len)
+	{
+		TConvolverStage* stage = &conv->stages[conv->stage_count];
+		parts = 0;
+		if (conv->stage_count == CONVOLVER_MAX_STAGES - 1 || size >= max_block_len) {
+			// The rest of the IR in the last stage
+			parts = (ir_len - offset + size - 1) / size;
+		}
+		else {
+			while (offset + parts * size < ir_len && (parts < 2 || offset + parts * size < 2 * size - block_len))
+			{
+				parts++;
+			}
+		}
+		stage->out_offset = offset - size + block_len;
+		if (!init_stage(stage, ir, ir_len, offset, size, parts)) {
+			conv->stage_count++;
+			return 0;
+		}
+		conv->stage_count++;
+		conv->part_count += parts;
+		offset += parts * size;
+		size = (2 * size <= max_block_len) ? 2 * size : size;
+	}
+	return 1;
+}
+
+TConvolver* Create_convolver(const float* ir, const int ir_len, const TConvolverConfig* config)
+{
+	if (NULL == ir || NULL == config || ir_len < 1 || config->block_len < 1) {
+		return NULL;
+	}
+	if (kPartitionUniform != config->partition && kPartitionNonUniform != config->partition) {
+		return NULL;
+	}
+	if (kPartitionNonUniform == config->partition && config->max_block_len > 0) {
+		int size = config->block_len;
+		while (size < config->max_block_len)
+		{
+			size *= 2;
+		}
+		if (size != config->max_block_len) {
+			return NULL;
+		}
+	}
+	TConvolver* conv = (TConvolver*)calloc(1, sizeof(TConvolver));
+	if (NULL == conv) {
+		return NULL;
+	}
+	conv->block_len = config->block_len;
+	if (!plan_stages(conv, ir, ir_len, config)) {
+		Destroy_convolver(conv);
+		return NULL;
+	}
+	for (int idx = 0; idx < conv->stage_count; idx++)
+	{
+		const int end = conv->stages[idx].out_offset + conv->stages[idx].block_len;
+		conv->ring_len = (end > conv->ring_len) ? end : conv->ring_len;
+	}
+	conv->out_ring = (float*)malloc(sizeof(float) * (conv->ring_len + 2 * conv->block_len));
+	if (NULL == conv->out_ring) {
+		Destroy_convolver(conv);
+		return NULL;
+	}
+	conv->out_ready = conv->out_ring + conv->ring_len;
+	conv->in_block = conv->out_ready + conv->block_len;
+	Reset_convolver(conv);
+	return conv;
+}
+
+void Destroy_convolver(TConvolver* conv)
+{
+	if (NULL == conv) {
+		return;
+	}
+	for (int idx = 0; idx < conv->stage_count; idx++)
+	{
+		destroy_stage(&conv->stages[idx]);
+	}
+	free(conv->out_ring);
+	free(conv);
+}
+
+void Reset_convolver(TConvolver* conv)
+{
+	if (NULL == conv) {
+		return;
+	}
+	for (int idx = 0; idx < conv->stage_count; idx++)
+	{
+		reset_stage(&conv->stages[idx]);
+	}
+	memset(conv->out_ring, 0, sizeof(float) * (conv->ring_len + conv->block_len));
+	conv->out_pos = 0;
+	conv->fill = 0;
+}
+
+int Get_convolver_latency(const TConvolver* conv)
+{
+	return (NULL == conv) ? 0 : conv->block_len;
+}
+
+int Get_convolver_partition_count(const TConvolver* conv)
+{
+	return (NULL == conv) ? 0 : conv->part_count;
+}
+
+// One overlap-save block of a stage whose input buffer has just filled up
+static void process_stage(TConvolver* conv, TConvolverStage* stage)
+{
+	const int block_len = stage->block_len;
+	const int bins = block_len + 1;
+	const int spectrum_len = stage->spectrum_len;
+	float* acc_re = stage->acc;
+	float* acc_im = stage->acc + bins;
+	int part = 0, idx = 0;
+
+	stage->fdl_head = (0 == stage->fdl_head) ? stage->parts - 1 : stage->fdl_head - 1;
+	Do_fftr_plan(stage->plan, stage->fdl + (size_t)stage->fdl_head * spectrum_len, stage->in_buf, kSplitComplex);
+
+	// acc = sum_p X[n - p] * H[p]; X[n - p] is p slots after the head
+	memset(stage->acc, 0, sizeof(float) * spectrum_len);
+	for (part = 0; part < stage->parts; part++)
+	{
+		const int slot = (stage->fdl_head + part < stage->parts) ? stage->fdl_head + part : stage->fdl_head + part - stage->parts;
+		const float* x_re = stage->fdl + (size_t)slot * spectrum_len;
+		const float* x_im = x_re + bins;
+		const float* h_re = stage->ir_spectra + (size_t)part * spectrum_len;
+		const float* h_im = h_re + bins;
+		for (idx = 0; idx < bins; idx++)
+		{
+			acc_re[idx] += x_re[idx] * h_re[idx] - x_im[idx] * h_im[idx];
+			acc_im[idx] += x_re[idx] * h_im[idx] + x_im[idx] * h_re[idx];
+		}
+	}
+	Do_ifftr_plan(stage->plan, stage->time, stage->acc, kSplitComplex);
+
+	// Overlap-save: the second half is the linear convolution of the new block
+	add_to_ring(conv->out_ring, conv->ring_len, (conv->out_pos + stage->out_offset) % conv->ring_len, stage->time + block_len, block_len);
+	memcpy(stage->in_buf, stage->in_buf + block_len, sizeof(float) * block_len);
+	stage->fill = 0;
+}
+
+// Feeds a complete input block to every stage and retires the front of the output ring
+static void process_block(TConvolver* conv)
+{
+	const int block_len = conv->block_len;
+	int idx = 0;
+
+	for (idx = 0; idx < conv->stage_count; idx++)
+	{
+		TConvolverStage* stage = &conv->stages[idx];
+		memcpy(stage->in_buf + stage->block_len + stage->fill, conv->in_block, sizeof(float) * block_len);
+		stage->fill += block_len;
+		if (stage->fill == stage->block_len) {
+			process_stage(conv, stage);
+		}
+	}
+
+	for (idx = 0; idx < block_len; idx++)
+	{
+		const int pos = (conv->out_pos + idx < conv->ring_len) ? conv->out_pos + idx : conv->out_pos + idx - conv->ring_len;
+		conv->out_ready[idx] = conv->out_ring[pos];
+		conv->out_ring[pos] = 0.0f;
+	}
+	conv->out_pos = (conv->out_pos + block_len) % conv->ring_len;
+}
+
+TFFTResult Do_convolver_process(TConvolver* conv, float* data_out, const float* data_in, const int count)
+{
+	if (NULL == conv || NULL == data_out || NULL == data_in) {
+		return kFFTErrNullPointer;
+	}
+	if (count < 0) {
+		return kFFTErrInvalidArgument;
+	}
+	int done = 0;
+
+	while (done < count)
+	{
+		int n = conv->block_len - conv->fill;
+		n = (n < count - done) ? n : count - done;
+		memcpy(conv->in_block + conv->fill, data_in + done, sizeof(float) * n);
+		// The input is consumed first, so data_out may alias data_in
+		memcpy(data_out + done, conv->out_ready + conv->fill, sizeof(float) * n);
+		conv->fill += n;
+		done += n;
+
+		if (conv->fill == conv->block_len) {
+			process_block(conv);
+			conv->fill = 0;
+		}
+	}
+	return kFFTOk;
+}
@@ -1,105 +1,930 @@
 #include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdint.h>
 #include "../Include/do_fft.h"
 #include "../Include/NE10_fft.h"
 
-void Do_fftr(float* data_out, float* data_in, const int fft_len, TFFTFormat format)
+#define FFT_PLAN_CACHE_SIZE 8
+
+struct _TFFTPlan
 {
-	if (NULL == data_out || NULL == data_in){
+	int fft_len;
+	TFFTScaling scaling;
+	ne10_fft_r2c_cfg_float32_t cfg;
+	ne10_fft_cpx_float32_t* cx_buf; // fft_len / 2 + 1 bins, for kHalfComplexInPlace
+	// Batch scratch, allocated on first use for batch_lanes channels per pass
+	int batch_lanes;
+	float* lane_time; // (fft_len + 2) * batch_lanes, sample-interleaved
+	float* lane_freq; // (fft_len + 2) * batch_lanes, bin-interleaved
+	ne10_fft_cpx_float32_t* lane_scratch; // fft_len * batch_lanes
+	// Fixed-point configurations, created on first use
+	ne10_fft_r2c_cfg_int16_t cfg_s16;
+	ne10_fft_r2c_cfg_int32_t cfg_s32;
+	int* fx_buf; // fft_len + 2 samples, for the fixed-point formats other than kIntelCCS
+};
+
+int Is_fft_length_supported(const int fft_len)
+{
+	return fft_len >= 2 && (fft_len & 1) == 0;
+}
+
+TFFTPlan* Create_fft_plan(const int fft_len)
+{
+	if (!Is_fft_length_supported(fft_len)) {
+		return NULL;
+	}
+	TFFTPlan* plan = (TFFTPlan*)calloc(1, sizeof(TFFTPlan));
+	if (NULL == plan) {
+		return NULL;
+	}
+	plan->fft_len = fft_len;
+	plan->cfg = ne10_fft_alloc_r2c_shared_float32(fft_len);
+	plan->cx_buf = (ne10_fft_cpx_float32_t*)malloc(sizeof(ne10_fft_cpx_float32_t) * (fft_len / 2 + 1));
+	if (NULL == plan->cfg || NULL == plan->cx_buf) {
+		Destroy_fft_plan(plan);
+		return NULL;
+	}
+	Set_fft_plan_scaling(plan, kFFTScaleInverse);
+	return plan;
+}
+
+void Destroy_fft_plan(TFFTPlan* plan)
+{
+	if (NULL == plan) {
 		return;
 	}
-	ne10_fft_r2c_cfg_float32_t cfg = ne10_fft_alloc_r2c_float32(fft_len);
-	ne10_fft_cpx_float32_t cx_out[4096 / 2 + 1]; //max 4096
-	ne10_fft_r2c_1d_float32_c(cx_out, data_in, cfg);
+	ne10_fft_destory_r2c_float32(plan->cfg);
+	free(plan->cx_buf);
+	free(plan->lane_time);
+	ne10_fft_destroy_r2c_int16(plan->cfg_s16);
+	ne10_fft_destroy_r2c_int32(plan->cfg_s32);
+	free(plan->fx_buf);
+	free(plan);
+}
+
+int Get_fft_plan_length(const TFFTPlan* plan)
+{
+	return (NULL == plan) ? 0 : plan->fft_len;
+}
+
+TFFTResult Set_fft_plan_scaling(TFFTPlan* plan, TFFTScaling scaling)
+{
+	if (NULL == plan) {
+		return kFFTErrNullPointer;
+	}
+	const float one_by_n = 1.0f / plan->fft_len;
+	const float one_by_sqrt_n = (float)(1.0 / sqrt((double)plan->fft_len));
+
+	switch (scaling)
+	{
+	case kFFTScaleNone:
+		plan->cfg->forward_scale = 1.0f;
+		plan->cfg->backward_scale = 1.0f;
+		break;
+	case kFFTScaleForward:
+		plan->cfg->forward_scale = one_by_n;
+		plan->cfg->backward_scale = 1.0f;
+		break;
+	case kFFTScaleInverse:
+		plan->cfg->forward_scale = 1.0f;
+		plan->cfg->backward_scale = one_by_n;
+		break;
+	case kFFTScaleSymmetric:
+		plan->cfg->forward_scale = one_by_sqrt_n;
+		plan->cfg->backward_scale = one_by_sqrt_n;
+		break;
+	default:
+		return kFFTErrInvalidArgument;
+	}
+	plan->scaling = scaling;
+	return kFFTOk;
+}
+
+TFFTScaling Get_fft_plan_scaling(const TFFTPlan* plan)
+{
+	return (NULL == plan) ? kFFTScaleInverse : plan->scaling;
+}
+
+int Is_fft_format_supported(TFFTFormat format)
+{
+	return (kHalfComplexInPlace == format || kIntelPerm == format || kIntelCCS == format || kSplitComplex == format);
+}
+
+int Get_fft_spectrum_length(const int fft_len, TFFTFormat format)
+{
+	return (kIntelCCS == format || kSplitComplex == format) ? fft_len + 2 : fft_len;
+}
+
+/*
+ * Bin k of the spectrum is (re[k * in_step], im[k * in_step]); value v of the packed
+ * format goes to data_out[v * out_step].
+ */
+template <class T>
+static void pack_spectrum(T* data_out, const int out_step, const T* re, const T* im, const int in_step, const int fft_len, TFFTFormat format)
+{
 	int idx = 0;
 
 	switch (format)
 	{
 	case kHalfComplexInPlace:
-		data_out[0] = cx_out[0].r;
-		data_out[fft_len / 2] = cx_out[fft_len / 2].r;
+		data_out[0] = re[0];
+		data_out[fft_len / 2 * out_step] = re[fft_len / 2 * in_step];
 		for (idx = 1; idx < fft_len / 2; idx++)
 		{
-			data_out[idx] = cx_out[idx].r;
-			data_out[fft_len / 2 - idx] = cx_out[idx].i;
+			data_out[idx * out_step] = re[idx * in_step];
+			data_out[(fft_len - idx) * out_step] = im[idx * in_step];
 		}
 		break;
 	case kIntelPerm:
-		data_out[0] = cx_out[0].r;
-		data_out[1] = cx_out[fft_len / 2].r;
-		data_out = data_out + 2;
+		data_out[0] = re[0];
+		data_out[out_step] = re[fft_len / 2 * in_step];
 		for (idx = 1; idx < fft_len / 2; idx++)
 		{
-			*data_out++ = cx_out[idx].r;
-			*data_out++ = cx_out[idx].i;
+			data_out[2 * idx * out_step] = re[idx * in_step];
+			data_out[(2 * idx + 1) * out_step] = im[idx * in_step];
 		}
 		break;
 	case kIntelCCS:
 		for (idx = 0; idx < fft_len / 2 + 1; idx++)
 		{
-			*data_out++ = cx_out[idx].r;
-			*data_out++ = cx_out[idx].i;
+			data_out[2 * idx * out_step] = re[idx * in_step];
+			data_out[(2 * idx + 1) * out_step] = im[idx * in_step];
+		}
+		break;
+	case kSplitComplex:
+		for (idx = 0; idx < fft_len / 2 + 1; idx++)
+		{
+			data_out[idx * out_step] = re[idx * in_step];
+			data_out[(fft_len / 2 + 1 + idx) * out_step] = im[idx * in_step];
 		}
 		break;
 	default:
 		break;
 	}
-	ne10_fft_destory_r2c_float32(cfg);
 }
 
-void Do_ifftr(float* data_out, float* data_in, const int fft_len, TFFTFormat format)
+template <class T>
+static void unpack_spectrum(T* re, T* im, const int out_step, const T* data_in, const int in_step, const int fft_len, TFFTFormat format)
 {
-	if (NULL == data_out || NULL == data_in) {
-		return;
-	}
-	ne10_fft_r2c_cfg_float32_t cfg = ne10_fft_alloc_r2c_float32(fft_len);
-	ne10_fft_cpx_float32_t cx_in[4096 / 2 + 1]; //max 4096
+	int idx = 0;
 
-	float* data_in_p;
-	int idx = 0, i = 0;
 	switch (format)
 	{
 	case kHalfComplexInPlace:
-		data_in_p = data_in;
-		cx_in[0].r = data_in_p[0];
-		cx_in[0].i = 0;
-		cx_in[fft_len / 2].r = data_in_p[fft_len / 2];
-		cx_in[fft_len / 2].i = 0;
-
+		re[0] = data_in[0];
+		re[fft_len / 2 * out_step] = data_in[fft_len / 2 * in_step];
 		for (idx = 1; idx < fft_len / 2; idx++)
 		{
-			cx_in[idx].r = data_in_p[idx];
-			cx_in[idx].i = data_in_p[fft_len / 2 - idx];
+			re[idx * out_step] = data_in[idx * in_step];
+			im[idx * out_step] = data_in[(fft_len - idx) * in_step];
 		}
 		break;
 	case kIntelPerm:
-		cx_in[0].r = data_in[0];
-		cx_in[0].i = 0;
-		cx_in[fft_len / 2].r = data_in[1];
-		cx_in[fft_len / 2].i = 0;
-		data_in_p = data_in + 2;
+		re[0] = data_in[0];
+		re[fft_len / 2 * out_step] = data_in[in_step];
 		for (idx = 1; idx < fft_len / 2; idx++)
 		{
-			cx_in[idx].r = *data_in_p++;
-			cx_in[idx].i = *data_in_p++;
+			re[idx * out_step] = data_in[2 * idx * in_step];
+			im[idx * out_step] = data_in[(2 * idx + 1) * in_step];
 		}
 		break;
 	case kIntelCCS:
-		data_in_p = data_in;
 		for (idx = 0; idx < fft_len / 2 + 1; idx++)
 		{
-			cx_in[idx].r = *data_in_p++;
-			cx_in[idx].i = *data_in_p++;
+			re[idx * out_step] = data_in[2 * idx * in_step];
+			im[idx * out_step] = data_in[(2 * idx + 1) * in_step];
+		}
+		break;
+	case kSplitComplex:
+		for (idx = 0; idx < fft_len / 2 + 1; idx++)
+		{
+			re[idx * out_step] = data_in[idx * in_step];
+			im[idx * out_step] = data_in[(fft_len / 2 + 1 + idx) * in_step];
+		}
+		break;
+	default:
+		break;
+	}
+	im[0] = 0;
+	im[fft_len / 2 * out_step] = 0;
+}
+
+/*
+ * kIntelCCS is the bin array of ne10_fft_r2c_1d_float32_c, kIntelPerm that of the packed
+ * variant and kSplitComplex the re/im arrays of the split one, so the kernels read and
+ * write them directly, in place if asked to. Only the half-complex format, which stores
+ * the imaginary parts in reverse, goes through cx_buf.
+ */
+static void fftr_frame(TFFTPlan* plan, float* data_out, float* data_in, TFFTFormat format)
+{
+	switch (format)
+	{
+	case kIntelCCS:
+		ne10_fft_r2c_1d_float32_c((ne10_fft_cpx_float32_t*)data_out, data_in, plan->cfg);
+		break;
+	case kIntelPerm:
+		ne10_fft_r2c_1d_packed_float32_c((ne10_fft_cpx_float32_t*)data_out, data_in, plan->cfg);
+		break;
+	case kSplitComplex:
+		ne10_fft_r2c_1d_split_float32_c(data_out, data_out + plan->fft_len / 2 + 1, data_in, plan->cfg);
+		break;
+	default:
+		ne10_fft_r2c_1d_float32_c(plan->cx_buf, data_in, plan->cfg);
+		pack_spectrum(data_out, 1, &plan->cx_buf[0].r, &plan->cx_buf[0].i, 2, plan->fft_len, format);
+		break;
+	}
+}
+
+static void ifftr_frame(TFFTPlan* plan, float* data_out, float* data_in, TFFTFormat format)
+{
+	switch (format)
+	{
+	case kIntelCCS:
+		ne10_fft_c2r_1d_float32_c(data_out, (ne10_fft_cpx_float32_t*)data_in, plan->cfg);
+		break;
+	case kIntelPerm:
+		ne10_fft_c2r_1d_packed_float32_c(data_out, (ne10_fft_cpx_float32_t*)data_in, plan->cfg);
+		break;
+	case kSplitComplex:
+		ne10_fft_c2r_1d_split_float32_c(data_out, data_in, data_in + plan->fft_len / 2 + 1, plan->cfg);
+		break;
+	default:
+		unpack_spectrum(&plan->cx_buf[0].r, &plan->cx_buf[0].i, 2, data_in, 1, plan->fft_len, format);
+		ne10_fft_c2r_1d_float32_c(data_out, plan->cx_buf, plan->cfg);
+		break;
+	}
+}
+
+TFFTResult Do_fftr_plan(TFFTPlan* plan, float* data_out, float* data_in, TFFTFormat format)
+{
+	if (NULL == plan || NULL == data_out || NULL == data_in) {
+		return kFFTErrNullPointer;
+	}
+	if (!Is_fft_format_supported(format)) {
+		return kFFTErrInvalidArgument;
+	}
+	fftr_frame(plan, data_out, data_in, format);
+	return kFFTOk;
+}
+
+TFFTResult Do_ifftr_plan(TFFTPlan* plan, float* data_out, float* data_in, TFFTFormat format)
+{
+	if (NULL == plan || NULL == data_out || NULL == data_in) {
+		return kFFTErrNullPointer;
+	}
+	if (!Is_fft_format_supported(format)) {
+		return kFFTErrInvalidArgument;
+	}
+	ifftr_frame(plan, data_out, data_in, format);
+	return kFFTOk;
+}
+
+/*
+ * Fixed-point transforms. The NE10 kernels produce (and take) kIntelCCS spectra with a
+ * block exponent; the plan scaling is a power of two, folded into the exponent, except
+ * for the odd half of the kFFTScaleSymmetric shift, which is a multiply by sqrt(1/2).
+ */
+static ne10_int32_t fixed_r2c(ne10_fft_r2c_cfg_int16_t cfg, short* data_out, const short* data_in)
+{
+	return ne10_fft_r2c_1d_int16_c((ne10_fft_cpx_int16_t*)data_out, data_in, cfg);
+}
+
+static ne10_int32_t fixed_r2c(ne10_fft_r2c_cfg_int32_t cfg, int* data_out, const int* data_in)
+{
+	return ne10_fft_r2c_1d_int32_c((ne10_fft_cpx_int32_t*)data_out, data_in, cfg);
+}
+
+static ne10_int32_t fixed_c2r(ne10_fft_r2c_cfg_int16_t cfg, short* data_out, const short* data_in, const int exponent)
+{
+	return ne10_fft_c2r_1d_int16_c(data_out, (const ne10_fft_cpx_int16_t*)data_in, exponent, cfg);
+}
+
+static ne10_int32_t fixed_c2r(ne10_fft_r2c_cfg_int32_t cfg, int* data_out, const int* data_in, const int exponent)
+{
+	return ne10_fft_c2r_1d_int32_c(data_out, (const ne10_fft_cpx_int32_t*)data_in, exponent, cfg);
+}
+
+static ne10_fft_r2c_cfg_int16_t* fixed_cfg(TFFTPlan* plan, const short*)
+{
+	return &plan->cfg_s16;
+}
+
+static ne10_fft_r2c_cfg_int32_t* fixed_cfg(TFFTPlan* plan, const int*)
+{
+	return &plan->cfg_s32;
+}
+
+static ne10_fft_r2c_cfg_int16_t alloc_fixed_cfg(const int fft_len, const short*)
+{
+	return ne10_fft_alloc_r2c_int16(fft_len);
+}
+
+static ne10_fft_r2c_cfg_int32_t alloc_fixed_cfg(const int fft_len, const int*)
+{
+	return ne10_fft_alloc_r2c_int32(fft_len);
+}
+
+template <class S>
+static TFFTResult reserve_fixed(TFFTPlan* plan, const S* tag)
+{
+	if (plan->fft_len < 4 || (plan->fft_len & (plan->fft_len - 1)) != 0) {
+		return kFFTErrUnsupportedLength;
+	}
+	if (NULL == *fixed_cfg(plan, tag)) {
+		*fixed_cfg(plan, tag) = alloc_fixed_cfg(plan->fft_len, tag);
+	}
+	if (NULL == plan->fx_buf) {
+		plan->fx_buf = (int*)malloc(sizeof(int) * (plan->fft_len + 2));
+	}
+	return (NULL == *fixed_cfg(plan, tag) || NULL == plan->fx_buf) ? kFFTErrOutOfMemory : kFFTOk;
+}
+
+// Power-of-two part of the forward or inverse normalisation; *sqrt_half is set if sqrt(1/2) remains
+static int fixed_scale_shift(const TFFTPlan* plan, const int inverse, int* sqrt_half)
+{
+	int bits = 0;
+	while ((1 << bits) < plan->fft_len) {
+		bits++;
+	}
+	*sqrt_half = 0;
+	switch (plan->scaling)
+	{
+	case kFFTScaleForward:
+		return inverse ? 0 : -bits;
+	case kFFTScaleInverse:
+		return inverse ? -bits : 0;
+	case kFFTScaleSymmetric:
+		*sqrt_half = bits & 1;
+		return -(bits / 2);
+	default:
+		return 0;
+	}
+}
+
+/*
+ * data[idx] * 2^shift, times sqrt(1/2) if asked, rounded to nearest and saturated to the
+ * range of S.
+ */
+template <class S>
+static void scale_fixed(S* data, const int count, int shift, const int sqrt_half)
+{
+	const int q = 8 * (int)sizeof(S) - 1;
+	const int64_t max_value = ((int64_t)1 << q) - 1;
+	const int64_t min_value = -((int64_t)1 << q);
+	const int64_t sqrt_half_q = (int64_t)floor(ldexp(sqrt(0.5), q) + 0.5);
+	int idx = 0;
+
+	if (0 == shift && !sqrt_half) {
+		return;
+	}
+	// Past these, every nonzero sample saturates or rounds to zero
+	shift = (shift > q) ? q : (shift < -q - 1) ? -q - 1 : shift;
+	for (idx = 0; idx < count; idx++)
+	{
+		int64_t v = data[idx];
+		if (sqrt_half) {
+			v = (v * sqrt_half_q + ((int64_t)1 << (q - 1))) >> q;
+		}
+		if (shift > 0) {
+			v *= (int64_t)1 << shift;
+		}
+		else if (shift < 0) {
+			v = (v + ((int64_t)1 << (-shift - 1))) >> -shift;
+		}
+		data[idx] = (S)((v > max_value) ? max_value : (v < min_value) ? min_value : v);
+	}
+}
+
+template <class S>
+static TFFTResult fftr_fixed(TFFTPlan* plan, S* data_out, const S* data_in, int* exponent, TFFTFormat format)
+{
+	if (NULL == plan || NULL == data_out || NULL == data_in || NULL == exponent) {
+		return kFFTErrNullPointer;
+	}
+	if (!Is_fft_format_supported(format)) {
+		return kFFTErrInvalidArgument;
+	}
+	TFFTResult result = reserve_fixed(plan, data_in);
+	if (kFFTOk != result) {
+		return result;
+	}
+	const int fft_len = plan->fft_len;
+	S* spectrum = (kIntelCCS == format) ? data_out : (S*)plan->fx_buf;
+	int sqrt_half = 0;
+
+	*exponent = fixed_r2c(*fixed_cfg(plan, data_in), spectrum, data_in) + fixed_scale_shift(plan, 0, &sqrt_half);
+	scale_fixed(spectrum, fft_len + 2, 0, sqrt_half);
+	if (kIntelCCS != format) {
+		pack_spectrum(data_out, 1, spectrum, spectrum + 1, 2, fft_len, format);
+	}
+	return kFFTOk;
+}
+
+template <class S>
+static TFFTResult ifftr_fixed(TFFTPlan* plan, S* data_out, const S* data_in, const int exponent, TFFTFormat format)
+{
+	if (NULL == plan || NULL == data_out || NULL == data_in) {
+		return kFFTErrNullPointer;
+	}
+	if (!Is_fft_format_supported(format)) {
+		return kFFTErrInvalidArgument;
+	}
+	TFFTResult result = reserve_fixed(plan, data_in);
+	if (kFFTOk != result) {
+		return result;
+	}
+	const int fft_len = plan->fft_len;
+	const S* spectrum = data_in;
+	int sqrt_half = 0;
+	int shift = 0;
+
+	if (kIntelCCS != format) {
+		S* buf = (S*)plan->fx_buf;
+		unpack_spectrum(buf, buf + 1, 2, data_in, 1, fft_len, format);
+		spectrum = buf;
+	}
+	shift = fixed_c2r(*fixed_cfg(plan, data_in), data_out, spectrum, exponent) + fixed_scale_shift(plan, 1, &sqrt_half);
+	scale_fixed(data_out, fft_len, shift, sqrt_half);
+	return kFFTOk;
+}
+
+TFFTResult Do_fftr_s16_plan(TFFTPlan* plan, short* data_out, const short* data_in, int* exponent, TFFTFormat format)
+{
+	return fftr_fixed(plan, data_out, data_in, exponent, format);
+}
+
+TFFTResult Do_ifftr_s16_plan(TFFTPlan* plan, short* data_out, const short* data_in, const int exponent, TFFTFormat format)
+{
+	return ifftr_fixed(plan, data_out, data_in, exponent, format);
+}
+
+TFFTResult Do_fftr_s32_plan(TFFTPlan* plan, int* data_out, const int* data_in, int* exponent, TFFTFormat format)
+{
+	return fftr_fixed(plan, data_out, data_in, exponent, format);
+}
+
+TFFTResult Do_ifftr_s32_plan(TFFTPlan* plan, int* data_out, const int* data_in, const int exponent, TFFTFormat format)
+{
+	return ifftr_fixed(plan, data_out, data_in, exponent, format);
+}
+
+/*
+ * Batch scratch for 'group' channels: the time-domain frames (sample-interleaved lanes,
+ * or one row of fft_len samples per channel for the single-channel kernels), the lane
+ * spectra and the kernel scratch.
+ */
+static int reserve_batch_buffers(TFFTPlan* plan, const int group)
+{
+	if (plan->batch_lanes >= group) {
+		return 1;
+	}
+	size_t lane_len = (size_t)(plan->fft_len + 2) * group;
+	float* buf = (float*)malloc(sizeof(float) * (2 * lane_len + (size_t)2 * plan->fft_len * group));
+	if (NULL == buf) {
+		return 0;
+	}
+	free(plan->lane_time);
+	plan->lane_time = buf;
+	plan->lane_freq = buf + lane_len;
+	plan->lane_scratch = (ne10_fft_cpx_float32_t*)(buf + 2 * lane_len);
+	plan->batch_lanes = group;
+	return 1;
+}
+
+/*
+ * Element (c, t) of a batch lives at data[c * ch_step + t * sample_step]; frame_len is
+ * fft_len for signals and Get_fft_spectrum_length for spectra.
+ */
+static void get_batch_steps(const int frame_len, const int channels, TFFTLayout layout, int* ch_step, int* sample_step)
+{
+	if (kInterleaved == layout) {
+		*ch_step = 1;
+		*sample_step = channels;
+	}
+	else {
+		*ch_step = frame_len;
+		*sample_step = 1;
+	}
+}
+
+/*
+ * Copies 'rows' rows of 'count' floats: dst[r * dst_row + l * dst_col] = src[r * src_row + l * src_col].
+ * Transposes go to the vectorised ne10_transpose_float32; contiguous rows of the kernel widths
+ * use fixed-size copies, which compile to vector moves.
+ */
+template <int N>
+static void copy_rows_n(float* dst, const int dst_row, const float* src, const int src_row, const int rows)
+{
+	for (int r = 0; r < rows; r++) {
+		memcpy(dst + r * dst_row, src + r * src_row, N * sizeof(float));
+	}
+}
+
+static void copy_rows(float* dst, const int dst_row, const int dst_col, const float* src, const int src_row, const int src_col,
+	const int rows, const int count)
+{
+	// Planar <-> interleaved conversions are transposes
+	if (1 == dst_row && 1 == src_col) {
+		ne10_transpose_float32(dst, dst_col, src, src_row, rows, count);
+		return;
+	}
+	if (1 == src_row && 1 == dst_col) {
+		ne10_transpose_float32(dst, dst_row, src, src_col, count, rows);
+		return;
+	}
+	if (1 == dst_col && 1 == src_col) {
+		switch (count)
+		{
+		case 4:
+			copy_rows_n<4>(dst, dst_row, src, src_row, rows);
+			return;
+		case 8:
+			copy_rows_n<8>(dst, dst_row, src, src_row, rows);
+			return;
+		case 16:
+			copy_rows_n<16>(dst, dst_row, src, src_row, rows);
+			return;
+		default:
+			break;
+		}
+	}
+	for (int r = 0; r < rows; r++) {
+		for (int l = 0; l < count; l++) {
+			dst[r * dst_row + l * dst_col] = src[r * src_row + l * src_col];
 		}
-		cx_in[0].i = 0;
-		cx_in[fft_len / 2].i = 0;
+	}
+}
+
+/*
+ * Lane spectra hold bin k as rows 2k (real parts) and 2k+1 (imaginary parts) of 'lanes'
+ * floats. pack_lanes writes 'count' of them in the packed format, run by run of rows that
+ * are equally spaced in the lane spectrum.
+ */
+static void pack_lanes(float* data_out, const int ch_step, const int sample_step, const float* lane_freq,
+	const int lanes, const int count, const int fft_len, TFFTFormat format)
+{
+	switch (format)
+	{
+	case kHalfComplexInPlace:
+		copy_rows(data_out, sample_step, ch_step, lane_freq, 2 * lanes, 1, fft_len / 2 + 1, count);
+		copy_rows(data_out + (fft_len / 2 + 1) * sample_step, sample_step, ch_step, lane_freq + (fft_len - 1) * lanes, -2 * lanes, 1,
+			fft_len / 2 - 1, count);
+		break;
+	case kIntelPerm:
+		copy_rows(data_out, sample_step, ch_step, lane_freq, lanes, 1, 1, count);
+		copy_rows(data_out + sample_step, sample_step, ch_step, lane_freq + fft_len * lanes, lanes, 1, 1, count);
+		copy_rows(data_out + 2 * sample_step, sample_step, ch_step, lane_freq + 2 * lanes, lanes, 1, fft_len - 2, count);
+		break;
+	case kIntelCCS:
+		copy_rows(data_out, sample_step, ch_step, lane_freq, lanes, 1, fft_len + 2, count);
+		break;
+	case kSplitComplex:
+		copy_rows(data_out, sample_step, ch_step, lane_freq, 2 * lanes, 1, fft_len / 2 + 1, count);
+		copy_rows(data_out + (fft_len / 2 + 1) * sample_step, sample_step, ch_step, lane_freq + lanes, 2 * lanes, 1,
+			fft_len / 2 + 1, count);
+		break;
+	default:
+		break;
+	}
+}
+
+static void unpack_lanes(float* lane_freq, const int lanes, const int count, const float* data_in,
+	const int ch_step, const int sample_step, const int fft_len, TFFTFormat format)
+{
+	int t = 0, l = 0;
+
+	switch (format)
+	{
+	case kHalfComplexInPlace:
+		copy_rows(lane_freq, 2 * lanes, 1, data_in, sample_step, ch_step, fft_len / 2 + 1, count);
+		copy_rows(lane_freq + (fft_len - 1) * lanes, -2 * lanes, 1, data_in + (fft_len / 2 + 1) * sample_step, sample_step, ch_step,
+			fft_len / 2 - 1, count);
+		break;
+	case kIntelPerm:
+		copy_rows(lane_freq, lanes, 1, data_in, sample_step, ch_step, 1, count);
+		copy_rows(lane_freq + fft_len * lanes, lanes, 1, data_in + sample_step, sample_step, ch_step, 1, count);
+		copy_rows(lane_freq + 2 * lanes, lanes, 1, data_in + 2 * sample_step, sample_step, ch_step, fft_len - 2, count);
+		break;
+	case kIntelCCS:
+		copy_rows(lane_freq, lanes, 1, data_in, sample_step, ch_step, fft_len + 2, count);
+		break;
+	case kSplitComplex:
+		copy_rows(lane_freq, 2 * lanes, 1, data_in, sample_step, ch_step, fft_len / 2 + 1, count);
+		copy_rows(lane_freq + lanes, 2 * lanes, 1, data_in + (fft_len / 2 + 1) * sample_step, sample_step, ch_step,
+			fft_len / 2 + 1, count);
 		break;
 	default:
 		break;
 	}
+	// The imaginary parts of DC and Nyquist are not part of every format
+	for (l = 0; l < lanes; l++) {
+		lane_freq[lanes + l] = 0;
+		lane_freq[(fft_len + 1) * lanes + l] = 0;
+	}
+	// Unused lanes of the last group
+	for (t = 0; t < fft_len + 2 && count < lanes; t++) {
+		for (l = count; l < lanes; l++) {
+			lane_freq[t * lanes + l] = 0;
+		}
+	}
+}
+
+/*
+ * Interleaved channels are transformed 'lanes' at a time (see ne10_fft_r2c_lanes_float32),
+ * one channel per SIMD lane: each group is copied sample by sample into a lane frame, or
+ * used in place if the caller's buffer already is one, and the lane spectra are packed
+ * straight into the requested layout and format. Planar channels run through the
+ * single-channel kernels in place, which is faster than transposing them into lanes;
+ * so do interleaved channels when no lane kernel applies, after de-interleaving
+ * BATCH_GROUP channels at a time.
+ */
+#define BATCH_GROUP 8
+
+TFFTResult Do_fftr_batch_plan(TFFTPlan* plan, float* data_out, float* data_in, const int channels, TFFTLayout layout, TFFTFormat format)
+{
+	if (NULL == plan || NULL == data_out || NULL == data_in) {
+		return kFFTErrNullPointer;
+	}
+	if (channels <= 0 || !Is_fft_format_supported(format)) {
+		return kFFTErrInvalidArgument;
+	}
+	const int fft_len = plan->fft_len;
+	const int spectrum_len = Get_fft_spectrum_length(fft_len, format);
+	const int lanes = (kInterleaved == layout) ? ne10_fft_r2c_lanes_float32(plan->cfg, channels) : 1;
+	const int group = (lanes > 1) ? lanes : BATCH_GROUP;
+	int in_ch = 0, in_sample = 0, out_ch = 0, out_sample = 0;
+	int first = 0, count = 0, t = 0, l = 0;
+
+	if (!reserve_batch_buffers(plan, group)) {
+		return kFFTErrOutOfMemory;
+	}
+	get_batch_steps(fft_len, channels, layout, &in_ch, &in_sample);
+	get_batch_steps(spectrum_len, channels, layout, &out_ch, &out_sample);
+
+	for (first = 0; first < channels; first += group)
+	{
+		float* src = data_in + first * in_ch;
+		float* dst = data_out + first * out_ch;
+
+		count = (channels - first < group) ? channels - first : group;
+		if (lanes > 1) {
+			float* lane_in = src;
+			if (count != lanes || in_sample != lanes || in_ch != 1) {
+				lane_in = plan->lane_time;
+				copy_rows(lane_in, lanes, 1, src, in_sample, in_ch, fft_len, count);
+				for (t = 0; t < fft_len && count < lanes; t++) {
+					for (l = count; l < lanes; l++) {
+						lane_in[t * lanes + l] = 0;
+					}
+				}
+			}
+			ne10_fft_r2c_1d_lanes_float32_c(plan->lane_freq, lane_in, lanes, plan->cfg, plan->lane_scratch);
+			pack_lanes(dst, out_ch, out_sample, plan->lane_freq, lanes, count, fft_len, format);
+			continue;
+		}
+
+		// Single-channel kernels on planar rows
+		if (1 != in_sample) {
+			copy_rows(plan->lane_time, 1, fft_len, src, in_sample, in_ch, fft_len, count);
+		}
+		for (l = 0; l < count; l++)
+		{
+			float* frame = (1 != in_sample) ? plan->lane_time + l * fft_len : src + l * in_ch;
+			float* spectrum = (1 != out_sample) ? plan->lane_freq + l * spectrum_len : dst + l * out_ch;
+			fftr_frame(plan, spectrum, frame, format);
+		}
+		if (1 != out_sample) {
+			copy_rows(dst, out_sample, out_ch, plan->lane_freq, 1, spectrum_len, spectrum_len, count);
+		}
+	}
+	return kFFTOk;
+}
+
+TFFTResult Do_ifftr_batch_plan(TFFTPlan* plan, float* data_out, float* data_in, const int channels, TFFTLayout layout, TFFTFormat format)
+{
+	if (NULL == plan || NULL == data_out || NULL == data_in) {
+		return kFFTErrNullPointer;
+	}
+	if (channels <= 0 || !Is_fft_format_supported(format)) {
+		return kFFTErrInvalidArgument;
+	}
+	const int fft_len = plan->fft_len;
+	const int spectrum_len = Get_fft_spectrum_length(fft_len, format);
+	const int lanes = (kInterleaved == layout) ? ne10_fft_r2c_lanes_float32(plan->cfg, channels) : 1;
+	const int group = (lanes > 1) ? lanes : BATCH_GROUP;
+	int in_ch = 0, in_sample = 0, out_ch = 0, out_sample = 0;
+	int first = 0, count = 0, l = 0;
+
+	if (!reserve_batch_buffers(plan, group)) {
+		return kFFTErrOutOfMemory;
+	}
+	get_batch_steps(spectrum_len, channels, layout, &in_ch, &in_sample);
+	get_batch_steps(fft_len, channels, layout, &out_ch, &out_sample);
+
+	for (first = 0; first < channels; first += group)
+	{
+		float* src = data_in + first * in_ch;
+		float* dst = data_out + first * out_ch;
+
+		count = (channels - first < group) ? channels - first : group;
+		if (lanes > 1) {
+			const int direct = (count == lanes && out_sample == lanes && out_ch == 1);
+			float* lane_out = direct ? dst : plan->lane_time;
+			unpack_lanes(plan->lane_freq, lanes, count, src, in_ch, in_sample, fft_len, format);
+			ne10_fft_c2r_1d_lanes_float32_c(lane_out, plan->lane_freq, lanes, plan->cfg, plan->lane_scratch);
+			if (!direct) {
+				copy_rows(dst, out_sample, out_ch, lane_out, lanes, 1, fft_len, count);
+			}
+			continue;
+		}
+
+		// Single-channel kernels on planar rows
+		if (1 != in_sample) {
+			copy_rows(plan->lane_freq, 1, spectrum_len, src, in_sample, in_ch, spectrum_len, count);
+		}
+		for (l = 0; l < count; l++)
+		{
+			float* spectrum = (1 != in_sample) ? plan->lane_freq + l * spectrum_len : src + l * in_ch;
+			float* frame = (1 != out_sample) ? plan->lane_time + l * fft_len : dst + l * out_ch;
+			ifftr_frame(plan, frame, spectrum, format);
+		}
+		if (1 != out_sample) {
+			copy_rows(dst, out_sample, out_ch, plan->lane_time, 1, fft_len, fft_len, count);
+		}
+	}
+	return kFFTOk;
+}
 
-	if (cfg != NULL)
+/*
+ * Per-thread plan cache used by the one-shot entry points. Each thread owns its
+ * plans (and their scratch), so Do_fftr/Do_ifftr stay reentrant without locks.
+ * When the cache is full the oldest entry is evicted.
+ */
+struct FFTPlanCache
+{
+	TFFTPlan* plans[FFT_PLAN_CACHE_SIZE];
+	int next;
+
+	~FFTPlanCache()
 	{
-		ne10_fft_c2r_1d_float32_c(data_out,cx_in,cfg);
+		clear();
+	}
+
+	void clear()
+	{
+		for (int i = 0; i < FFT_PLAN_CACHE_SIZE; i++) {
+			Destroy_fft_plan(plans[i]);
+			plans[i] = NULL;
+		}
+		next = 0;
+	}
+};
+
+static thread_local FFTPlanCache s_plan_cache;
+
+static TFFTPlan* get_cached_plan(const int fft_len)
+{
+	int idx = 0;
+	for (idx = 0; idx < FFT_PLAN_CACHE_SIZE; idx++) {
+		if (NULL != s_plan_cache.plans[idx] && s_plan_cache.plans[idx]->fft_len == fft_len) {
+			return s_plan_cache.plans[idx];
+		}
+	}
+
+	TFFTPlan* plan = Create_fft_plan(fft_len);
+	if (NULL == plan) {
+		return NULL;
+	}
+	idx = s_plan_cache.next;
+	Destroy_fft_plan(s_plan_cache.plans[idx]);
+	s_plan_cache.plans[idx] = plan;
+	s_plan_cache.next = (idx + 1) % FFT_PLAN_CACHE_SIZE;
+	return plan;
+}
+
+TFFTResult Do_fftr(float* data_out, float* data_in, const int fft_len, TFFTFormat format)
+{
+	if (NULL == data_out || NULL == data_in){
+		return kFFTErrNullPointer;
+	}
+	if (!Is_fft_length_supported(fft_len)) {
+		return kFFTErrUnsupportedLength;
+	}
+	TFFTPlan* plan = get_cached_plan(fft_len);
+	if (NULL == plan) {
+		return kFFTErrOutOfMemory;
+	}
+	return Do_fftr_plan(plan, data_out, data_in, format);
+}
+
+TFFTResult Do_ifftr(float* data_out, float* data_in, const int fft_len, TFFTFormat format)
+{
+	if (NULL == data_out || NULL == data_in) {
+		return kFFTErrNullPointer;
+	}
+	if (!Is_fft_length_supported(fft_len)) {
+		return kFFTErrUnsupportedLength;
+	}
+	TFFTPlan* plan = get_cached_plan(fft_len);
+	if (NULL == plan) {
+		return kFFTErrOutOfMemory;
+	}
+	return Do_ifftr_plan(plan, data_out, data_in, format);
+}
+
+TFFTResult Do_fftr_batch(float* data_out, float* data_in, const int fft_len, const int channels, TFFTLayout layout, TFFTFormat format)
+{
+	if (NULL == data_out || NULL == data_in) {
+		return kFFTErrNullPointer;
+	}
+	if (!Is_fft_length_supported(fft_len)) {
+		return kFFTErrUnsupportedLength;
+	}
+	TFFTPlan* plan = get_cached_plan(fft_len);
+	if (NULL == plan) {
+		return kFFTErrOutOfMemory;
+	}
+	return Do_fftr_batch_plan(plan, data_out, data_in, channels, layout, format);
+}
+
+TFFTResult Do_ifftr_batch(float* data_out, float* data_in, const int fft_len, const int channels, TFFTLayout layout, TFFTFormat format)
+{
+	if (NULL == data_out || NULL == data_in) {
+		return kFFTErrNullPointer;
+	}
+	if (!Is_fft_length_supported(fft_len)) {
+		return kFFTErrUnsupportedLength;
+	}
+	TFFTPlan* plan = get_cached_plan(fft_len);
+	if (NULL == plan) {
+		return kFFTErrOutOfMemory;
+	}
+	return Do_ifftr_batch_plan(plan, data_out, data_in, channels, layout, format);
+}
+
+TFFTResult Do_fftr_s16(short* data_out, const short* data_in, const int fft_len, int* exponent, TFFTFormat format)
+{
+	if (NULL == data_out || NULL == data_in) {
+		return kFFTErrNullPointer;
+	}
+	if (!Is_fft_length_supported(fft_len)) {
+		return kFFTErrUnsupportedLength;
+	}
+	TFFTPlan* plan = get_cached_plan(fft_len);
+	if (NULL == plan) {
+		return kFFTErrOutOfMemory;
+	}
+	return Do_fftr_s16_plan(plan, data_out, data_in, exponent, format);
+}
+
+TFFTResult Do_ifftr_s16(short* data_out, const short* data_in, const int fft_len, const int exponent, TFFTFormat format)
+{
+	if (NULL == data_out || NULL == data_in) {
+		return kFFTErrNullPointer;
+	}
+	if (!Is_fft_length_supported(fft_len)) {
+		return kFFTErrUnsupportedLength;
+	}
+	TFFTPlan* plan = get_cached_plan(fft_len);
+	if (NULL == plan) {
+		return kFFTErrOutOfMemory;
 	}
-	ne10_fft_destory_r2c_float32(cfg);
-}
\ No newline at end of file
+	return Do_ifftr_s16_plan(plan, data_out, data_in, exponent, format);
+}
+
+TFFTResult Do_fftr_s32(int* data_out, const int* data_in, const int fft_len, int* exponent, TFFTFormat format)
+{
+	if (NULL == data_out || NULL == data_in) {
+		return kFFTErrNullPointer;
+	}
+	if (!Is_fft_length_supported(fft_len)) {
+		return kFFTErrUnsupportedLength;
+	}
+	TFFTPlan* plan = get_cached_plan(fft_len);
+	if (NULL == plan) {
+		return kFFTErrOutOfMemory;
+	}
+	return Do_fftr_s32_plan(plan, data_out, data_in, exponent, format);
+}
+
+TFFTResult Do_ifftr_s32(int* data_out, const int* data_in, const int fft_len, const int exponent, TFFTFormat format)
+{
+	if (NULL == data_out || NULL == data_in) {
+		return kFFTErrNullPointer;
+	}
+	if (!Is_fft_length_supported(fft_len)) {
+		return kFFTErrUnsupportedLength;
+	}
+	TFFTPlan* plan = get_cached_plan(fft_len);
+	if (NULL == plan) {
+		return kFFTErrOutOfMemory;
+	}
+	return Do_ifftr_s32_plan(plan, data_out, data_in, exponent, format);
+}
+
+void Release_fft_plan_cache(void)
+{
+	s_plan_cache.clear();
+}
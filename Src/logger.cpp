@@ -3,6 +3,18 @@
 #include <stdarg.h>
 #include <stdlib.h>
 #include <time.h>
+#include <ctype.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <unordered_map>
 #if defined(_WIN32) || defined(_WIN64)
  #include <winsock2.h>
 #else
@@ -16,9 +28,20 @@ enum {
     /* Logger type */
     kConsoleLogger = 1 << 0,
     kFileLogger = 1 << 1,
+    kBinaryLogger = 1 << 2,
 
     kMaxFileNameLen = 255, /* without null character */
+    kMaxBackupFileNameLen = kMaxFileNameLen + 32, /* with an index or pending suffix and an extension */
+    kMaxExtensionLen = 15, /* without null character */
+    kMaxModules = 64,
+    kMaxModuleNameLen = 63, /* without null character */
     kDefaultMaxFileSize = 1048576L, /* 1 MB */
+
+    /* Async logger */
+    kMinRingSize = 4096,
+    kDefaultRingSize = 65536,
+    kMaxPayload = 1024, /* bytes of text or arguments in one record; longer messages are truncated */
+    kAsyncPollInterval = 5, /* msec between drains of an idle writer */
 };
 
 /* Console logger */
@@ -37,6 +60,20 @@ static struct {
     long flushedTime;
 } s_flog;
 
+/*
+ * Per-module levels. Each slot holds the level in effect for its module, the global
+ * one unless overridden, so the LOG_* macros need one load to check it; the slots
+ * never move, and the macros cache a pointer to theirs. Modules past kMaxModules
+ * share s_globalLevel, which always mirrors s_logLevel.
+ */
+static struct {
+    char name[kMaxModuleNameLen + 1];
+    int level;
+    int overridden;
+} s_modules[kMaxModules];
+static int s_moduleCount;
+static int s_globalLevel = LogLevel_INFO;
+
 static volatile int s_logger;
 static volatile LogLevel s_logLevel = LogLevel_INFO;
 static volatile long s_flushInterval = 0; /* msec, 0 is auto flush off */
@@ -182,9 +219,111 @@ cleanup:
     return ok;
 }
 
+static void storeLevel(int* ref, int level)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __atomic_store_n(ref, level, __ATOMIC_RELAXED);
+#else
+    *(volatile int*) ref = level;
+#endif /* defined(__GNUC__) || defined(__clang__) */
+}
+
+/* Called with the lock held */
+static int findModule(const char* module)
+{
+    int i;
+
+    for (i = 0; i < s_moduleCount; i++) {
+        if (strncmp(s_modules[i].name, module, kMaxModuleNameLen) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* Called with the lock held; -1 if the table is full */
+static int addModule(const char* module)
+{
+    int i = findModule(module);
+
+    if (i < 0 && s_moduleCount < kMaxModules) {
+        i = s_moduleCount;
+        strncpy(s_modules[i].name, module, kMaxModuleNameLen);
+        s_modules[i].name[kMaxModuleNameLen] = '\0';
+        s_modules[i].level = s_logLevel;
+        s_modules[i].overridden = 0; /* false */
+        s_moduleCount++;
+    }
+    return i;
+}
+
 void logger_setLevel(LogLevel level)
 {
+    int i;
+
+    init();
+    lock();
     s_logLevel = level;
+    storeLevel(&s_globalLevel, level);
+    for (i = 0; i < s_moduleCount; i++) {
+        if (!s_modules[i].overridden) {
+            storeLevel(&s_modules[i].level, level);
+        }
+    }
+    unlock();
+}
+
+int logger_setModuleLevel(const char* module, LogLevel level)
+{
+    int i;
+
+    if (module == NULL) {
+        return 0;
+    }
+    init();
+    lock();
+    i = addModule(module);
+    if (i >= 0) {
+        s_modules[i].overridden = 1; /* true */
+        storeLevel(&s_modules[i].level, level);
+    }
+    unlock();
+    return i >= 0;
+}
+
+void logger_resetModuleLevel(const char* module)
+{
+    int i;
+
+    if (module == NULL) {
+        return;
+    }
+    init();
+    lock();
+    i = findModule(module);
+    if (i >= 0) {
+        s_modules[i].overridden = 0; /* false */
+        storeLevel(&s_modules[i].level, s_logLevel);
+    }
+    unlock();
+}
+
+const int* logger_getModuleLevelRef(const char* module)
+{
+    const int* ref = &s_globalLevel;
+    int i;
+
+    if (module == NULL) {
+        return ref;
+    }
+    init();
+    lock();
+    i = addModule(module);
+    if (i >= 0) {
+        ref = &s_modules[i].level;
+    }
+    unlock();
+    return ref;
 }
 
 LogLevel logger_getLevel(void)
@@ -197,6 +336,79 @@ int logger_isEnabled(LogLevel level)
     return s_logLevel <= level;
 }
 
+/* Atomic operations on the fields of a LogRateState, which is plain C */
+static long long rateLoad(long long* value)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    return InterlockedCompareExchange64(value, 0, 0);
+#else
+    return __atomic_load_n(value, __ATOMIC_RELAXED);
+#endif /* defined(_WIN32) || defined(_WIN64) */
+}
+
+static long long rateAdd(long long* value, long long delta) /* returns the previous value */
+{
+#if defined(_WIN32) || defined(_WIN64)
+    return InterlockedExchangeAdd64(value, delta);
+#else
+    return __atomic_fetch_add(value, delta, __ATOMIC_RELAXED);
+#endif /* defined(_WIN32) || defined(_WIN64) */
+}
+
+static long long rateExchange(long long* value, long long desired)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    return InterlockedExchange64(value, desired);
+#else
+    return __atomic_exchange_n(value, desired, __ATOMIC_RELAXED);
+#endif /* defined(_WIN32) || defined(_WIN64) */
+}
+
+static int rateCompareExchange(long long* value, long long expected, long long desired)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    return InterlockedCompareExchange64(value, desired, expected) == expected;
+#else
+    return __atomic_compare_exchange_n(value, &expected, desired, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+#endif /* defined(_WIN32) || defined(_WIN64) */
+}
+
+long long logger_rateLimit(LogRateState* state, LogRateKind kind, long long param)
+{
+    long long now;
+    long long next;
+
+    if (state == NULL) {
+        return 0;
+    }
+    switch (kind) {
+        case LogRate_EVERY_N:
+            if (param <= 1) {
+                return 0;
+            }
+            return (rateAdd(&state->count, 1) % param == 0) ? 0 : -1;
+        case LogRate_FIRST_N:
+            /* Once past n, stop writing the count, so a hot call site stays read-only */
+            if (rateLoad(&state->count) >= param) {
+                return -1;
+            }
+            return (rateAdd(&state->count, 1) < param) ? 0 : -1;
+        case LogRate_EVERY_MS:
+            now = (long long) std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count();
+            next = rateLoad(&state->next);
+            /* next is 0 before the first call; only one thread wins each window */
+            if ((next == 0 || now >= next) && rateCompareExchange(&state->next, next, now + (param > 0 ? param : 0))) {
+                rateAdd(&state->count, 1);
+                return rateExchange(&state->suppressed, 0);
+            }
+            rateAdd(&state->suppressed, 1);
+            return -1;
+        default:
+            return 0;
+    }
+}
+
 void logger_autoFlush(long interval)
 {
     s_flushInterval = interval > 0 ? interval : 0;
@@ -207,6 +419,20 @@ static int hasFlag(int flags, int flag)
     return (flags & flag) == flag;
 }
 
+static void flushOutputs(void)
+{
+    lock();
+    if (hasFlag(s_logger, kConsoleLogger)) {
+        fflush(s_clog.output);
+    }
+    if (hasFlag(s_logger, kFileLogger) && s_flog.output != NULL) {
+        fflush(s_flog.output);
+    }
+    unlock();
+}
+
+static void flushAsync(void);
+
 void logger_flush()
 {
     if (s_logger == 0 || !s_initialized) {
@@ -214,12 +440,8 @@ void logger_flush()
         return;
     }
 
-    if (hasFlag(s_logger, kConsoleLogger)) {
-        fflush(s_clog.output);
-    }
-    if (hasFlag(s_logger, kFileLogger)) {
-        fflush(s_flog.output);
-    }
+    flushAsync();
+    flushOutputs();
 }
 
 static char getLevelChar(LogLevel level)
@@ -273,29 +495,198 @@ static int isFileExist(const char* filename)
     }
 }
 
-static int rotateLogFiles(void)
+/*
+ * Rotation
+ *
+ * When the file is full, rotateLogFiles() only renames it to a pending name and opens
+ * a new one, so a logging thread never waits on the backups. The rotator thread then
+ * closes the old stream, shifts <filename>.1 ... .<maxBackupFiles> up by one, moves the
+ * pending file to .1 and compresses it if a compressor is set; with no backups, the
+ * pending file is removed. Segments are handled in the order they were rotated.
+ */
+typedef struct {
+    FILE* output; /* the full file, if it is still open */
+    char filename[kMaxFileNameLen + 1];
+    char pending[kMaxBackupFileNameLen + 1];
+    unsigned char maxBackupFiles;
+} LogSegment;
+
+static struct {
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::deque<LogSegment> queue;
+    std::thread thread;
+    bool started;
+    bool busy; /* a segment is being handled */
+    bool stop;
+    unsigned long sequence; /* for pending names, under the logger mutex */
+    LogCompressor compress;
+    void* user;
+    char extension[kMaxExtensionLen + 1];
+} s_rotator;
+
+static void moveFile(const char* src, const char* dst)
+{
+    if (!isFileExist(src)) {
+        return;
+    }
+    if (isFileExist(dst) && remove(dst) != 0) {
+        fprintf(stderr, "ERROR: logger: Failed to remove file: `%s`\n", dst);
+    }
+    if (rename(src, dst) != 0) {
+        fprintf(stderr, "ERROR: logger: Failed to rename file: `%s` -> `%s`\n", src, dst);
+    }
+}
+
+/* Backup names are <filename>.<index>, plus the extension once compressed */
+static void getBackupFileNameExt(const char* basename, unsigned char index, const char* extension,
+        char* backupname, size_t size)
+{
+    getBackupFileName(basename, index, backupname, size);
+    strncat(backupname, extension, size - strlen(backupname) - 1);
+}
+
+static void archiveSegment(LogSegment* segment, LogCompressor compress, void* user, const char* extension)
 {
+    char src[kMaxBackupFileNameLen + 1], dst[kMaxBackupFileNameLen + 1]; /* with null character */
     int i;
-    /* backup filename: <filename>.xxx (xxx: 1-255) */
-    char src[kMaxFileNameLen + 5], dst[kMaxFileNameLen + 5]; /* with null character */
+
+    if (segment->output != NULL) {
+        fclose(segment->output);
+    }
+    if (segment->maxBackupFiles == 0) {
+        if (remove(segment->pending) != 0) {
+            fprintf(stderr, "ERROR: logger: Failed to remove file: `%s`\n", segment->pending);
+        }
+        return;
+    }
+    /* A backup may be compressed or not (if compression was off or failed), so both names move */
+    for (i = (int) segment->maxBackupFiles; i > 1; i--) {
+        getBackupFileName(segment->filename, i - 1, src, sizeof(src));
+        getBackupFileName(segment->filename, i, dst, sizeof(dst));
+        moveFile(src, dst);
+        if (extension[0] != '\0') {
+            getBackupFileNameExt(segment->filename, i - 1, extension, src, sizeof(src));
+            getBackupFileNameExt(segment->filename, i, extension, dst, sizeof(dst));
+            moveFile(src, dst);
+        }
+    }
+    getBackupFileNameExt(segment->filename, 1, extension, dst, sizeof(dst));
+    if (compress != NULL && compress(segment->pending, dst, user)) {
+        remove(segment->pending);
+        return;
+    }
+    if (compress != NULL) {
+        fprintf(stderr, "ERROR: logger: Failed to compress file: `%s`\n", segment->pending);
+        remove(dst);
+    }
+    getBackupFileName(segment->filename, 1, dst, sizeof(dst));
+    moveFile(segment->pending, dst);
+    if (extension[0] != '\0') {
+        /* .1 is taken now; an old compressed .1 would otherwise shadow it */
+        getBackupFileNameExt(segment->filename, 1, extension, dst, sizeof(dst));
+        remove(dst);
+    }
+}
+
+static void rotatorMain(void)
+{
+    std::unique_lock<std::mutex> guard(s_rotator.mutex);
+    LogSegment segment;
+    LogCompressor compress;
+    void* user;
+    char extension[kMaxExtensionLen + 1];
+
+    for (;;) {
+        while (s_rotator.queue.empty() && !s_rotator.stop) {
+            s_rotator.wake.wait(guard);
+        }
+        if (s_rotator.queue.empty()) {
+            return;
+        }
+        segment = s_rotator.queue.front();
+        s_rotator.queue.pop_front();
+        s_rotator.busy = true;
+        compress = s_rotator.compress;
+        user = s_rotator.user;
+        strcpy(extension, s_rotator.extension);
+        guard.unlock();
+        archiveSegment(&segment, compress, user, extension);
+        guard.lock();
+        s_rotator.busy = false;
+        if (s_rotator.queue.empty()) {
+            s_rotator.idle.notify_all();
+        }
+    }
+}
+
+/* Finishes the queued segments at exit, so the backups are in place */
+static void stopRotator(void)
+{
+    {
+        std::lock_guard<std::mutex> guard(s_rotator.mutex);
+        s_rotator.stop = true;
+        s_rotator.wake.notify_one();
+    }
+    s_rotator.thread.join();
+}
+
+/* Hands a segment to the rotator thread, or archives it here if the thread can't run */
+static void queueSegment(LogSegment* segment)
+{
+    LogCompressor compress;
+    void* user;
+    char extension[kMaxExtensionLen + 1];
+
+    {
+        std::lock_guard<std::mutex> guard(s_rotator.mutex);
+        /* Once stopRotator() has run, the async writer can still rotate at exit */
+        if (!s_rotator.stop) {
+            try {
+                if (!s_rotator.started) {
+                    s_rotator.thread = std::thread(rotatorMain);
+                    s_rotator.started = true;
+                    atexit(stopRotator);
+                }
+                s_rotator.queue.push_back(*segment);
+                s_rotator.wake.notify_one();
+                return;
+            } catch (...) {
+            }
+        }
+        compress = s_rotator.compress;
+        user = s_rotator.user;
+        strcpy(extension, s_rotator.extension);
+    }
+    archiveSegment(segment, compress, user, extension);
+}
+
+static int rotateLogFiles(void)
+{
+    LogSegment segment;
 
     if (s_flog.currentFileSize < s_flog.maxFileSize) {
         return s_flog.output != NULL;
     }
+    strcpy(segment.filename, s_flog.filename);
+    sprintf(segment.pending, "%s.pending%lu", s_flog.filename, ++s_rotator.sequence % 1000000UL);
+    segment.maxBackupFiles = s_flog.maxBackupFiles;
+#if defined(_WIN32) || defined(_WIN64)
+    /* Windows can't rename an open file */
     fclose(s_flog.output);
-    for (i = (int) s_flog.maxBackupFiles; i > 0; i--) {
-        getBackupFileName(s_flog.filename, i - 1, src, sizeof(src));
-        getBackupFileName(s_flog.filename, i, dst, sizeof(dst));
-        if (isFileExist(dst)) {
-            if (remove(dst) != 0) {
-                fprintf(stderr, "ERROR: logger: Failed to remove file: `%s`\n", dst);
-            }
-        }
-        if (isFileExist(src)) {
-            if (rename(src, dst) != 0) {
-                fprintf(stderr, "ERROR: logger: Failed to rename file: `%s` -> `%s`\n", src, dst);
-            }
+    segment.output = NULL;
+#else
+    segment.output = s_flog.output; /* closed (and flushed) by the rotator */
+#endif /* defined(_WIN32) || defined(_WIN64) */
+    s_flog.output = NULL;
+    if (rename(s_flog.filename, segment.pending) != 0) {
+        fprintf(stderr, "ERROR: logger: Failed to rename file: `%s` -> `%s`\n", s_flog.filename, segment.pending);
+        if (segment.output != NULL) {
+            fclose(segment.output);
         }
+    } else {
+        queueSegment(&segment);
     }
     s_flog.output = fopen(s_flog.filename, "a");
     if (s_flog.output == NULL) {
@@ -306,6 +697,27 @@ static int rotateLogFiles(void)
     return 1;
 }
 
+void logger_setRotationCompressor(LogCompressor compress, const char* extension, void* user)
+{
+    std::lock_guard<std::mutex> guard(s_rotator.mutex);
+
+    s_rotator.compress = compress;
+    s_rotator.user = user;
+    s_rotator.extension[0] = '\0';
+    if (compress != NULL && extension != NULL) {
+        strncat(s_rotator.extension, extension, kMaxExtensionLen);
+    }
+}
+
+void logger_waitRotation(void)
+{
+    std::unique_lock<std::mutex> guard(s_rotator.mutex);
+
+    while (!s_rotator.queue.empty() || s_rotator.busy) {
+        s_rotator.idle.wait(guard);
+    }
+}
+
 static long vflog(FILE* fp, char levelc, const char* timestamp, long threadID,
         const char* file, int line, const char* fmt, va_list arg,
         long currentTime, long* flushedTime)
@@ -331,38 +743,27 @@ static long vflog(FILE* fp, char levelc, const char* timestamp, long threadID,
     return totalsize;
 }
 
-void logger_log(LogLevel level, const char* file, int line, const char* fmt, ...)
+static void writeLog(LogLevel level, const struct timeval* now, long threadID,
+        const char* file, int line, const char* fmt, va_list arg)
 {
-    struct timeval now;
     long currentTime; /* milliseconds */
     char levelc;
     char timestamp[32];
-    long threadID;
     va_list carg, farg;
 
-    if (s_logger == 0 || !s_initialized) {
-        assert(0 && "logger is not initialized");
-        return;
-    }
-
-    if (!logger_isEnabled(level)) {
-        return;
-    }
-    gettimeofday(&now, NULL);
-    currentTime = now.tv_sec * 1000 + now.tv_usec / 1000;
+    currentTime = now->tv_sec * 1000 + now->tv_usec / 1000;
     levelc = getLevelChar(level);
-    getTimestamp(&now, timestamp, sizeof(timestamp));
-    threadID = getCurrentThreadID();
+    getTimestamp(now, timestamp, sizeof(timestamp));
     lock();
     if (hasFlag(s_logger, kConsoleLogger)) {
-        va_start(carg, fmt);
+        va_copy(carg, arg);
         vflog(s_clog.output, levelc, timestamp, threadID,
                 file, line, fmt, carg, currentTime, &s_clog.flushedTime);
         va_end(carg);
     }
     if (hasFlag(s_logger, kFileLogger)) {
         if (rotateLogFiles()) {
-            va_start(farg, fmt);
+            va_copy(farg, arg);
             s_flog.currentFileSize += vflog(s_flog.output, levelc, timestamp, threadID,
                     file, line, fmt, farg, currentTime, &s_flog.flushedTime);
             va_end(farg);
@@ -371,3 +772,1059 @@ void logger_log(LogLevel level, const char* file, int line, const char* fmt, ...
     unlock();
 }
 
+static void writeLogf(LogLevel level, const struct timeval* now, long threadID,
+        const char* file, int line, const char* fmt, ...)
+{
+    va_list arg;
+
+    va_start(arg, fmt);
+    writeLog(level, now, threadID, file, line, fmt, arg);
+    va_end(arg);
+}
+
+/*
+ * Deferred formatting
+ *
+ * A format string is parsed once into the kinds of its arguments (LogFormat), after
+ * which a call only has to copy its raw arguments; the text is produced later by
+ * formatArgs(), one conversion at a time with snprintf, on the writer thread or by
+ * logger_decodeBinaryFile(). The arguments are laid out the same way in the rings and
+ * in binary log files: integers and pointers as 8 bytes, floating point as double or
+ * long double, and strings as a 32-bit length and the bytes, copied at the call since
+ * the pointer may not outlive it. Formats with a conversion that can't be carried this
+ * way (%n, %ls, %lc) or with too many arguments are formatted at the call as before.
+ */
+enum {
+    kMaxLogArgs = 16,
+    kMaxStringArg = 255, /* bytes kept of a %s argument */
+    kFormatTableSize = 1024, /* distinct formats that can be deferred, a power of two */
+    kFormatProbes = 32,
+};
+
+enum {
+    kArgInt = 1,
+    kArgLong,
+    kArgLongLong,
+    kArgIntMax,
+    kArgSize,
+    kArgPtrdiff,
+    kArgDouble,
+    kArgLongDouble,
+    kArgString,
+    kArgPointer,
+};
+
+enum {
+    kLengthNone,
+    kLengthHH,
+    kLengthH,
+    kLengthL,
+    kLengthLL,
+    kLengthJ,
+    kLengthZ,
+    kLengthT,
+    kLengthBigL,
+};
+
+typedef struct {
+    char flags[8];
+    int width; /* -1 if none, -2 for '*' */
+    int precision; /* -1 if none, -2 for '*' */
+    int length;
+    char conversion;
+} LogSpec;
+
+typedef struct {
+    int count;
+    unsigned char kinds[kMaxLogArgs];
+    int precisions[kMaxLogArgs]; /* of each kArgString: -1 if none, -2 for '*' (the kArgInt before it) */
+} LogFormat;
+
+typedef struct {
+    std::atomic<const char*> fmt;
+    std::atomic<int> state; /* 0 while being parsed, 1 deferred, 2 formatted at the call */
+    LogFormat format;
+} LogFormatSlot;
+
+static LogFormatSlot s_formats[kFormatTableSize];
+
+/* Parses the conversion after a '%'; returns the character after it, or NULL at the end of fmt */
+static const char* parseSpec(const char* p, LogSpec* spec)
+{
+    size_t n = 0;
+
+    while (*p != '\0' && strchr("-+ #0'", *p) != NULL) {
+        if (n + 1 < sizeof(spec->flags)) {
+            spec->flags[n++] = *p;
+        }
+        p++;
+    }
+    spec->flags[n] = '\0';
+    spec->width = -1;
+    if (*p == '*') {
+        spec->width = -2;
+        p++;
+    } else if (isdigit((unsigned char) *p)) {
+        spec->width = 0;
+        while (isdigit((unsigned char) *p)) {
+            spec->width = (spec->width < 100000) ? spec->width * 10 + (*p - '0') : spec->width;
+            p++;
+        }
+    }
+    spec->precision = -1;
+    if (*p == '.') {
+        p++;
+        spec->precision = 0;
+        if (*p == '*') {
+            spec->precision = -2;
+            p++;
+        }
+        while (isdigit((unsigned char) *p)) {
+            spec->precision = (spec->precision < 100000) ? spec->precision * 10 + (*p - '0') : spec->precision;
+            p++;
+        }
+    }
+    spec->length = kLengthNone;
+    switch (*p) {
+        case 'h': p++; spec->length = (*p == 'h') ? (p++, kLengthHH) : kLengthH; break;
+        case 'l': p++; spec->length = (*p == 'l') ? (p++, kLengthLL) : kLengthL; break;
+        case 'q': p++; spec->length = kLengthLL; break;
+        case 'j': p++; spec->length = kLengthJ; break;
+        case 'z': p++; spec->length = kLengthZ; break;
+        case 't': p++; spec->length = kLengthT; break;
+        case 'L': p++; spec->length = kLengthBigL; break;
+        default: break;
+    }
+    spec->conversion = *p;
+    return (*p == '\0') ? NULL : p + 1;
+}
+
+/* The argument kind of a conversion, 0 if it can't be deferred */
+static int specKind(const LogSpec* spec)
+{
+    switch (spec->conversion) {
+        case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+            switch (spec->length) {
+                case kLengthNone: case kLengthHH: case kLengthH: return kArgInt;
+                case kLengthL: return kArgLong;
+                case kLengthLL: return kArgLongLong;
+                case kLengthJ: return kArgIntMax;
+                case kLengthZ: return kArgSize;
+                case kLengthT: return kArgPtrdiff;
+                default: return 0;
+            }
+        case 'c':
+            return (spec->length == kLengthNone) ? kArgInt : 0;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            if (spec->length == kLengthBigL) {
+                return kArgLongDouble;
+            }
+            return (spec->length == kLengthNone || spec->length == kLengthL) ? kArgDouble : 0;
+        case 's':
+            return (spec->length == kLengthNone) ? kArgString : 0;
+        case 'p':
+            return (spec->length == kLengthNone) ? kArgPointer : 0;
+        default:
+            return 0;
+    }
+}
+
+static int parseFormat(const char* fmt, LogFormat* format)
+{
+    const char* p = fmt;
+    LogSpec spec;
+    int kind;
+
+    format->count = 0;
+    while (*p != '\0') {
+        if (*p++ != '%') {
+            continue;
+        }
+        if (*p == '%') {
+            p++;
+            continue;
+        }
+        if ((p = parseSpec(p, &spec)) == NULL || (kind = specKind(&spec)) == 0) {
+            return 0;
+        }
+        if (format->count + 1 + (spec.width == -2) + (spec.precision == -2) > kMaxLogArgs) {
+            return 0;
+        }
+        if (spec.width == -2) {
+            format->kinds[format->count++] = kArgInt;
+        }
+        if (spec.precision == -2) {
+            format->kinds[format->count++] = kArgInt;
+        }
+        format->precisions[format->count] = spec.precision;
+        format->kinds[format->count++] = (unsigned char) kind;
+    }
+    return 1;
+}
+
+/* The parsed format of fmt, NULL if it has to be formatted at the call */
+static const LogFormat* lookupFormat(const char* fmt)
+{
+    size_t index = (size_t) (((uintptr_t) fmt >> 3) ^ ((uintptr_t) fmt >> 13)) & (kFormatTableSize - 1);
+    const char* key;
+    LogFormatSlot* slot;
+    int probe;
+    int state;
+
+    for (probe = 0; probe < kFormatProbes; probe++, index = (index + 1) & (kFormatTableSize - 1)) {
+        slot = &s_formats[index];
+        key = slot->fmt.load(std::memory_order_acquire);
+        if (key == NULL && slot->fmt.compare_exchange_strong(key, fmt)) {
+            state = parseFormat(fmt, &slot->format) ? 1 : 2;
+            slot->state.store(state, std::memory_order_release);
+            return (state == 1) ? &slot->format : NULL;
+        }
+        if (key == fmt) {
+            /* Still 0 while another thread parses it; this call just formats */
+            return (slot->state.load(std::memory_order_acquire) == 1) ? &slot->format : NULL;
+        }
+    }
+    return NULL;
+}
+
+static unsigned char* putInt64(unsigned char* p, int64_t value)
+{
+    memcpy(p, &value, sizeof(value));
+    return p + sizeof(value);
+}
+
+/* Copies the arguments described by format to out, at most kMaxPayload bytes; returns the bytes used */
+static size_t captureArgs(const LogFormat* format, unsigned char* out, va_list arg)
+{
+    unsigned char* p = out;
+    const char* text;
+    double d;
+    long double ld;
+    size_t room;
+    uint32_t len;
+    int star = -1; /* the last int argument, a '*' precision when a string follows it */
+    int precision;
+    int i;
+
+    for (i = 0; i < format->count; i++) {
+        switch (format->kinds[i]) {
+            case kArgInt:
+                star = va_arg(arg, int);
+                p = putInt64(p, star);
+                break;
+            case kArgLong: p = putInt64(p, va_arg(arg, long)); break;
+            case kArgLongLong: p = putInt64(p, va_arg(arg, long long)); break;
+            case kArgIntMax: p = putInt64(p, (int64_t) va_arg(arg, intmax_t)); break;
+            case kArgSize: p = putInt64(p, (int64_t) va_arg(arg, size_t)); break;
+            case kArgPtrdiff: p = putInt64(p, (int64_t) va_arg(arg, ptrdiff_t)); break;
+            case kArgPointer: p = putInt64(p, (int64_t) (uintptr_t) va_arg(arg, void*)); break;
+            case kArgDouble:
+                d = va_arg(arg, double);
+                memcpy(p, &d, sizeof(d));
+                p += sizeof(d);
+                break;
+            case kArgLongDouble:
+                ld = va_arg(arg, long double);
+                memcpy(p, &ld, sizeof(ld));
+                p += sizeof(ld);
+                break;
+            case kArgString:
+                text = va_arg(arg, const char*);
+                text = (text != NULL) ? text : "(null)";
+                /* What is left after keeping 16 bytes for each argument still to come */
+                room = kMaxPayload - (size_t) (p - out) - sizeof(len) - 16 * (format->count - i - 1);
+                room = (room < (size_t) kMaxStringArg) ? room : (size_t) kMaxStringArg;
+                /* With a precision the string needn't be null-terminated; never read past it */
+                precision = (format->precisions[i] == -2) ? star : format->precisions[i];
+                if (precision >= 0 && (size_t) precision < room) {
+                    room = (size_t) precision;
+                }
+                len = 0;
+                while (len < room && text[len] != '\0') {
+                    len++;
+                }
+                memcpy(p, &len, sizeof(len));
+                memcpy(p + sizeof(len), text, len);
+                p += sizeof(len) + len;
+                break;
+            default:
+                break;
+        }
+    }
+    return (size_t) (p - out);
+}
+
+static int64_t getInt64(const unsigned char** p, const unsigned char* end)
+{
+    int64_t value = 0;
+
+    if (end - *p >= (ptrdiff_t) sizeof(value)) {
+        memcpy(&value, *p, sizeof(value));
+        *p += sizeof(value);
+    }
+    return value;
+}
+
+/*
+ * Formats fmt with arguments captured by captureArgs() into out. Missing argument
+ * bytes read as zero, so a damaged binary log can't make this read out of bounds.
+ */
+static void formatArgs(char* out, size_t size, const char* fmt, const unsigned char* args, size_t argBytes)
+{
+    static const char* const lengths[] = { "", "hh", "h", "l", "ll", "j", "z", "t", "L" };
+    const unsigned char* a = args;
+    const unsigned char* end = args + argBytes;
+    const char* p = fmt;
+    const char* next;
+    char spec[48];
+    char text[kMaxPayload];
+    char flags[10];
+    char width[16];
+    char precision[16];
+    LogSpec s;
+    size_t n = 0;
+    double d;
+    long double ld;
+    uint32_t len;
+    int w, r;
+
+    if (size == 0) {
+        return;
+    }
+    while (*p != '\0' && n + 1 < size) {
+        if (*p != '%' || p[1] == '%') {
+            out[n++] = *p;
+            p += (*p == '%') ? 2 : 1;
+            continue;
+        }
+        if ((next = parseSpec(p + 1, &s)) == NULL) {
+            break;
+        }
+        p = next;
+        strcpy(flags, s.flags);
+        width[0] = '\0';
+        precision[0] = '\0';
+        if (s.width != -1) {
+            w = (s.width == -2) ? (int) getInt64(&a, end) : s.width;
+            if (w < 0) {
+                /* A negative '*' width means left-justified */
+                strcat(flags, "-");
+                w = -w;
+            }
+            sprintf(width, "%d", w);
+        }
+        if (s.precision != -1) {
+            w = (s.precision == -2) ? (int) getInt64(&a, end) : s.precision;
+            if (w >= 0) {
+                sprintf(precision, ".%d", w);
+            }
+        }
+        sprintf(spec, "%%%s%s%s%s%c", flags, width, precision, lengths[s.length], s.conversion);
+
+        r = 0;
+        switch (specKind(&s)) {
+            case kArgInt: r = snprintf(out + n, size - n, spec, (int) getInt64(&a, end)); break;
+            case kArgLong: r = snprintf(out + n, size - n, spec, (long) getInt64(&a, end)); break;
+            case kArgLongLong: r = snprintf(out + n, size - n, spec, (long long) getInt64(&a, end)); break;
+            case kArgIntMax: r = snprintf(out + n, size - n, spec, (intmax_t) getInt64(&a, end)); break;
+            case kArgSize: r = snprintf(out + n, size - n, spec, (size_t) getInt64(&a, end)); break;
+            case kArgPtrdiff: r = snprintf(out + n, size - n, spec, (ptrdiff_t) getInt64(&a, end)); break;
+            case kArgPointer: r = snprintf(out + n, size - n, spec, (void*) (uintptr_t) getInt64(&a, end)); break;
+            case kArgDouble:
+                d = 0;
+                if (end - a >= (ptrdiff_t) sizeof(d)) {
+                    memcpy(&d, a, sizeof(d));
+                    a += sizeof(d);
+                }
+                r = snprintf(out + n, size - n, spec, d);
+                break;
+            case kArgLongDouble:
+                ld = 0;
+                if (end - a >= (ptrdiff_t) sizeof(ld)) {
+                    memcpy(&ld, a, sizeof(ld));
+                    a += sizeof(ld);
+                }
+                r = snprintf(out + n, size - n, spec, ld);
+                break;
+            case kArgString:
+                len = 0;
+                if (end - a >= (ptrdiff_t) sizeof(len)) {
+                    memcpy(&len, a, sizeof(len));
+                    a += sizeof(len);
+                }
+                len = (len <= (uint32_t) (end - a)) ? len : (uint32_t) (end - a);
+                len = (len < sizeof(text)) ? len : (uint32_t) sizeof(text) - 1;
+                memcpy(text, a, len);
+                text[len] = '\0';
+                a += len;
+                r = snprintf(out + n, size - n, spec, text);
+                break;
+            default:
+                break;
+        }
+        if (r > 0) {
+            n += ((size_t) r < size - n) ? (size_t) r : size - n - 1;
+        }
+    }
+    out[n] = '\0';
+}
+
+/*
+ * Async logger
+ *
+ * Every thread that logs owns a single-producer/single-consumer byte ring; the writer
+ * thread is the only consumer of all of them. A record is a LogRecord header followed
+ * by the message text or its captured arguments, padded to 8 bytes. A record never wraps: when it does not fit
+ * before the end of the ring, a padding record fills the rest and it starts over at
+ * offset 0. head and tail are running byte counts, so head - tail is the fill level.
+ *
+ * Rings are kept for the life of the process. When a thread exits its ring is marked
+ * free and the next new thread takes it over, so memory is bounded by the number of
+ * threads logging at once rather than by the number of threads ever started.
+ */
+enum {
+    kRecordText = 1, /* a formatted, null-terminated message */
+    kRecordArgs = 2, /* fmt and its arguments, formatted by the writer */
+    kRecordPadding = 3,
+};
+
+typedef struct {
+    uint32_t size; /* bytes including this header and the padding */
+    uint16_t kind;
+    uint16_t level;
+    int line;
+    uint32_t length; /* bytes of text or arguments after the header */
+    const char* file;
+    const char* fmt; /* kRecordArgs only */
+    int64_t time; /* steady clock nanoseconds, see wallTime() */
+    long threadID; /* of the caller; a ring outlives its threads */
+} LogRecord;
+
+typedef struct LogRing {
+    unsigned char* buffer;
+    size_t size; /* a power of two */
+    long lastThreadID; /* writer thread only: thread of the last record written */
+    std::atomic<uint64_t> head; /* written by the owning thread */
+    std::atomic<uint64_t> tail; /* written by the writer thread */
+    std::atomic<uint64_t> dropped;
+    uint64_t droppedReported; /* writer thread only */
+    std::atomic<bool> inUse;
+    struct LogRing* next;
+} LogRing;
+
+static struct {
+    std::atomic<bool> running;
+    std::atomic<bool> deferred;
+    std::atomic<bool> stop;
+    std::atomic<LogRing*> rings;
+    std::atomic<uint64_t> flushRequested;
+    std::atomic<uint64_t> flushDone;
+    std::atomic<size_t> ringSize;
+    std::atomic<int> policy;
+    std::mutex mutex; /* only for sleeping and waking, never held while logging */
+    std::condition_variable wake;
+    std::condition_variable flushed;
+    std::thread writer;
+    bool exitHandler; /* stopAtExit() is registered */
+} s_async;
+
+/* Binary file logger, written by the writer thread under the logger mutex */
+static struct {
+    FILE* output;
+    std::unordered_map<const char*, uint32_t>* ids; /* format and file name strings written so far */
+} s_blog;
+
+/* A steady clock reading and the wall clock time at that moment, to date steady timestamps */
+static struct {
+    std::atomic<bool> set;
+    int64_t steady; /* nanoseconds */
+    int64_t wall; /* microseconds since the epoch */
+} s_clockBase;
+
+static int64_t steadyNs(void)
+{
+    return (int64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void setClockBase(void)
+{
+    struct timeval now;
+
+    if (s_clockBase.set.load()) {
+        return;
+    }
+    gettimeofday(&now, NULL);
+    s_clockBase.steady = steadyNs();
+    s_clockBase.wall = (int64_t) now.tv_sec * 1000000 + now.tv_usec;
+    s_clockBase.set.store(true);
+}
+
+static void wallTime(int64_t steady, int64_t baseSteady, int64_t baseWall, struct timeval* time)
+{
+    const int64_t wall = baseWall + (steady - baseSteady) / 1000;
+
+    time->tv_sec = (long) (wall / 1000000);
+    time->tv_usec = (long) (wall % 1000000);
+}
+
+static size_t alignRecord(size_t size)
+{
+    return (size + 7) & ~(size_t) 7;
+}
+
+static LogRing* createRing(size_t size)
+{
+    LogRing* ring = new (std::nothrow) LogRing;
+
+    if (ring == NULL) {
+        return NULL;
+    }
+    ring->buffer = (unsigned char*) malloc(size);
+    if (ring->buffer == NULL) {
+        delete ring;
+        return NULL;
+    }
+    ring->size = size;
+    ring->lastThreadID = 0;
+    ring->head.store(0);
+    ring->tail.store(0);
+    ring->dropped.store(0);
+    ring->droppedReported = 0;
+    ring->inUse.store(true);
+    ring->next = NULL;
+    return ring;
+}
+
+/* Takes over a ring left by a thread that has exited, or adds a new one to the list */
+static LogRing* acquireRing(void)
+{
+    LogRing* ring;
+    LogRing* head;
+    bool expected;
+
+    for (ring = s_async.rings.load(); ring != NULL; ring = ring->next) {
+        expected = false;
+        if (!ring->inUse.load(std::memory_order_relaxed)
+                && ring->inUse.compare_exchange_strong(expected, true)) {
+            return ring;
+        }
+    }
+    ring = createRing(s_async.ringSize.load());
+    if (ring == NULL) {
+        return NULL;
+    }
+    head = s_async.rings.load();
+    do {
+        ring->next = head;
+    } while (!s_async.rings.compare_exchange_weak(head, ring));
+    return ring;
+}
+
+/* The calling thread's ring, released when the thread exits */
+struct LogRingOwner {
+    LogRing* ring;
+    long threadID;
+
+    LogRingOwner() : ring(NULL), threadID(0) {}
+    ~LogRingOwner()
+    {
+        if (ring != NULL) {
+            ring->inUse.store(false);
+        }
+    }
+};
+
+static thread_local LogRingOwner t_ringOwner;
+
+static void wakeWriter(void)
+{
+    std::lock_guard<std::mutex> guard(s_async.mutex);
+    s_async.wake.notify_one();
+}
+
+/*
+ * Reserves size contiguous bytes (a multiple of 8) in the ring, writing a padding
+ * record first when they would not fit before the end. Returns NULL when the ring is
+ * full; the record only becomes visible to the writer with commitRecord().
+ */
+static unsigned char* reserveRecord(LogRing* ring, size_t size, uint64_t* newHead)
+{
+    uint64_t head = ring->head.load(std::memory_order_relaxed);
+    const uint64_t tail = ring->tail.load(std::memory_order_acquire);
+    size_t offset = (size_t) (head & (ring->size - 1));
+    const size_t contiguous = ring->size - offset;
+    const size_t needed = (contiguous < size) ? contiguous + size : size;
+
+    if (head + needed - tail > ring->size) {
+        return NULL;
+    }
+    if (contiguous < size) {
+        LogRecord* padding = (LogRecord*) (ring->buffer + offset);
+        padding->size = (uint32_t) contiguous;
+        padding->kind = kRecordPadding;
+        head += contiguous;
+        offset = 0;
+    }
+    *newHead = head + size;
+    return ring->buffer + offset;
+}
+
+static void commitRecord(LogRing* ring, uint64_t newHead)
+{
+    ring->head.store(newHead, std::memory_order_release);
+}
+
+static void asyncLog(LogLevel level, const char* file, int line, const char* fmt, int deferrable, va_list arg)
+{
+    LogRing* ring = t_ringOwner.ring;
+    const LogFormat* format = NULL;
+    unsigned char payload[kMaxPayload];
+    LogRecord* record;
+    unsigned char* p;
+    uint64_t newHead;
+    size_t length;
+    size_t size;
+    int len;
+
+    if (ring == NULL) {
+        ring = t_ringOwner.ring = acquireRing();
+        if (ring == NULL) {
+            return;
+        }
+        t_ringOwner.threadID = getCurrentThreadID();
+    }
+    if (deferrable && s_async.deferred.load(std::memory_order_relaxed)) {
+        format = lookupFormat(fmt);
+    }
+    if (format != NULL) {
+        length = captureArgs(format, payload, arg);
+    } else {
+        len = vsnprintf((char*) payload, sizeof(payload), fmt, arg);
+        if (len < 0) {
+            return;
+        }
+        length = ((size_t) len < sizeof(payload)) ? (size_t) len + 1 : sizeof(payload);
+        payload[length - 1] = '\0';
+    }
+    size = alignRecord(sizeof(LogRecord) + length);
+
+    while ((p = reserveRecord(ring, size, &newHead)) == NULL) {
+        if (s_async.policy.load(std::memory_order_relaxed) != LogOverflow_BLOCK
+                || !s_async.running.load(std::memory_order_relaxed)) {
+            ring->dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        wakeWriter();
+        std::this_thread::yield();
+    }
+    record = (LogRecord*) p;
+    record->size = (uint32_t) size;
+    record->kind = (format != NULL) ? kRecordArgs : kRecordText;
+    record->level = (uint16_t) level;
+    record->line = line;
+    record->length = (uint32_t) length;
+    record->file = file;
+    record->fmt = fmt;
+    record->time = steadyNs();
+    record->threadID = t_ringOwner.threadID;
+    memcpy(p + sizeof(LogRecord), payload, length);
+    commitRecord(ring, newHead);
+}
+
+/* The next record of the ring, skipping padding; NULL if it is empty */
+static const LogRecord* peekRecord(LogRing* ring)
+{
+    const uint64_t head = ring->head.load(std::memory_order_acquire);
+    uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+    const LogRecord* record;
+
+    while (tail != head) {
+        record = (const LogRecord*) (ring->buffer + (tail & (ring->size - 1)));
+        if (record->kind != kRecordPadding) {
+            return record;
+        }
+        tail += record->size;
+        ring->tail.store(tail, std::memory_order_release);
+    }
+    return NULL;
+}
+
+static void popRecord(LogRing* ring, const LogRecord* record)
+{
+    ring->tail.store(ring->tail.load(std::memory_order_relaxed) + record->size, std::memory_order_release);
+}
+
+/*
+ * Binary log file: an 8-byte magic and the clock base (steady ns, wall us), then
+ * entries starting with a tag byte. 'S' defines a string (u32 id, u32 length, bytes),
+ * used for format strings and file names, each written once. 'R' is a record: u8
+ * level, i32 line, u32 file id, u32 format id, i64 thread ID, i64 steady ns, u32
+ * argument bytes and the arguments, as captured. Fields are in native byte order.
+ */
+static const char kBinaryMagic[8] = { 'C', 'L', 'O', 'G', 'B', 'I', 'N', '1' };
+
+enum {
+    kBinaryRecordHeaderSize = 33, /* after the tag */
+};
+
+static uint32_t binaryStringId(const char* string)
+{
+    std::unordered_map<const char*, uint32_t>::const_iterator found = s_blog.ids->find(string);
+    uint32_t id, len;
+
+    if (found != s_blog.ids->end()) {
+        return found->second;
+    }
+    id = (uint32_t) s_blog.ids->size() + 1;
+    len = (uint32_t) strlen(string);
+    (*s_blog.ids)[string] = id;
+    fputc('S', s_blog.output);
+    fwrite(&id, sizeof(id), 1, s_blog.output);
+    fwrite(&len, sizeof(len), 1, s_blog.output);
+    fwrite(string, 1, len, s_blog.output);
+    return id;
+}
+
+static void writeBinaryRecord(const LogRecord* record)
+{
+    unsigned char header[kBinaryRecordHeaderSize];
+    const unsigned char* payload = (const unsigned char*) (record + 1);
+    const int64_t thread = record->threadID;
+    uint32_t fileID, formatID, argBytes, len;
+
+    lock();
+    if (s_blog.output != NULL) {
+        fileID = binaryStringId(record->file);
+        /* A message formatted at the call is stored as the argument of "%s" */
+        formatID = binaryStringId((record->kind == kRecordArgs) ? record->fmt : "%s");
+        len = record->length - 1;
+        argBytes = (record->kind == kRecordArgs) ? record->length : (uint32_t) sizeof(len) + len;
+        header[0] = (unsigned char) record->level;
+        memcpy(header + 1, &record->line, 4);
+        memcpy(header + 5, &fileID, 4);
+        memcpy(header + 9, &formatID, 4);
+        memcpy(header + 13, &thread, 8);
+        memcpy(header + 21, &record->time, 8);
+        memcpy(header + 29, &argBytes, 4);
+        fputc('R', s_blog.output);
+        fwrite(header, 1, sizeof(header), s_blog.output);
+        if (record->kind != kRecordArgs) {
+            fwrite(&len, sizeof(len), 1, s_blog.output);
+        }
+        fwrite(payload, 1, (record->kind == kRecordArgs) ? record->length : len, s_blog.output);
+    }
+    unlock();
+}
+
+static void writeRecord(const LogRecord* record)
+{
+    const char* text = (const char*) (record + 1);
+    char message[kMaxPayload];
+    struct timeval time;
+
+    if (hasFlag(s_logger, kBinaryLogger)) {
+        writeBinaryRecord(record);
+    }
+    if ((s_logger & (kConsoleLogger | kFileLogger)) == 0) {
+        return;
+    }
+    if (record->kind == kRecordArgs) {
+        formatArgs(message, sizeof(message), record->fmt, (const unsigned char*) (record + 1), record->length);
+        text = message;
+    }
+    wallTime(record->time, s_clockBase.steady, s_clockBase.wall, &time);
+    writeLogf((LogLevel) record->level, &time, record->threadID, record->file, record->line, "%s", text);
+}
+
+/*
+ * Writes everything in the rings, oldest first across threads, and reports records
+ * dropped since the last drain. Returns the number of records written.
+ */
+static long drainRings(void)
+{
+    LogRing* ring;
+    LogRing* oldest;
+    const LogRecord* record;
+    const LogRecord* oldestRecord;
+    long written = 0;
+    uint64_t dropped;
+    struct timeval now;
+
+    for (;;) {
+        oldest = NULL;
+        oldestRecord = NULL;
+        for (ring = s_async.rings.load(); ring != NULL; ring = ring->next) {
+            record = peekRecord(ring);
+            if (record != NULL && (oldestRecord == NULL || record->time < oldestRecord->time)) {
+                oldest = ring;
+                oldestRecord = record;
+            }
+        }
+        if (oldest == NULL) {
+            break;
+        }
+        writeRecord(oldestRecord);
+        oldest->lastThreadID = oldestRecord->threadID;
+        popRecord(oldest, oldestRecord);
+        written++;
+    }
+    for (ring = s_async.rings.load(); ring != NULL; ring = ring->next) {
+        dropped = ring->dropped.load(std::memory_order_relaxed);
+        if (dropped != ring->droppedReported) {
+            gettimeofday(&now, NULL);
+            writeLogf(LogLevel_WARN, &now, ring->lastThreadID, __FILENAME__, __LINE__,
+                    "logger: %llu messages dropped, ring full",
+                    (unsigned long long) (dropped - ring->droppedReported));
+            ring->droppedReported = dropped;
+        }
+    }
+    return written;
+}
+
+static void writerMain(void)
+{
+    uint64_t request;
+    bool stopping;
+    long written;
+
+    for (;;) {
+        /* Both are read before the drain, so it covers every record logged before them */
+        stopping = s_async.stop.load();
+        request = s_async.flushRequested.load();
+        written = drainRings();
+        if (request != s_async.flushDone.load()) {
+            flushOutputs();
+            std::lock_guard<std::mutex> guard(s_async.mutex);
+            s_async.flushDone.store(request);
+            s_async.flushed.notify_all();
+        }
+        if (written > 0) {
+            continue;
+        }
+        if (stopping) {
+            return;
+        }
+        /* Producers never wake the writer (that would cost them a system call), so it polls */
+        std::unique_lock<std::mutex> lock(s_async.mutex);
+        if (!s_async.stop.load() && s_async.flushRequested.load() == s_async.flushDone.load()) {
+            s_async.wake.wait_for(lock, std::chrono::milliseconds(kAsyncPollInterval));
+        }
+    }
+}
+
+/* Waits until the writer has written and flushed everything logged so far */
+static void flushAsync(void)
+{
+    uint64_t request;
+
+    if (!s_async.running.load()) {
+        return;
+    }
+    request = s_async.flushRequested.fetch_add(1) + 1;
+    std::unique_lock<std::mutex> lock(s_async.mutex);
+    s_async.wake.notify_one();
+    while (s_async.flushDone.load() < request && s_async.running.load()) {
+        s_async.flushed.wait_for(lock, std::chrono::milliseconds(kAsyncPollInterval));
+    }
+}
+
+/* A writer still running at exit would take the pending records with it and abort the program */
+static void stopAtExit(void)
+{
+    logger_stopAsync();
+}
+
+int logger_startAsync(size_t ringSize, LogOverflowPolicy policy)
+{
+    size_t size = kMinRingSize;
+
+    if (s_logger == 0 || !s_initialized) {
+        assert(0 && "logger is not initialized");
+        return 0;
+    }
+    if (s_async.running.load()) {
+        return 1;
+    }
+    ringSize = (ringSize > 0) ? ringSize : (size_t) kDefaultRingSize;
+    while (size < ringSize) {
+        size <<= 1;
+    }
+    setClockBase();
+    s_async.ringSize.store(size);
+    s_async.policy.store(policy);
+    s_async.stop.store(false);
+    try {
+        s_async.writer = std::thread(writerMain);
+    } catch (...) {
+        return 0;
+    }
+    s_async.running.store(true);
+    if (!s_async.exitHandler) {
+        atexit(stopAtExit);
+        s_async.exitHandler = true;
+    }
+    return 1;
+}
+
+void logger_stopAsync(void)
+{
+    if (!s_async.running.load()) {
+        return;
+    }
+    s_async.running.store(false);
+    s_async.stop.store(true);
+    wakeWriter();
+    s_async.writer.join();
+    flushOutputs();
+}
+
+unsigned long long logger_getDroppedCount(void)
+{
+    unsigned long long dropped = 0;
+    LogRing* ring;
+
+    for (ring = s_async.rings.load(); ring != NULL; ring = ring->next) {
+        dropped += ring->dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+}
+
+void logger_setDeferredFormatting(int enable)
+{
+    s_async.deferred.store(enable != 0);
+}
+
+int logger_initBinaryFileLogger(const char* filename)
+{
+    int ok = 0; /* false */
+
+    if (filename == NULL) {
+        assert(0 && "filename must not be NULL");
+        return 0;
+    }
+
+    init();
+    setClockBase();
+    lock();
+    if (s_blog.output != NULL) { /* reinit */
+        fclose(s_blog.output);
+    }
+    if (s_blog.ids == NULL) {
+        s_blog.ids = new (std::nothrow) std::unordered_map<const char*, uint32_t>;
+    }
+    s_blog.output = (s_blog.ids != NULL) ? fopen(filename, "wb") : NULL;
+    if (s_blog.output == NULL) {
+        fprintf(stderr, "ERROR: logger: Failed to open file: `%s`\n", filename);
+        goto cleanup;
+    }
+    s_blog.ids->clear();
+    fwrite(kBinaryMagic, 1, sizeof(kBinaryMagic), s_blog.output);
+    fwrite(&s_clockBase.steady, sizeof(s_clockBase.steady), 1, s_blog.output);
+    fwrite(&s_clockBase.wall, sizeof(s_clockBase.wall), 1, s_blog.output);
+    s_logger |= kBinaryLogger;
+    ok = 1; /* true */
+cleanup:
+    unlock();
+    return ok;
+}
+
+long logger_decodeBinaryFile(const char* filename, FILE* output)
+{
+    std::unordered_map<uint32_t, std::string> strings;
+    unsigned char header[kBinaryRecordHeaderSize];
+    unsigned char* args = NULL;
+    char magic[sizeof(kBinaryMagic)];
+    char message[kMaxPayload];
+    char timestamp[32];
+    struct timeval time;
+    int64_t baseSteady, baseWall, thread, steady;
+    uint32_t id, len, fileID, formatID, argBytes;
+    int32_t line;
+    long count = 0;
+    FILE* fp;
+    int tag;
+
+    if (filename == NULL || output == NULL || (fp = fopen(filename, "rb")) == NULL) {
+        return -1;
+    }
+    if (fread(magic, 1, sizeof(magic), fp) != sizeof(magic) || memcmp(magic, kBinaryMagic, sizeof(magic)) != 0
+            || fread(&baseSteady, sizeof(baseSteady), 1, fp) != 1 || fread(&baseWall, sizeof(baseWall), 1, fp) != 1) {
+        fclose(fp);
+        return -1;
+    }
+    args = (unsigned char*) malloc(kMaxPayload + sizeof(len));
+    while (args != NULL && (tag = fgetc(fp)) != EOF) {
+        if (tag == 'S') {
+            if (fread(&id, sizeof(id), 1, fp) != 1 || fread(&len, sizeof(len), 1, fp) != 1 || len > 65536) {
+                break;
+            }
+            std::string& string = strings[id];
+            string.resize(len);
+            if (len > 0 && fread(&string[0], 1, len, fp) != len) {
+                break;
+            }
+        } else if (tag == 'R') {
+            if (fread(header, 1, sizeof(header), fp) != sizeof(header)) {
+                break;
+            }
+            memcpy(&line, header + 1, 4);
+            memcpy(&fileID, header + 5, 4);
+            memcpy(&formatID, header + 9, 4);
+            memcpy(&thread, header + 13, 8);
+            memcpy(&steady, header + 21, 8);
+            memcpy(&argBytes, header + 29, 4);
+            if (argBytes > kMaxPayload + sizeof(len) || fread(args, 1, argBytes, fp) != argBytes) {
+                break;
+            }
+            formatArgs(message, sizeof(message), strings[formatID].c_str(), args, argBytes);
+            wallTime(steady, baseSteady, baseWall, &time);
+            getTimestamp(&time, timestamp, sizeof(timestamp));
+            fprintf(output, "%c %s %ld %s:%d: %s\n", getLevelChar((LogLevel) header[0]), timestamp,
+                    (long) thread, strings[fileID].c_str(), (int) line, message);
+            count++;
+        } else {
+            break;
+        }
+    }
+    free(args);
+    fclose(fp);
+    return count;
+}
+
+static void logv(LogLevel level, const char* file, int line, const char* fmt, int deferrable, va_list arg)
+{
+    struct timeval now;
+
+    if (s_logger == 0 || !s_initialized) {
+        assert(0 && "logger is not initialized");
+        return;
+    }
+    if (s_async.running.load(std::memory_order_acquire)) {
+        asyncLog(level, file, line, fmt, deferrable, arg);
+    } else {
+        gettimeofday(&now, NULL);
+        writeLog(level, &now, getCurrentThreadID(), file, line, fmt, arg);
+    }
+}
+
+void logger_log(LogLevel level, const char* file, int line, const char* fmt, ...)
+{
+    va_list arg;
+
+    if (!logger_isEnabled(level)) {
+        return;
+    }
+    va_start(arg, fmt);
+    logv(level, file, line, fmt, 0, arg);
+    va_end(arg);
+}
+
+void logger_logStatic(LogLevel level, const char* file, int line, const char* fmt, ...)
+{
+    va_list arg;
+
+    va_start(arg, fmt);
+    logv(level, file, line, fmt, 1, arg);
+    va_end(arg);
+}
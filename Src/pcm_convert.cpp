@@ -0,0 +1,165 @@
+#include <stddef.h>
+#include <atomic>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#include "../Include/pcm_convert_simd.h"
+
+namespace
+{
+
+const TPcmKernels s_kernels_c =
+{
+	kPcmIsaC,
+	pcm_s16_to_f32_c,
+	pcm_s24_to_f32_c,
+	pcm_s32_to_f32_c,
+	pcm_f32_to_s16_c,
+	pcm_f32_to_s16_dither_c,
+	pcm_f32_to_s32_c,
+	pcm_s16_to_s32_c,
+	pcm_s24_to_s32_c,
+	pcm_s24_to_s16_c,
+	pcm_s32_to_s16_c,
+};
+
+std::atomic<const TPcmKernels*> s_kernels(NULL);
+
+TPcmIsa cpu_isa(void)
+{
+#if defined(PCM_CONVERT_X86) && (defined(__GNUC__) || defined(__clang__))
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		return kPcmIsaAVX2;
+	}
+	if (__builtin_cpu_supports("sse2")) {
+		return kPcmIsaSSE2;
+	}
+#elif defined(PCM_CONVERT_X86) && defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	const int max_leaf = info[0];
+	__cpuid(info, 1);
+	const int has_sse2 = (info[3] >> 26) & 1;
+	const int has_os_avx = ((info[2] >> 27) & 1) && ((_xgetbv(0) & 0x06) == 0x06);
+	if (max_leaf >= 7) {
+		__cpuidex(info, 7, 0);
+		if (has_os_avx && ((info[1] >> 5) & 1)) {
+			return kPcmIsaAVX2;
+		}
+	}
+	if (has_sse2) {
+		return kPcmIsaSSE2;
+	}
+#endif
+	return kPcmIsaC;
+}
+
+// The widest table that is built in, supported by the CPU and not wider than isa
+const TPcmKernels* select_kernels(TPcmIsa isa)
+{
+	const TPcmKernels* kernels = NULL;
+	const TPcmIsa cpu = cpu_isa();
+
+	isa = (isa < cpu) ? isa : cpu;
+	if (isa >= kPcmIsaAVX2 && NULL != (kernels = Pcm_kernels_avx2())) {
+		return kernels;
+	}
+	if (isa >= kPcmIsaSSE2 && NULL != (kernels = Pcm_kernels_sse2())) {
+		return kernels;
+	}
+	return &s_kernels_c;
+}
+
+inline const TPcmKernels* kernels(void)
+{
+	const TPcmKernels* k = s_kernels.load(std::memory_order_acquire);
+	if (NULL == k) {
+		k = select_kernels(kPcmIsaAVX2);
+		s_kernels.store(k, std::memory_order_release);
+	}
+	return k;
+}
+
+} // namespace
+
+const TPcmKernels* Pcm_kernels_c(void)
+{
+	return &s_kernels_c;
+}
+
+void Pcm_init_dither(TPcmDither* dither, const unsigned int seed)
+{
+	if (NULL == dither) {
+		return;
+	}
+	// Spread the seed over the generators; xorshift must not start from zero
+	unsigned int x = seed ^ 0x9E3779B9u;
+	for (int lane = 0; lane < 8; lane++)
+	{
+		x = x * 1664525u + 1013904223u;
+		dither->state[lane] = (0 != x) ? x : 0x6A09E667u;
+	}
+}
+
+void Pcm_s16_to_f32(float* data_out, const short* data_in, const size_t count)
+{
+	kernels()->s16_to_f32(data_out, data_in, count);
+}
+
+void Pcm_s24_to_f32(float* data_out, const unsigned char* data_in, const size_t count)
+{
+	kernels()->s24_to_f32(data_out, data_in, count);
+}
+
+void Pcm_s32_to_f32(float* data_out, const int* data_in, const size_t count)
+{
+	kernels()->s32_to_f32(data_out, data_in, count);
+}
+
+void Pcm_f32_to_s16(short* data_out, const float* data_in, const size_t count)
+{
+	kernels()->f32_to_s16(data_out, data_in, count);
+}
+
+void Pcm_f32_to_s16_dither(short* data_out, const float* data_in, const size_t count, TPcmDither* dither)
+{
+	kernels()->f32_to_s16_dither(data_out, data_in, count, dither);
+}
+
+void Pcm_f32_to_s32(int* data_out, const float* data_in, const size_t count)
+{
+	kernels()->f32_to_s32(data_out, data_in, count);
+}
+
+void Pcm_s16_to_s32(int* data_out, const short* data_in, const size_t count)
+{
+	kernels()->s16_to_s32(data_out, data_in, count);
+}
+
+void Pcm_s24_to_s32(int* data_out, const unsigned char* data_in, const size_t count)
+{
+	kernels()->s24_to_s32(data_out, data_in, count);
+}
+
+void Pcm_s24_to_s16(short* data_out, const unsigned char* data_in, const size_t count)
+{
+	kernels()->s24_to_s16(data_out, data_in, count);
+}
+
+void Pcm_s32_to_s16(short* data_out, const int* data_in, const size_t count)
+{
+	kernels()->s32_to_s16(data_out, data_in, count);
+}
+
+TPcmIsa Pcm_get_isa(void)
+{
+	return kernels()->isa;
+}
+
+TPcmIsa Pcm_set_isa(TPcmIsa isa)
+{
+	const TPcmKernels* k = select_kernels(isa);
+	s_kernels.store(k, std::memory_order_release);
+	return k->isa;
+}
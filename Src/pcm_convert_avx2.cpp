@@ -0,0 +1,200 @@
+/*
+ * AVX2 PCM conversions, eight samples per block. Built with -mavx2; only selected
+ * when the CPU supports it.
+ */
+#include "../Include/pcm_convert_simd.h"
+
+#if defined(PCM_CONVERT_X86) && defined(__AVX2__)
+#include <immintrin.h>
+
+namespace
+{
+
+inline __m256i xorshift(__m256i x)
+{
+	x = _mm256_xor_si256(x, _mm256_slli_epi32(x, 13));
+	x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 17));
+	return _mm256_xor_si256(x, _mm256_slli_epi32(x, 5));
+}
+
+// pcm_tpdf for the eight generators
+inline __m256 tpdf(__m256i* state)
+{
+	const __m256 scale = _mm256_set1_ps(1.0f / 16777216.0f);
+	const __m256i a = xorshift(*state);
+	const __m256i b = xorshift(a);
+	*state = b;
+	return _mm256_sub_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(a, 8)), scale),
+		_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(b, 8)), scale));
+}
+
+inline __m128i f32_to_s16_8(const float* data_in, const __m256 dither)
+{
+	__m256 v = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(data_in), _mm256_set1_ps(32768.0f)), dither);
+	v = _mm256_min_ps(_mm256_max_ps(v, _mm256_set1_ps(-32768.0f)), _mm256_set1_ps(32767.0f));
+	const __m256i x = _mm256_cvtps_epi32(v);
+	return _mm_packs_epi32(_mm256_castsi256_si128(x), _mm256_extracti128_si256(x, 1));
+}
+
+/*
+ * Eight packed 24-bit samples as the high three bytes of eight ints. Reads 28 bytes,
+ * four more than the samples occupy.
+ */
+inline __m256i load_s24_8(const unsigned char* data_in)
+{
+	const __m256i shuffle = _mm256_setr_epi8(
+		-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11,
+		-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+	const __m128i lo = _mm_loadu_si128((const __m128i*)data_in);
+	const __m128i hi = _mm_loadu_si128((const __m128i*)(data_in + 12));
+	return _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1), shuffle);
+}
+
+void s16_to_f32(float* data_out, const short* data_in, size_t count)
+{
+	const __m256 scale = _mm256_set1_ps(1.0f / 32768.0f);
+	size_t idx = 0;
+	for (; idx + 8 <= count; idx += 8)
+	{
+		const __m256i x = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(data_in + idx)));
+		_mm256_storeu_ps(data_out + idx, _mm256_mul_ps(_mm256_cvtepi32_ps(x), scale));
+	}
+	pcm_s16_to_f32_c(data_out + idx, data_in + idx, count - idx);
+}
+
+void s24_to_f32(float* data_out, const unsigned char* data_in, size_t count)
+{
+	const __m256 scale = _mm256_set1_ps(1.0f / 8388608.0f);
+	size_t idx = 0;
+	// Two samples of slack cover the over-read of load_s24_8
+	for (; idx + 10 <= count; idx += 8)
+	{
+		const __m256i x = _mm256_srai_epi32(load_s24_8(data_in + 3 * idx), 8);
+		_mm256_storeu_ps(data_out + idx, _mm256_mul_ps(_mm256_cvtepi32_ps(x), scale));
+	}
+	pcm_s24_to_f32_c(data_out + idx, data_in + 3 * idx, count - idx);
+}
+
+void s32_to_f32(float* data_out, const int* data_in, size_t count)
+{
+	const __m256 scale = _mm256_set1_ps(1.0f / 2147483648.0f);
+	size_t idx = 0;
+	for (; idx + 8 <= count; idx += 8)
+	{
+		const __m256i x = _mm256_loadu_si256((const __m256i*)(data_in + idx));
+		_mm256_storeu_ps(data_out + idx, _mm256_mul_ps(_mm256_cvtepi32_ps(x), scale));
+	}
+	pcm_s32_to_f32_c(data_out + idx, data_in + idx, count - idx);
+}
+
+void f32_to_s16(short* data_out, const float* data_in, size_t count)
+{
+	const __m256 zero = _mm256_setzero_ps();
+	size_t idx = 0;
+	for (; idx + 8 <= count; idx += 8)
+	{
+		_mm_storeu_si128((__m128i*)(data_out + idx), f32_to_s16_8(data_in + idx, zero));
+	}
+	pcm_f32_to_s16_c(data_out + idx, data_in + idx, count - idx);
+}
+
+void f32_to_s16_dither(short* data_out, const float* data_in, size_t count, TPcmDither* dither)
+{
+	__m256i state = _mm256_loadu_si256((const __m256i*)dither->state);
+	size_t idx = 0;
+	for (; idx + 8 <= count; idx += 8)
+	{
+		_mm_storeu_si128((__m128i*)(data_out + idx), f32_to_s16_8(data_in + idx, tpdf(&state)));
+	}
+	_mm256_storeu_si256((__m256i*)dither->state, state);
+	pcm_f32_to_s16_dither_c(data_out + idx, data_in + idx, count - idx, dither);
+}
+
+void f32_to_s32(int* data_out, const float* data_in, size_t count)
+{
+	const __m256 scale = _mm256_set1_ps(2147483648.0f);
+	const __m256 lo = _mm256_set1_ps(-2147483648.0f);
+	size_t idx = 0;
+	for (; idx + 8 <= count; idx += 8)
+	{
+		const __m256 v = _mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(data_in + idx), scale), lo);
+		// cvtps2dq turns 2^31 and above into INT32_MIN; flipping all their bits gives INT32_MAX
+		const __m256i over = _mm256_castps_si256(_mm256_cmp_ps(v, scale, _CMP_GE_OQ));
+		_mm256_storeu_si256((__m256i*)(data_out + idx), _mm256_xor_si256(_mm256_cvtps_epi32(v), over));
+	}
+	pcm_f32_to_s32_c(data_out + idx, data_in + idx, count - idx);
+}
+
+void s16_to_s32(int* data_out, const short* data_in, size_t count)
+{
+	size_t idx = 0;
+	for (; idx + 8 <= count; idx += 8)
+	{
+		const __m256i x = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(data_in + idx)));
+		_mm256_storeu_si256((__m256i*)(data_out + idx), _mm256_slli_epi32(x, 16));
+	}
+	pcm_s16_to_s32_c(data_out + idx, data_in + idx, count - idx);
+}
+
+void s24_to_s32(int* data_out, const unsigned char* data_in, size_t count)
+{
+	size_t idx = 0;
+	for (; idx + 10 <= count; idx += 8)
+	{
+		_mm256_storeu_si256((__m256i*)(data_out + idx), load_s24_8(data_in + 3 * idx));
+	}
+	pcm_s24_to_s32_c(data_out + idx, data_in + 3 * idx, count - idx);
+}
+
+void s24_to_s16(short* data_out, const unsigned char* data_in, size_t count)
+{
+	size_t idx = 0;
+	for (; idx + 10 <= count; idx += 8)
+	{
+		const __m256i x = _mm256_srai_epi32(load_s24_8(data_in + 3 * idx), 16);
+		_mm_storeu_si128((__m128i*)(data_out + idx), _mm_packs_epi32(_mm256_castsi256_si128(x), _mm256_extracti128_si256(x, 1)));
+	}
+	pcm_s24_to_s16_c(data_out + idx, data_in + 3 * idx, count - idx);
+}
+
+void s32_to_s16(short* data_out, const int* data_in, size_t count)
+{
+	size_t idx = 0;
+	for (; idx + 8 <= count; idx += 8)
+	{
+		const __m256i x = _mm256_srai_epi32(_mm256_loadu_si256((const __m256i*)(data_in + idx)), 16);
+		_mm_storeu_si128((__m128i*)(data_out + idx), _mm_packs_epi32(_mm256_castsi256_si128(x), _mm256_extracti128_si256(x, 1)));
+	}
+	pcm_s32_to_s16_c(data_out + idx, data_in + idx, count - idx);
+}
+
+const TPcmKernels s_kernels_avx2 =
+{
+	kPcmIsaAVX2,
+	s16_to_f32,
+	s24_to_f32,
+	s32_to_f32,
+	f32_to_s16,
+	f32_to_s16_dither,
+	f32_to_s32,
+	s16_to_s32,
+	s24_to_s32,
+	s24_to_s16,
+	s32_to_s16,
+};
+
+} // namespace
+
+const TPcmKernels* Pcm_kernels_avx2(void)
+{
+	return &s_kernels_avx2;
+}
+
+#else
+
+const TPcmKernels* Pcm_kernels_avx2(void)
+{
+	return NULL;
+}
+
+#endif
@@ -0,0 +1,161 @@
+/*
+ * SSE2 PCM conversions, eight samples per block. Built with -msse2. Packed 24-bit
+ * samples need a byte shuffle that SSE2 lacks, so those stay scalar here.
+ */
+#include "../Include/pcm_convert_simd.h"
+
+#if defined(PCM_CONVERT_X86) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <emmintrin.h>
+
+namespace
+{
+
+inline __m128i xorshift(__m128i x)
+{
+	x = _mm_xor_si128(x, _mm_slli_epi32(x, 13));
+	x = _mm_xor_si128(x, _mm_srli_epi32(x, 17));
+	return _mm_xor_si128(x, _mm_slli_epi32(x, 5));
+}
+
+// pcm_tpdf for four generators
+inline __m128 tpdf(__m128i* state)
+{
+	const __m128 scale = _mm_set1_ps(1.0f / 16777216.0f);
+	const __m128i a = xorshift(*state);
+	const __m128i b = xorshift(a);
+	*state = b;
+	return _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(a, 8)), scale),
+		_mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(b, 8)), scale));
+}
+
+inline __m128i f32_to_s16_4(const float* data_in, const __m128 dither)
+{
+	__m128 v = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(data_in), _mm_set1_ps(32768.0f)), dither);
+	v = _mm_min_ps(_mm_max_ps(v, _mm_set1_ps(-32768.0f)), _mm_set1_ps(32767.0f));
+	return _mm_cvtps_epi32(v);
+}
+
+void s16_to_f32(float* data_out, const short* data_in, size_t count)
+{
+	const __m128 scale = _mm_set1_ps(1.0f / 32768.0f);
+	size_t idx = 0;
+	for (; idx + 8 <= count; idx += 8)
+	{
+		const __m128i x = _mm_loadu_si128((const __m128i*)(data_in + idx));
+		_mm_storeu_ps(data_out + idx, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16)), scale));
+		_mm_storeu_ps(data_out + idx + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16)), scale));
+	}
+	pcm_s16_to_f32_c(data_out + idx, data_in + idx, count - idx);
+}
+
+void s32_to_f32(float* data_out, const int* data_in, size_t count)
+{
+	const __m128 scale = _mm_set1_ps(1.0f / 2147483648.0f);
+	size_t idx = 0;
+	for (; idx + 8 <= count; idx += 8)
+	{
+		_mm_storeu_ps(data_out + idx, _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)(data_in + idx))), scale));
+		_mm_storeu_ps(data_out + idx + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)(data_in + idx + 4))), scale));
+	}
+	pcm_s32_to_f32_c(data_out + idx, data_in + idx, count - idx);
+}
+
+void f32_to_s16(short* data_out, const float* data_in, size_t count)
+{
+	const __m128 zero = _mm_setzero_ps();
+	size_t idx = 0;
+	for (; idx + 8 <= count; idx += 8)
+	{
+		const __m128i lo = f32_to_s16_4(data_in + idx, zero);
+		const __m128i hi = f32_to_s16_4(data_in + idx + 4, zero);
+		_mm_storeu_si128((__m128i*)(data_out + idx), _mm_packs_epi32(lo, hi));
+	}
+	pcm_f32_to_s16_c(data_out + idx, data_in + idx, count - idx);
+}
+
+void f32_to_s16_dither(short* data_out, const float* data_in, size_t count, TPcmDither* dither)
+{
+	__m128i state_lo = _mm_loadu_si128((const __m128i*)dither->state);
+	__m128i state_hi = _mm_loadu_si128((const __m128i*)(dither->state + 4));
+	size_t idx = 0;
+	for (; idx + 8 <= count; idx += 8)
+	{
+		const __m128i lo = f32_to_s16_4(data_in + idx, tpdf(&state_lo));
+		const __m128i hi = f32_to_s16_4(data_in + idx + 4, tpdf(&state_hi));
+		_mm_storeu_si128((__m128i*)(data_out + idx), _mm_packs_epi32(lo, hi));
+	}
+	_mm_storeu_si128((__m128i*)dither->state, state_lo);
+	_mm_storeu_si128((__m128i*)(dither->state + 4), state_hi);
+	pcm_f32_to_s16_dither_c(data_out + idx, data_in + idx, count - idx, dither);
+}
+
+void f32_to_s32(int* data_out, const float* data_in, size_t count)
+{
+	const __m128 scale = _mm_set1_ps(2147483648.0f);
+	const __m128 lo = _mm_set1_ps(-2147483648.0f);
+	size_t idx = 0;
+	for (; idx + 4 <= count; idx += 4)
+	{
+		const __m128 v = _mm_max_ps(_mm_mul_ps(_mm_loadu_ps(data_in + idx), scale), lo);
+		// cvtps2dq turns 2^31 and above into INT32_MIN; flipping all their bits gives INT32_MAX
+		const __m128i over = _mm_castps_si128(_mm_cmpge_ps(v, scale));
+		_mm_storeu_si128((__m128i*)(data_out + idx), _mm_xor_si128(_mm_cvtps_epi32(v), over));
+	}
+	pcm_f32_to_s32_c(data_out + idx, data_in + idx, count - idx);
+}
+
+void s16_to_s32(int* data_out, const short* data_in, size_t count)
+{
+	const __m128i zero = _mm_setzero_si128();
+	size_t idx = 0;
+	for (; idx + 8 <= count; idx += 8)
+	{
+		const __m128i x = _mm_loadu_si128((const __m128i*)(data_in + idx));
+		_mm_storeu_si128((__m128i*)(data_out + idx), _mm_unpacklo_epi16(zero, x));
+		_mm_storeu_si128((__m128i*)(data_out + idx + 4), _mm_unpackhi_epi16(zero, x));
+	}
+	pcm_s16_to_s32_c(data_out + idx, data_in + idx, count - idx);
+}
+
+void s32_to_s16(short* data_out, const int* data_in, size_t count)
+{
+	size_t idx = 0;
+	for (; idx + 8 <= count; idx += 8)
+	{
+		const __m128i lo = _mm_srai_epi32(_mm_loadu_si128((const __m128i*)(data_in + idx)), 16);
+		const __m128i hi = _mm_srai_epi32(_mm_loadu_si128((const __m128i*)(data_in + idx + 4)), 16);
+		_mm_storeu_si128((__m128i*)(data_out + idx), _mm_packs_epi32(lo, hi));
+	}
+	pcm_s32_to_s16_c(data_out + idx, data_in + idx, count - idx);
+}
+
+const TPcmKernels s_kernels_sse2 =
+{
+	kPcmIsaSSE2,
+	s16_to_f32,
+	pcm_s24_to_f32_c,
+	s32_to_f32,
+	f32_to_s16,
+	f32_to_s16_dither,
+	f32_to_s32,
+	s16_to_s32,
+	pcm_s24_to_s32_c,
+	pcm_s24_to_s16_c,
+	s32_to_s16,
+};
+
+} // namespace
+
+const TPcmKernels* Pcm_kernels_sse2(void)
+{
+	return &s_kernels_sse2;
+}
+
+#else
+
+const TPcmKernels* Pcm_kernels_sse2(void)
+{
+	return NULL;
+}
+
+#endif
@@ -0,0 +1,311 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "../Include/resampler.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RESAMPLE_HAVE_SSE2 1
+#endif
+
+// Largest L tabulated phase by phase; beyond it integer rates use the interpolated mode
+#define RESAMPLE_MAX_PHASES 1024
+// Input samples buffered per pass
+#define RESAMPLE_BLOCK 1024
+
+typedef struct
+{
+	int taps; // when upsampling
+	int phases; // for the interpolated mode
+	double rolloff; // cutoff, as a fraction of the lower Nyquist rate
+	double beta; // Kaiser window
+}TResampleQualityParams;
+
+static const TResampleQualityParams s_quality_params[] =
+{
+	{ 16, 64, 0.85, 6.0 },
+	{ 32, 256, 0.90, 8.6 },
+	{ 64, 512, 0.945, 10.0 },
+};
+
+struct _TResampler
+{
+	double ratio; // out / in
+	int taps; // a multiple of 4
+	int phases; // rows of coefs, not counting the extra one of the interpolated mode
+	int interpolate;
+	float* coefs; // (phases + 1) rows of taps, 16-byte aligned
+	void* coefs_mem;
+	// Rational mode: the position is pos + phase / phases, advanced by step_int + step_frac / phases
+	int step_int;
+	int step_frac;
+	int phase;
+	// Interpolated mode: the fraction of the position in 32.32 fixed point
+	uint64_t step_fixed;
+	uint32_t frac_fixed;
+	int phase_bits;
+	float* buf; // taps + RESAMPLE_BLOCK input samples
+	int fill;
+	int pos; // the output window is buf[pos - taps / 2 + 1 .. pos + taps / 2]
+};
+
+static double bessel_i0(const double x)
+{
+	double sum = 1.0, term = 1.0;
+	for (int k = 1; k < 64 && term > 1e-12 * sum; k++)
+	{
+		term *= (x / (2.0 * k)) * (x / (2.0 * k));
+		sum += term;
+	}
+	return sum;
+}
+
+/*
+ * Row of phase frac (in [0, 1]) of the filter: tap i weights the input at distance
+ * frac + taps / 2 - 1 - i from the output position, oldest tap first.
+ */
+static void fill_row(float* row, const int taps, const double frac, const double cutoff, const double beta)
+{
+	const double pi = 3.14159265358979323846;
+	const double half = 0.5 * taps;
+	const double i0_beta = bessel_i0(beta);
+
+	for (int idx = 0; idx < taps; idx++)
+	{
+		const double t = frac + half - 1.0 - idx;
+		const double x = t / half;
+		if (fabs(x) >= 1.0) {
+			row[idx] = 0.0f;
+			continue;
+		}
+		const double sinc = (fabs(t) < 1e-12) ? 1.0 : sin(2.0 * pi * cutoff * t) / (2.0 * pi * cutoff * t);
+		row[idx] = (float)(2.0 * cutoff * sinc * bessel_i0(beta * sqrt(1.0 - x * x)) / i0_beta);
+	}
+}
+
+static TResampler* create_resampler(const double ratio, const int up, const int down, TResampleQuality quality)
+{
+	if (quality < kResampleLow || quality > kResampleHigh || !(ratio >= 1.0 / 256.0 && ratio <= 256.0)) {
+		return NULL;
+	}
+	const TResampleQualityParams* params = &s_quality_params[quality];
+	TResampler* rs = (TResampler*)calloc(1, sizeof(TResampler));
+	if (NULL == rs) {
+		return NULL;
+	}
+	const double cutoff = 0.5 * params->rolloff * ((ratio < 1.0) ? ratio : 1.0);
+	rs->ratio = ratio;
+	rs->taps = (int)ceil(params->taps / ((ratio < 1.0) ? ratio : 1.0));
+	rs->taps = (rs->taps + 3) & ~3;
+	rs->interpolate = (up <= 0 || up > RESAMPLE_MAX_PHASES);
+	if (rs->interpolate) {
+		rs->phases = params->phases;
+		while ((1 << rs->phase_bits) < rs->phases)
+		{
+			rs->phase_bits++;
+		}
+		rs->step_fixed = (uint64_t)floor(4294967296.0 / ratio + 0.5);
+	}
+	else {
+		rs->phases = up;
+		rs->step_int = down / up;
+		rs->step_frac = down % up;
+	}
+
+	rs->coefs_mem = malloc(sizeof(float) * ((size_t)(rs->phases + 1) * rs->taps + 4));
+	rs->buf = (float*)malloc(sizeof(float) * (rs->taps + RESAMPLE_BLOCK));
+	if (NULL == rs->coefs_mem || NULL == rs->buf) {
+		Destroy_resampler(rs);
+		return NULL;
+	}
+	rs->coefs = (float*)(((uintptr_t)rs->coefs_mem + 15) & ~(uintptr_t)15);
+	for (int phase = 0; phase <= rs->phases; phase++)
+	{
+		fill_row(rs->coefs + (size_t)phase * rs->taps, rs->taps, (double)phase / rs->phases, cutoff, params->beta);
+	}
+	Reset_resampler(rs);
+	return rs;
+}
+
+static int gcd(int a, int b)
+{
+	while (b != 0)
+	{
+		const int t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+TResampler* Create_resampler(const int in_rate, const int out_rate, TResampleQuality quality)
+{
+	if (in_rate <= 0 || out_rate <= 0) {
+		return NULL;
+	}
+	const int g = gcd(in_rate, out_rate);
+	return create_resampler((double)out_rate / in_rate, out_rate / g, in_rate / g, quality);
+}
+
+TResampler* Create_resampler_ratio(const double ratio, TResampleQuality quality)
+{
+	return create_resampler(ratio, 0, 0, quality);
+}
+
+void Destroy_resampler(TResampler* rs)
+{
+	if (NULL == rs) {
+		return;
+	}
+	free(rs->coefs_mem);
+	free(rs->buf);
+	free(rs);
+}
+
+void Reset_resampler(TResampler* rs)
+{
+	if (NULL == rs) {
+		return;
+	}
+	// Zero history in front of the first input sample, which sits at pos
+	rs->fill = rs->taps / 2 - 1;
+	rs->pos = rs->fill;
+	memset(rs->buf, 0, sizeof(float) * rs->fill);
+	rs->phase = 0;
+	rs->frac_fixed = 0;
+}
+
+int Get_resampler_delay(const TResampler* rs)
+{
+	return (NULL == rs) ? 0 : rs->taps / 2;
+}
+
+int Get_resampler_max_output(const TResampler* rs, const int in_count)
+{
+	return (NULL == rs || in_count <= 0) ? 0 : (int)ceil(in_count * rs->ratio) + 2;
+}
+
+static inline float dot(const float* x, const float* h, const int taps)
+{
+#if defined(RESAMPLE_HAVE_SSE2)
+	__m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+	int idx = 0;
+	for (; idx + 8 <= taps; idx += 8)
+	{
+		acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(x + idx), _mm_load_ps(h + idx)));
+		acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(x + idx + 4), _mm_load_ps(h + idx + 4)));
+	}
+	if (idx < taps) {
+		acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(x + idx), _mm_load_ps(h + idx)));
+	}
+	acc0 = _mm_add_ps(acc0, acc1);
+	acc0 = _mm_add_ps(acc0, _mm_movehl_ps(acc0, acc0));
+	acc0 = _mm_add_ss(acc0, _mm_shuffle_ps(acc0, acc0, 1));
+	return _mm_cvtss_f32(acc0);
+#else
+	float acc[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	for (int idx = 0; idx < taps; idx += 4)
+	{
+		acc[0] += x[idx] * h[idx];
+		acc[1] += x[idx + 1] * h[idx + 1];
+		acc[2] += x[idx + 2] * h[idx + 2];
+		acc[3] += x[idx + 3] * h[idx + 3];
+	}
+	return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+#endif
+}
+
+// Like dot, with the taps interpolated between rows h0 and h1 by w
+static inline float dot_interp(const float* x, const float* h0, const float* h1, const float w, const int taps)
+{
+#if defined(RESAMPLE_HAVE_SSE2)
+	const __m128 vw = _mm_set1_ps(w);
+	__m128 acc = _mm_setzero_ps();
+	for (int idx = 0; idx < taps; idx += 4)
+	{
+		const __m128 a = _mm_load_ps(h0 + idx);
+		const __m128 h = _mm_add_ps(a, _mm_mul_ps(vw, _mm_sub_ps(_mm_load_ps(h1 + idx), a)));
+		acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(x + idx), h));
+	}
+	acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+	acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+	return _mm_cvtss_f32(acc);
+#else
+	float acc[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	for (int idx = 0; idx < taps; idx += 4)
+	{
+		for (int lane = 0; lane < 4; lane++)
+		{
+			acc[lane] += x[idx + lane] * (h0[idx + lane] + w * (h1[idx + lane] - h0[idx + lane]));
+		}
+	}
+	return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+#endif
+}
+
+// Writes every output whose window lies in buf, returns their number
+static int resample_block(TResampler* rs, float* data_out)
+{
+	const int taps = rs->taps;
+	const int lead = taps / 2 - 1;
+	int count = 0;
+
+	if (!rs->interpolate) {
+		while (rs->pos + taps / 2 < rs->fill)
+		{
+			data_out[count++] = dot(rs->buf + rs->pos - lead, rs->coefs + (size_t)rs->phase * taps, taps);
+			rs->pos += rs->step_int;
+			rs->phase += rs->step_frac;
+			if (rs->phase >= rs->phases) {
+				rs->phase -= rs->phases;
+				rs->pos++;
+			}
+		}
+		return count;
+	}
+	const int shift = 32 - rs->phase_bits;
+	const float scale = 1.0f / (float)((uint64_t)1 << shift);
+	while (rs->pos + taps / 2 < rs->fill)
+	{
+		const uint32_t row = rs->frac_fixed >> shift;
+		const float w = (float)(rs->frac_fixed & (((uint32_t)1 << shift) - 1)) * scale;
+		const float* h0 = rs->coefs + (size_t)row * taps;
+		data_out[count++] = dot_interp(rs->buf + rs->pos - lead, h0, h0 + taps, w, taps);
+		const uint64_t next = (uint64_t)rs->frac_fixed + rs->step_fixed;
+		rs->pos += (int)(next >> 32);
+		rs->frac_fixed = (uint32_t)next;
+	}
+	return count;
+}
+
+TFFTResult Do_resample(TResampler* rs, float* data_out, int* out_count, const float* data_in, const int in_count)
+{
+	if (NULL == rs || NULL == data_out || NULL == out_count || (NULL == data_in && in_count > 0)) {
+		return kFFTErrNullPointer;
+	}
+	if (in_count < 0) {
+		return kFFTErrInvalidArgument;
+	}
+	const int lead = rs->taps / 2 - 1;
+	const int capacity = rs->taps + RESAMPLE_BLOCK;
+	int done = 0;
+
+	*out_count = 0;
+	while (done < in_count)
+	{
+		const int n = (capacity - rs->fill < in_count - done) ? capacity - rs->fill : in_count - done;
+		memcpy(rs->buf + rs->fill, data_in + done, sizeof(float) * n);
+		rs->fill += n;
+		done += n;
+		*out_count += resample_block(rs, data_out + *out_count);
+
+		// Keep the history of the next window; pos may also lie past fill when decimating
+		const int drop = (rs->pos - lead < rs->fill) ? rs->pos - lead : rs->fill;
+		memmove(rs->buf, rs->buf + drop, sizeof(float) * (rs->fill - drop));
+		rs->fill -= drop;
+		rs->pos -= drop;
+	}
+	return kFFTOk;
+}
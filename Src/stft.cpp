@@ -0,0 +1,422 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../Include/stft.h"
+
+#define STFT_COLA_TOLERANCE 1e-3
+
+struct _TSTFT
+{
+	int frame_len;
+	int hop;
+	TFFTFormat format;
+	int spectrum_len;
+	TFFTPlan* plan;
+	float* analysis_window; // frame_len
+	float* synthesis_window; // frame_len, divided by the overlap-add gain
+	float* in_ring; // frame_len, oldest sample at in_pos once filled
+	float* out_ring; // frame_len, partial sums; the frame starting at out_pos is the next one
+	float* out_ready; // hop samples completed by the last frame
+	float* frame; // frame_len + 2, time-domain scratch
+	float* spectrum; // spectrum_len
+	int in_pos;
+	int out_pos;
+	int fill; // samples pushed since the last frame
+};
+
+/*
+ * Fills the analysis and synthesis windows of a configuration; synthesis is NULL-able
+ * for the windows that have none. Returns 0 if a custom window is missing.
+ */
+static int make_windows(const TSTFTConfig* config, float* analysis, float* synthesis)
+{
+	const int frame_len = config->frame_len;
+	const double two_pi = 6.283185307179586476925;
+	int idx = 0;
+
+	for (idx = 0; idx < frame_len; idx++)
+	{
+		const double c = cos(two_pi * idx / frame_len);
+		switch (config->window)
+		{
+		case kWindowHann:
+			analysis[idx] = (float)(0.5 - 0.5 * c);
+			synthesis[idx] = 1.0f;
+			break;
+		case kWindowSqrtHann:
+			analysis[idx] = (float)sqrt(0.5 - 0.5 * c);
+			synthesis[idx] = analysis[idx];
+			break;
+		case kWindowHamming:
+			analysis[idx] = (float)(0.54 - 0.46 * c);
+			synthesis[idx] = 1.0f;
+			break;
+		case kWindowCustom:
+			if (NULL == config->analysis_window) {
+				return 0;
+			}
+			analysis[idx] = config->analysis_window[idx];
+			synthesis[idx] = (NULL == config->synthesis_window) ? 1.0f : config->synthesis_window[idx];
+			break;
+		default:
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/*
+ * Overlap-add gain c of the window pair, or 0 if the sums over the hop phases are not
+ * all within STFT_COLA_TOLERANCE of c (or c is 0).
+ */
+static double overlap_add_gain(const float* analysis, const float* synthesis, const int frame_len, const int hop)
+{
+	double min_sum = 0.0, max_sum = 0.0;
+	int phase = 0, idx = 0;
+
+	for (phase = 0; phase < hop; phase++)
+	{
+		double sum = 0.0;
+		for (idx = phase; idx < frame_len; idx += hop)
+		{
+			sum += (double)analysis[idx] * synthesis[idx];
+		}
+		min_sum = (0 == phase || sum < min_sum) ? sum : min_sum;
+		max_sum = (0 == phase || sum > max_sum) ? sum : max_sum;
+	}
+	const double gain = 0.5 * (min_sum + max_sum);
+	if (fabs(gain) < STFT_COLA_TOLERANCE || (max_sum - min_sum) > STFT_COLA_TOLERANCE * fabs(gain)) {
+		return 0.0;
+	}
+	return gain;
+}
+
+static TFFTResult check_config(const TSTFTConfig* config, float* analysis, float* synthesis, double* gain)
+{
+	if (!Is_fft_length_supported(config->frame_len)) {
+		return kFFTErrUnsupportedLength;
+	}
+	if (config->hop < 1 || config->hop > config->frame_len || !Is_fft_format_supported(config->format)) {
+		return kFFTErrInvalidArgument;
+	}
+	if (!make_windows(config, analysis, synthesis)) {
+		return kFFTErrInvalidArgument;
+	}
+	*gain = overlap_add_gain(analysis, synthesis, config->frame_len, config->hop);
+	return (0.0 == *gain) ? kFFTErrInvalidArgument : kFFTOk;
+}
+
+TFFTResult Check_stft_config(const TSTFTConfig* config)
+{
+	if (NULL == config) {
+		return kFFTErrNullPointer;
+	}
+	if (!Is_fft_length_supported(config->frame_len)) {
+		return kFFTErrUnsupportedLength;
+	}
+	float* windows = (float*)malloc(sizeof(float) * 2 * config->frame_len);
+	if (NULL == windows) {
+		return kFFTErrOutOfMemory;
+	}
+	double gain = 0.0;
+	TFFTResult result = check_config(config, windows, windows + config->frame_len, &gain);
+	free(windows);
+	return result;
+}
+
+TSTFT* Create_stft(const TSTFTConfig* config)
+{
+	if (NULL == config || !Is_fft_length_supported(config->frame_len)) {
+		return NULL;
+	}
+	TSTFT* stft = (TSTFT*)calloc(1, sizeof(TSTFT));
+	if (NULL == stft) {
+		return NULL;
+	}
+	const int frame_len = config->frame_len;
+	const int spectrum_len = Get_fft_spectrum_length(frame_len, config->format);
+	stft->frame_len = frame_len;
+	stft->hop = config->hop;
+	stft->format = config->format;
+	stft->spectrum_len = spectrum_len;
+	// One block for the windows, rings and scratch
+	stft->analysis_window = (float*)malloc(sizeof(float) * (5 * frame_len + 2 + config->hop + spectrum_len));
+	if (NULL == stft->analysis_window) {
+		Destroy_stft(stft);
+		return NULL;
+	}
+	stft->synthesis_window = stft->analysis_window + frame_len;
+	stft->in_ring = stft->synthesis_window + frame_len;
+	stft->out_ring = stft->in_ring + frame_len;
+	stft->frame = stft->out_ring + frame_len;
+	stft->out_ready = stft->frame + frame_len + 2;
+	stft->spectrum = stft->out_ready + config->hop;
+
+	double gain = 0.0;
+	if (kFFTOk != check_config(config, stft->analysis_window, stft->synthesis_window, &gain)) {
+		Destroy_stft(stft);
+		return NULL;
+	}
+	for (int idx = 0; idx < frame_len; idx++)
+	{
+		stft->synthesis_window[idx] = (float)(stft->synthesis_window[idx] / gain);
+	}
+	stft->plan = Create_fft_plan(frame_len);
+	if (NULL == stft->plan) {
+		Destroy_stft(stft);
+		return NULL;
+	}
+	Reset_stft(stft);
+	return stft;
+}
+
+void Destroy_stft(TSTFT* stft)
+{
+	if (NULL == stft) {
+		return;
+	}
+	Destroy_fft_plan(stft->plan);
+	free(stft->analysis_window);
+	free(stft);
+}
+
+void Reset_stft(TSTFT* stft)
+{
+	if (NULL == stft) {
+		return;
+	}
+	memset(stft->in_ring, 0, sizeof(float) * stft->frame_len);
+	memset(stft->out_ring, 0, sizeof(float) * stft->frame_len);
+	memset(stft->out_ready, 0, sizeof(float) * stft->hop);
+	stft->in_pos = 0;
+	stft->out_pos = 0;
+	stft->fill = 0;
+}
+
+int Get_stft_latency(const TSTFT* stft)
+{
+	return (NULL == stft) ? 0 : stft->frame_len;
+}
+
+int Get_stft_spectrum_length(const TSTFT* stft)
+{
+	return (NULL == stft) ? 0 : stft->spectrum_len;
+}
+
+// Analysis, callback and synthesis of the frame held in the input ring
+static void process_frame(TSTFT* stft, TSTFTCallback process, void* user)
+{
+	const int frame_len = stft->frame_len;
+	const int head = frame_len - stft->in_pos;
+	const int out_head = frame_len - stft->out_pos;
+	float* frame = stft->frame;
+	int idx = 0;
+
+	// The ring unrolled oldest first: [in_pos, frame_len) then [0, in_pos)
+	for (idx = 0; idx < head; idx++)
+	{
+		frame[idx] = stft->in_ring[stft->in_pos + idx] * stft->analysis_window[idx];
+	}
+	for (idx = head; idx < frame_len; idx++)
+	{
+		frame[idx] = stft->in_ring[idx - head] * stft->analysis_window[idx];
+	}
+
+	Do_fftr_plan(stft->plan, stft->spectrum, frame, stft->format);
+	if (NULL != process) {
+		process(user, stft->spectrum, stft->spectrum_len);
+	}
+	Do_ifftr_plan(stft->plan, frame, stft->spectrum, stft->format);
+
+	for (idx = 0; idx < out_head; idx++)
+	{
+		stft->out_ring[stft->out_pos + idx] += frame[idx] * stft->synthesis_window[idx];
+	}
+	for (idx = out_head; idx < frame_len; idx++)
+	{
+		stft->out_ring[idx - out_head] += frame[idx] * stft->synthesis_window[idx];
+	}
+
+	// No later frame reaches the first hop samples of this one
+	for (idx = 0; idx < stft->hop; idx++)
+	{
+		const int pos = (stft->out_pos + idx < frame_len) ? stft->out_pos + idx : stft->out_pos + idx - frame_len;
+		stft->out_ready[idx] = stft->out_ring[pos];
+		stft->out_ring[pos] = 0.0f;
+	}
+	stft->out_pos += stft->hop;
+	stft->out_pos -= (stft->out_pos >= frame_len) ? frame_len : 0;
+}
+
+TFFTResult Do_stft_process(TSTFT* stft, float* data_out, const float* data_in, const int count, TSTFTCallback process, void* user)
+{
+	if (NULL == stft || NULL == data_out || NULL == data_in) {
+		return kFFTErrNullPointer;
+	}
+	if (count < 0) {
+		return kFFTErrInvalidArgument;
+	}
+	int done = 0;
+
+	while (done < count)
+	{
+		int n = stft->hop - stft->fill;
+		n = (n < count - done) ? n : count - done;
+		// Split at the end of the ring
+		const int head = (n < stft->frame_len - stft->in_pos) ? n : stft->frame_len - stft->in_pos;
+		memcpy(stft->in_ring + stft->in_pos, data_in + done, sizeof(float) * head);
+		memcpy(stft->in_ring, data_in + done + head, sizeof(float) * (n - head));
+		stft->in_pos += n;
+		stft->in_pos -= (stft->in_pos >= stft->frame_len) ? stft->frame_len : 0;
+
+		// The input is consumed first, so data_out may alias data_in
+		memcpy(data_out + done, stft->out_ready + stft->fill, sizeof(float) * n);
+		stft->fill += n;
+		done += n;
+
+		if (stft->fill == stft->hop) {
+			process_frame(stft, process, user);
+			stft->fill = 0;
+		}
+	}
+	return kFFTOk;
+}
+
+struct TMultiSTFTChannel
+{
+	TMultiSTFT* owner;
+	int channel;
+	TSTFT* stft;
+	float* scratch; // hop samples, for kInterleaved
+};
+
+struct _TMultiSTFT
+{
+	int channels;
+	int hop;
+	TThreadPool* pool;
+	TMultiSTFTChannel* lanes; // channels
+	// Arguments of the running Do_multi_stft_process
+	float* data_out;
+	const float* data_in;
+	int count;
+	TFFTLayout layout;
+	TMultiSTFTCallback process;
+	void* user;
+};
+
+TMultiSTFT* Create_multi_stft(const TSTFTConfig* config, const int channels, TThreadPool* pool)
+{
+	if (NULL == config || channels < 1 || kFFTOk != Check_stft_config(config)) {
+		return NULL;
+	}
+	TMultiSTFT* stft = (TMultiSTFT*)calloc(1, sizeof(TMultiSTFT));
+	if (NULL == stft) {
+		return NULL;
+	}
+	stft->channels = channels;
+	stft->hop = config->hop;
+	stft->pool = pool;
+	stft->lanes = (TMultiSTFTChannel*)calloc(channels, sizeof(TMultiSTFTChannel));
+	if (NULL == stft->lanes) {
+		Destroy_multi_stft(stft);
+		return NULL;
+	}
+	for (int ch = 0; ch < channels; ch++)
+	{
+		TMultiSTFTChannel* lane = &stft->lanes[ch];
+		lane->owner = stft;
+		lane->channel = ch;
+		lane->stft = Create_stft(config);
+		lane->scratch = (float*)malloc(sizeof(float) * config->hop);
+		if (NULL == lane->stft || NULL == lane->scratch) {
+			Destroy_multi_stft(stft);
+			return NULL;
+		}
+	}
+	return stft;
+}
+
+void Destroy_multi_stft(TMultiSTFT* stft)
+{
+	if (NULL == stft) {
+		return;
+	}
+	if (NULL != stft->lanes) {
+		for (int ch = 0; ch < stft->channels; ch++)
+		{
+			Destroy_stft(stft->lanes[ch].stft);
+			free(stft->lanes[ch].scratch);
+		}
+	}
+	free(stft->lanes);
+	free(stft);
+}
+
+void Reset_multi_stft(TMultiSTFT* stft)
+{
+	if (NULL == stft) {
+		return;
+	}
+	for (int ch = 0; ch < stft->channels; ch++)
+	{
+		Reset_stft(stft->lanes[ch].stft);
+	}
+}
+
+static void multi_stft_callback(void* user, float* spectrum, const int spectrum_len)
+{
+	const TMultiSTFTChannel* lane = (const TMultiSTFTChannel*)user;
+	lane->owner->process(lane->owner->user, lane->channel, spectrum, spectrum_len);
+}
+
+static void multi_stft_task(void* user, const int index)
+{
+	TMultiSTFT* stft = (TMultiSTFT*)user;
+	TMultiSTFTChannel* lane = &stft->lanes[index];
+	const TSTFTCallback process = (NULL == stft->process) ? NULL : multi_stft_callback;
+	const int channels = stft->channels;
+	int done = 0, idx = 0;
+
+	if (kPlanar == stft->layout) {
+		Do_stft_process(lane->stft, stft->data_out + (size_t)index * stft->count, stft->data_in + (size_t)index * stft->count,
+			stft->count, process, lane);
+		return;
+	}
+	// De-interleave a hop at a time into the channel's own scratch
+	while (done < stft->count)
+	{
+		const int n = (stft->count - done < stft->hop) ? stft->count - done : stft->hop;
+		const float* in = stft->data_in + (size_t)done * channels + index;
+		float* out = stft->data_out + (size_t)done * channels + index;
+		for (idx = 0; idx < n; idx++)
+		{
+			lane->scratch[idx] = in[(size_t)idx * channels];
+		}
+		Do_stft_process(lane->stft, lane->scratch, lane->scratch, n, process, lane);
+		for (idx = 0; idx < n; idx++)
+		{
+			out[(size_t)idx * channels] = lane->scratch[idx];
+		}
+		done += n;
+	}
+}
+
+TFFTResult Do_multi_stft_process(TMultiSTFT* stft, float* data_out, const float* data_in, const int count, TFFTLayout layout, TMultiSTFTCallback process, void* user)
+{
+	if (NULL == stft || NULL == data_out || NULL == data_in) {
+		return kFFTErrNullPointer;
+	}
+	if (count < 0 || (kPlanar != layout && kInterleaved != layout)) {
+		return kFFTErrInvalidArgument;
+	}
+	stft->data_out = data_out;
+	stft->data_in = data_in;
+	stft->count = count;
+	stft->layout = layout;
+	stft->process = process;
+	stft->user = user;
+	Run_thread_pool(stft->pool, multi_stft_task, stft, stft->channels);
+	return kFFTOk;
+}
@@ -0,0 +1,216 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+#include "../Include/thread_pool.h"
+
+// Polls of the run word before an idle worker parks
+#define THREAD_POOL_SPIN_COUNT 20000
+// Indices per run; larger counts are run in several rounds
+#define THREAD_POOL_MAX_COUNT 0xFFFF
+
+/*
+ * The run word packs the run number (upper 32 bits), the task count (bits 16..31) and
+ * the next index to claim (bits 0..15). A thread claims an index by a compare-exchange
+ * that also checks the run number, so a worker that is late for a run can never claim
+ * an index of the next one; and task, user and first are only read after a successful
+ * claim, when the run they belong to cannot have finished yet.
+ */
+static inline uint64_t pack_run(const uint64_t run, const int count, const int next)
+{
+	return (run << 32) | ((uint64_t)count << 16) | (uint64_t)next;
+}
+
+struct _TThreadPool
+{
+	int threads;
+	std::thread* workers; // threads - 1
+	std::atomic<uint64_t> run_word;
+	std::atomic<int> done; // tasks finished in the current run
+	std::atomic<int> parked;
+	std::atomic<bool> stop;
+	std::mutex park_mutex;
+	std::condition_variable park_cv;
+	TThreadPoolTask task;
+	void* user;
+	int first; // index of the current round's index 0
+};
+
+static void pin_thread(std::thread& thread, const int cpu)
+{
+#if defined(_WIN32)
+	SetThreadAffinityMask((HANDLE)thread.native_handle(), (DWORD_PTR)1 << (cpu % (8 * sizeof(DWORD_PTR))));
+#elif defined(__linux__)
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu % CPU_SETSIZE, &set);
+	pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#else
+	(void)thread;
+	(void)cpu;
+#endif
+}
+
+// Claims and runs indices of the run 'run' until there are none left
+static void run_tasks(TThreadPool* pool, const uint64_t run)
+{
+	uint64_t word = pool->run_word.load(std::memory_order_acquire);
+
+	for (;;)
+	{
+		const int count = (int)((word >> 16) & 0xFFFF);
+		const int next = (int)(word & 0xFFFF);
+		if ((word >> 32) != run || next >= count) {
+			return;
+		}
+		if (!pool->run_word.compare_exchange_weak(word, word + 1, std::memory_order_acq_rel, std::memory_order_acquire)) {
+			continue;
+		}
+		pool->task(pool->user, pool->first + next);
+		pool->done.fetch_add(1, std::memory_order_release);
+		word = pool->run_word.load(std::memory_order_acquire);
+	}
+}
+
+static void worker_main(TThreadPool* pool)
+{
+	uint64_t seen = 0;
+
+	for (;;)
+	{
+		uint64_t run = pool->run_word.load(std::memory_order_acquire) >> 32;
+		for (int spin = 0; run == seen && spin < THREAD_POOL_SPIN_COUNT && !pool->stop.load(std::memory_order_relaxed); spin++)
+		{
+			std::this_thread::yield();
+			run = pool->run_word.load(std::memory_order_acquire) >> 32;
+		}
+		if (run == seen && !pool->stop.load()) {
+			// Paired with the store-then-check in Run_thread_pool, so a wake-up cannot be lost
+			std::unique_lock<std::mutex> lock(pool->park_mutex);
+			pool->parked.fetch_add(1);
+			while ((run = pool->run_word.load() >> 32) == seen && !pool->stop.load())
+			{
+				pool->park_cv.wait(lock);
+			}
+			pool->parked.fetch_sub(1);
+		}
+		if (pool->stop.load()) {
+			return;
+		}
+		seen = run;
+		run_tasks(pool, run);
+	}
+}
+
+static void wake_workers(TThreadPool* pool)
+{
+	if (pool->parked.load() > 0) {
+		std::lock_guard<std::mutex> guard(pool->park_mutex);
+		pool->park_cv.notify_all();
+	}
+}
+
+TThreadPool* Create_thread_pool(const int threads, const int pin_threads)
+{
+	TThreadPool* pool = new (std::nothrow) TThreadPool;
+	if (NULL == pool) {
+		return NULL;
+	}
+	pool->threads = (threads > 0) ? threads : (int)std::thread::hardware_concurrency();
+	pool->threads = (pool->threads > 0) ? pool->threads : 1;
+	pool->run_word.store(0);
+	pool->done.store(0);
+	pool->parked.store(0);
+	pool->stop.store(false);
+	pool->task = NULL;
+	pool->user = NULL;
+	pool->first = 0;
+	pool->workers = NULL;
+	if (pool->threads > 1) {
+		pool->workers = new (std::nothrow) std::thread[pool->threads - 1];
+		if (NULL == pool->workers) {
+			delete pool;
+			return NULL;
+		}
+	}
+	for (int idx = 0; idx < pool->threads - 1; idx++)
+	{
+		try {
+			pool->workers[idx] = std::thread(worker_main, pool);
+		}
+		catch (...) {
+			// Carry on with the workers that did start
+			pool->threads = idx + 1;
+			break;
+		}
+		if (pin_threads) {
+			pin_thread(pool->workers[idx], idx + 1);
+		}
+	}
+	return pool;
+}
+
+void Destroy_thread_pool(TThreadPool* pool)
+{
+	if (NULL == pool) {
+		return;
+	}
+	pool->stop.store(true);
+	{
+		std::lock_guard<std::mutex> guard(pool->park_mutex);
+		pool->park_cv.notify_all();
+	}
+	for (int idx = 0; idx < pool->threads - 1; idx++)
+	{
+		pool->workers[idx].join();
+	}
+	delete[] pool->workers;
+	delete pool;
+}
+
+int Get_thread_pool_size(const TThreadPool* pool)
+{
+	return (NULL == pool) ? 1 : pool->threads;
+}
+
+void Run_thread_pool(TThreadPool* pool, TThreadPoolTask task, void* user, const int count)
+{
+	if (NULL == task || count <= 0) {
+		return;
+	}
+	if (NULL == pool || pool->threads <= 1 || count == 1) {
+		for (int idx = 0; idx < count; idx++)
+		{
+			task(user, idx);
+		}
+		return;
+	}
+	for (int first = 0; first < count; first += THREAD_POOL_MAX_COUNT)
+	{
+		const int round = (count - first < THREAD_POOL_MAX_COUNT) ? count - first : THREAD_POOL_MAX_COUNT;
+		const uint64_t run = (pool->run_word.load(std::memory_order_relaxed) >> 32) + 1;
+
+		// The previous run has finished, so no thread reads these until the store below
+		pool->task = task;
+		pool->user = user;
+		pool->first = first;
+		pool->done.store(0, std::memory_order_relaxed);
+		pool->run_word.store(pack_run(run & 0xFFFFFFFF, round, 0));
+		wake_workers(pool);
+
+		run_tasks(pool, run & 0xFFFFFFFF);
+		while (pool->done.load(std::memory_order_acquire) < round)
+		{
+			std::this_thread::yield();
+		}
+	}
+}
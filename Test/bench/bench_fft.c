@@ -0,0 +1,228 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "../../Include/NE10_fft.h"
+
+#define BENCH_RUNS                      7
+#define BENCH_RUN_SECONDS               0.05
+
+typedef void (*bench_fn)(void* ctx);
+
+typedef struct
+{
+	ne10_fft_r2c_cfg_float64_t cfg;
+	ne10_float64_t* in;
+	ne10_fft_cpx_float64_t* out;
+} ctx64;
+
+typedef struct
+{
+	ne10_fft_r2c_cfg_float32_t cfg;
+	ne10_float32_t* in;
+	ne10_fft_cpx_float32_t* out;
+} ctx32;
+
+typedef struct
+{
+	ne10_fft_r2c_cfg_float32_t cfg;
+	ne10_float16_t* in;
+	ne10_float16_t* out; // CCS, nfft + 2 values
+} ctx16;
+
+static void run64(void* ctx)
+{
+	ctx64* c = (ctx64*)ctx;
+	ne10_fft_r2c_1d_float64_c(c->out, c->in, c->cfg);
+}
+
+static void run32(void* ctx)
+{
+	ctx32* c = (ctx32*)ctx;
+	ne10_fft_r2c_1d_float32_c(c->out, c->in, c->cfg);
+}
+
+static void run16(void* ctx)
+{
+	ctx16* c = (ctx16*)ctx;
+	ne10_fft_r2c_1d_float16_c(c->out, c->in, c->cfg);
+}
+
+/*
+ * Seconds per transform, best of BENCH_RUNS runs of enough transforms to fill
+ * BENCH_RUN_SECONDS of CPU time each.
+ */
+static double bench(bench_fn fn, void* ctx)
+{
+	double best = 0.0;
+	long iters = 1, idx = 0;
+	int run = 0;
+	clock_t start, stop;
+
+	fn(ctx);
+	for (;;)
+	{
+		start = clock();
+		for (idx = 0; idx < iters; idx++)
+		{
+			fn(ctx);
+		}
+		stop = clock();
+		if ((double)(stop - start) >= BENCH_RUN_SECONDS * CLOCKS_PER_SEC) {
+			break;
+		}
+		iters *= 2;
+	}
+	for (run = 0; run < BENCH_RUNS; run++)
+	{
+		double seconds = 0.0;
+		start = clock();
+		for (idx = 0; idx < iters; idx++)
+		{
+			fn(ctx);
+		}
+		stop = clock();
+		seconds = (double)(stop - start) / CLOCKS_PER_SEC / iters;
+		best = (0 == run || seconds < best) ? seconds : best;
+	}
+	return best;
+}
+
+// Largest absolute difference of bin values against the reference, relative to its peak magnitude
+static double spectrum_error(const ne10_fft_cpx_float64_t* ref, const float* re, const float* im, const int step, const int bins)
+{
+	double peak = 0.0, err = 0.0;
+	int idx = 0;
+
+	for (idx = 0; idx < bins; idx++)
+	{
+		const double mag = sqrt(ref[idx].r * ref[idx].r + ref[idx].i * ref[idx].i);
+		const double dr = re[idx * step] - ref[idx].r;
+		const double di = im[idx * step] - ref[idx].i;
+		const double d = sqrt(dr * dr + di * di);
+		peak = (mag > peak) ? mag : peak;
+		err = (d > err) ? d : err;
+	}
+	return (peak > 0.0) ? err / peak : 0.0;
+}
+
+static void print_time(const double seconds)
+{
+	if (seconds >= 1e-3) {
+		printf("%8.2f ms", seconds * 1e3);
+	}
+	else {
+		printf("%8.2f us", seconds * 1e6);
+	}
+}
+
+/*
+ * Single-threaded r2c time and accuracy of the float64, float32 and fp16-storage
+ * transforms. float64 error is its own round trip, relative to the input peak; float32
+ * is against float64 of the same input and fp16 against float64 of the input after
+ * quantisation to fp16, both relative to the spectrum peak.
+ */
+static void bench_size(const int nfft)
+{
+	const int bins = nfft / 2 + 1;
+	ctx64 c64;
+	ctx32 c32;
+	ctx16 c16;
+	ne10_fft_cpx_float64_t* ref16 = (ne10_fft_cpx_float64_t*)malloc(sizeof(ne10_fft_cpx_float64_t) * bins);
+	ne10_float64_t* back = (ne10_float64_t*)malloc(sizeof(ne10_float64_t) * nfft);
+	float* spectrum16 = (float*)malloc(sizeof(float) * (nfft + 2));
+	double t64 = 0.0, t32 = 0.0, t16 = 0.0, e64 = 0.0, e32 = 0.0, e16 = 0.0, peak = 0.0;
+	int idx = 0;
+
+	c64.cfg = ne10_fft_alloc_r2c_float64(nfft);
+	c64.in = (ne10_float64_t*)malloc(sizeof(ne10_float64_t) * nfft);
+	c64.out = (ne10_fft_cpx_float64_t*)malloc(sizeof(ne10_fft_cpx_float64_t) * bins);
+	c32.cfg = ne10_fft_alloc_r2c_float32(nfft);
+	c32.in = (ne10_float32_t*)malloc(sizeof(ne10_float32_t) * nfft);
+	c32.out = (ne10_fft_cpx_float32_t*)malloc(sizeof(ne10_fft_cpx_float32_t) * bins);
+	c16.cfg = c32.cfg;
+	c16.in = (ne10_float16_t*)malloc(sizeof(ne10_float16_t) * nfft);
+	c16.out = (ne10_float16_t*)malloc(sizeof(ne10_float16_t) * (nfft + 2));
+	if (NULL == ref16 || NULL == back || NULL == spectrum16 || NULL == c64.cfg || NULL == c64.in || NULL == c64.out
+		|| NULL == c32.cfg || NULL == c32.in || NULL == c32.out || NULL == c16.in || NULL == c16.out) {
+		printf("%-10d out of memory\n", nfft);
+		goto done;
+	}
+
+	srand(nfft);
+	for (idx = 0; idx < nfft; idx++)
+	{
+		c32.in[idx] = (float)rand() / RAND_MAX * 2.0f - 1.0f;
+		c64.in[idx] = c32.in[idx];
+	}
+	ne10_cvt_float32_float16(c16.in, c32.in, nfft);
+
+	t64 = bench(run64, &c64);
+	t32 = bench(run32, &c32);
+	t16 = bench(run16, &c16);
+
+	// Reference for fp16: float64 of the quantised input
+	ne10_cvt_float16_float32(c32.in, c16.in, nfft);
+	for (idx = 0; idx < nfft; idx++)
+	{
+		c64.in[idx] = c32.in[idx];
+	}
+	ne10_fft_r2c_1d_float64_c(ref16, c64.in, c64.cfg);
+	ne10_fft_r2c_1d_float16_c(c16.out, c16.in, c16.cfg);
+	ne10_cvt_float16_float32(spectrum16, c16.out, nfft + 2);
+	e16 = spectrum_error(ref16, spectrum16, spectrum16 + 1, 2, bins);
+
+	srand(nfft);
+	for (idx = 0; idx < nfft; idx++)
+	{
+		c32.in[idx] = (float)rand() / RAND_MAX * 2.0f - 1.0f;
+		c64.in[idx] = c32.in[idx];
+	}
+	ne10_fft_r2c_1d_float64_c(c64.out, c64.in, c64.cfg);
+	ne10_fft_r2c_1d_float32_c(c32.out, c32.in, c32.cfg);
+	e32 = spectrum_error(c64.out, &c32.out[0].r, &c32.out[0].i, 2, bins);
+
+	// Undo whatever backward scaling the build chose, so the round trip returns the input
+	ne10_fft_c2r_1d_float64_c(back, c64.out, c64.cfg);
+	for (idx = 0; idx < nfft; idx++)
+	{
+		const double d = fabs(back[idx] / (nfft * c64.cfg->backward_scale) - c64.in[idx]);
+		peak = (fabs(c64.in[idx]) > peak) ? fabs(c64.in[idx]) : peak;
+		e64 = (d > e64) ? d : e64;
+	}
+	e64 = (peak > 0.0) ? e64 / peak : 0.0;
+
+	printf("%-10d", nfft);
+	print_time(t64);
+	printf("%9.1e  ", e64);
+	print_time(t32);
+	printf("%9.1e  ", e32);
+	print_time(t16);
+	printf("%9.1e\n", e16);
+
+done:
+	ne10_fft_destroy_r2c_float64(c64.cfg);
+	ne10_fft_destory_r2c_float32(c32.cfg);
+	free(c64.in);
+	free(c64.out);
+	free(c32.in);
+	free(c32.out);
+	free(c16.in);
+	free(c16.out);
+	free(ref16);
+	free(back);
+	free(spectrum16);
+}
+
+int main(void)
+{
+	static const int sizes[] = { 1024, 4096, 4410, 65536, 262144 };
+	int idx = 0;
+
+	printf("%-10s%-22s%-22s%-22s\n", "nfft", "float64", "float32", "fp16");
+	for (idx = 0; idx < (int)(sizeof(sizes) / sizeof(sizes[0])); idx++)
+	{
+		bench_size(sizes[idx]);
+	}
+	return 0;
+}
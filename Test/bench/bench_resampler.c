@@ -0,0 +1,81 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "../../Include/resampler.h"
+
+#define BENCH_SECONDS                   20
+#define BENCH_BLOCK                     256
+
+/*
+ * Single-threaded resampler throughput, as a realtime factor per core: seconds of
+ * input audio processed per second of CPU time.
+ */
+static double bench(const int in_rate, const int out_rate, TResampleQuality quality)
+{
+	const int total = in_rate * BENCH_SECONDS;
+	float in_block[BENCH_BLOCK];
+	float* out_block = NULL;
+	int out_count = 0, done = 0, idx = 0;
+	double phase = 0.0;
+	clock_t start, stop;
+
+	TResampler* rs = Create_resampler(in_rate, out_rate, quality);
+	if (NULL == rs) {
+		return 0.0;
+	}
+	out_block = (float*)malloc(sizeof(float) * Get_resampler_max_output(rs, BENCH_BLOCK));
+	if (NULL == out_block) {
+		Destroy_resampler(rs);
+		return 0.0;
+	}
+	for (idx = 0; idx < BENCH_BLOCK; idx++)
+	{
+		in_block[idx] = (float)sin(phase);
+		phase += 0.05;
+	}
+
+	start = clock();
+	for (done = 0; done < total; done += BENCH_BLOCK)
+	{
+		Do_resample(rs, out_block, &out_count, in_block, BENCH_BLOCK);
+	}
+	stop = clock();
+
+	free(out_block);
+	Destroy_resampler(rs);
+	return (double)BENCH_SECONDS * CLOCKS_PER_SEC / (double)(stop - start > 0 ? stop - start : 1);
+}
+
+int main(void)
+{
+	static const int rates[][2] = {
+		{ 8000, 16000 },
+		{ 44100, 16000 },
+		{ 48000, 16000 },
+		{ 16000, 48000 },
+		{ 44100, 48000 },
+		{ 44100, 44101 },
+	};
+	static const char* names[] = { "low", "medium", "high" };
+	int r = 0, q = 0;
+
+	printf("%-16s", "in -> out");
+	for (q = 0; q < 3; q++)
+	{
+		printf("%12s", names[q]);
+	}
+	printf("    (realtime factor per core)\n");
+	for (r = 0; r < (int)(sizeof(rates) / sizeof(rates[0])); r++)
+	{
+		char label[32];
+		snprintf(label, sizeof(label), "%d -> %d", rates[r][0], rates[r][1]);
+		printf("%-16s", label);
+		for (q = 0; q < 3; q++)
+		{
+			printf("%12.1f", bench(rates[r][0], rates[r][1], (TResampleQuality)q));
+		}
+		printf("\n");
+	}
+	return 0;
+}
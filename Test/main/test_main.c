@@ -7,6 +7,8 @@
 #include "../../Include/getopt.h"
 #include "../../Include/logger.h"
 #include "../../Include/ini.h"
+#include "../../Include/async_io.h"
+#include "../../Include/batch.h"
 
 #define FRAME_SIZE                      512
 #define FRAME_MOVE                      256
@@ -14,20 +16,20 @@
 #define MAX_CHANNEL_SAMPLE              FRAME_MOVE * MAX_CHANNEL
 #define PATH_LEN                        1024
 #define FS                              16000
-#define MIC_NUM                         2
+#define IO_BLOCKS                       8
 
-short in_audio[MAX_CHANNEL_SAMPLE];
-short out_audio[MIC_NUM * FRAME_MOVE];
 drwav in_wav, out_wav;
 char config_filename[PATH_LEN] = { 0 }, 
 	 in_wav_filename[PATH_LEN] = { 0 },
      out_wav_filename[PATH_LEN] = { 0 },
-	 log_filename[PATH_LEN] = {0};
+	 log_filename[PATH_LEN] = {0},
+	 batch_source[PATH_LEN] = { 0 };
+int batch_threads = 0;
 
 void parse_command_line(int argc, char* argv[])
 {
 	int oc = 0;
-	while ((oc = getopt(argc, argv, "i:o:c:l:h")) != -1) {
+	while ((oc = getopt(argc, argv, "i:o:c:l:b:j:h")) != -1) {
 		switch (oc) {
 		case 'i':
 			strcpy(in_wav_filename, optarg);
@@ -41,6 +43,12 @@ void parse_command_line(int argc, char* argv[])
 		case 'l':
 			strcpy(log_filename, optarg);
 			break;
+		case 'b':
+			strcpy(batch_source, optarg);
+			break;
+		case 'j':
+			batch_threads = atoi(optarg);
+			break;
 		case 'h':
 			return;
 		default:
@@ -56,6 +64,168 @@ typedef struct
 	const char email[PATH_LEN];
 } configuration;
 
+static int read_input(void* user, void* frames, const int frame_count)
+{
+	return (int)drwav_read_pcm_frames_s16((drwav*)user, frame_count, (drwav_int16*)frames);
+}
+
+static int write_output(void* user, const void* frames, const int frame_count)
+{
+	return (int)drwav_write_pcm_frames((drwav*)user, frame_count, frames);
+}
+
+static void init_output_format(drwav_data_format* format)
+{
+	format->container = drwav_container_riff;     // <-- drwav_container_riff = normal WAV files, drwav_container_w64 = Sony Wave64.
+	format->format = DR_WAVE_FORMAT_PCM;          // <-- Any of the DR_WAVE_FORMAT_* codes.
+	format->channels = 1;
+	format->sampleRate = FS;
+	format->bitsPerSample = 16;
+}
+
+/*
+ * Batch mode (-b <directory or manifest> -o <output directory> [-j threads]). Each
+ * worker thread keeps one engine for all of its files; anything a file needs that
+ * can outlive it (buffers, FFT plans) belongs in here rather than on the stack.
+ */
+typedef struct
+{
+	short in_audio[MAX_CHANNEL_SAMPLE];
+	short out_audio[MAX_CHANNEL_SAMPLE];
+} engine;
+
+enum
+{
+	kFileOpenInputFailed = 1,
+	kFileTooManyChannels,
+	kFileOpenOutputFailed,
+	kFileWriteFailed
+};
+
+static const char* file_error_text(int result)
+{
+	switch (result) {
+	case kFileOpenInputFailed:
+		return "can't open input";
+	case kFileTooManyChannels:
+		return "too many channels";
+	case kFileOpenOutputFailed:
+		return "can't open output";
+	case kFileWriteFailed:
+		return "write failed";
+	case BATCH_ERROR_NO_STATE:
+		return "out of memory";
+	case BATCH_ERROR_SAME_FILE:
+		return "output would overwrite the input";
+	case BATCH_ERROR_DUPLICATE_OUTPUT:
+		return "output is also written by an earlier file";
+	default:
+		return "unknown error";
+	}
+}
+
+static void* create_engine(void* user)
+{
+	return calloc(1, sizeof(engine));
+}
+
+static void destroy_engine(void* user, void* state)
+{
+	free(state);
+}
+
+// Maps the input where it can, so 16-bit PCM is read in place instead of through stdio and a copy
+static drwav_bool32 open_input(drwav* wav, const char* path)
+{
+#ifndef DR_WAV_NO_MMAP
+	if (drwav_init_file_mmap(wav, path, NULL)) {
+		return DRWAV_TRUE;
+	}
+#endif
+	return drwav_init_file(wav, path, NULL);
+}
+
+// The next frames of the input as 16-bit samples: mapped when the file holds exactly that, otherwise read into buf
+static const short* next_input(drwav* wav, short* buf, const int mapped, drwav_uint64* n_frames)
+{
+	if (mapped) {
+		return (const short*)drwav_map_pcm_frames(wav, FRAME_MOVE, n_frames);
+	}
+	*n_frames = drwav_read_pcm_frames_s16(wav, FRAME_MOVE, buf);
+	return buf;
+}
+
+static int process_file(void* user, void* state, const char* in_path, const char* out_path, TBatchFileInfo* info)
+{
+	engine* eng = (engine*)state;
+	drwav in, out;
+	drwav_data_format format;
+	drwav_uint64 n_frames;
+	const short* frames;
+	int mapped;
+	int result = 0;
+
+	if (!open_input(&in, in_path)) {
+		return kFileOpenInputFailed;
+	}
+	if (in.channels > MAX_CHANNEL) {
+		drwav_uninit(&in);
+		return kFileTooManyChannels;
+	}
+	init_output_format(&format);
+	if (!drwav_init_file_write(&out, out_path, &format, NULL)) {
+		drwav_uninit(&in);
+		return kFileOpenOutputFailed;
+	}
+
+	info->sample_rate = in.sampleRate;
+	info->channels = in.channels;
+	mapped = in.isMemoryMapped && in.translatedFormatTag == DR_WAVE_FORMAT_PCM && in.bitsPerSample == 16
+		&& in.channels >= format.channels && drwav__is_little_endian();
+	while ((frames = next_input(&in, eng->in_audio, mapped, &n_frames)) != NULL && n_frames > 0) {
+		memcpy(eng->out_audio, frames, n_frames * format.channels * sizeof(short));
+		if (drwav_write_pcm_frames(&out, n_frames, eng->out_audio) != n_frames) {
+			result = kFileWriteFailed;
+			break;
+		}
+		info->frames += n_frames;
+	}
+
+	drwav_uninit(&in);
+	if (drwav_uninit(&out) != DRWAV_SUCCESS && result == 0) {
+		result = kFileWriteFailed;
+	}
+	return result;
+}
+
+static void run_batch_mode(void)
+{
+	TBatchList* list = Create_batch_list(batch_source, out_wav_filename);
+	if (NULL == list) {
+		LOG_ERROR("Can't read batch source:%s", batch_source);
+		return;
+	}
+	TThreadPool* pool = Create_thread_pool(batch_threads, 0);
+	TBatchWorker worker = { create_engine, destroy_engine, process_file, NULL };
+	TBatchStats stats;
+	LOG_INFO("batch: %d files from %s on %d threads", Get_batch_count(list), batch_source, Get_thread_pool_size(pool));
+
+	Run_batch(list, pool, &worker, &stats);
+
+	for (int idx = 0; idx < Get_batch_count(list); idx++) {
+		if (Get_batch_result(list, idx) != 0) {
+			LOG_ERROR("batch: %s: %s", Get_batch_input(list, idx), file_error_text(Get_batch_result(list, idx)));
+		}
+	}
+	LOG_INFO("batch: %d ok, %d failed, %lld frames, %.1f s of audio in %.2f s (%.1fx real time, %.1f files/s)",
+		stats.files_ok, stats.files_failed, stats.frames, stats.audio_seconds, stats.wall_seconds,
+		stats.wall_seconds > 0 ? stats.audio_seconds / stats.wall_seconds : 0.0,
+		stats.wall_seconds > 0 ? (stats.files_ok + stats.files_failed) / stats.wall_seconds : 0.0);
+
+	Destroy_thread_pool(pool);
+	Destroy_batch_list(list);
+}
+
 static int parse_handler(void* user, const char* section, const char* name,
 	const char* value)
 {
@@ -97,6 +267,11 @@ void main(int argc, char* argv[])
 	LOG_INFO("config file name:%s", config_filename);
 	LOG_INFO("log file name:%s", log_filename);
 
+	if (batch_source[0] != '\0') {
+		run_batch_mode();
+		return;
+	}
+
 	configuration config;
 	if (ini_parse(config_filename, parse_handler, &config) < 0) {
 		LOG_ERROR("Can't load %s", config_filename);
@@ -111,23 +286,49 @@ void main(int argc, char* argv[])
 	long flen = in_wav.totalPCMFrameCount;
 	long n_samples = 0;
 	drwav_data_format format;
-	format.container = drwav_container_riff;     // <-- drwav_container_riff = normal WAV files, drwav_container_w64 = Sony Wave64.
-	format.format = DR_WAVE_FORMAT_PCM;          // <-- Any of the DR_WAVE_FORMAT_* codes.
-	format.channels = 1;
-	format.sampleRate = FS;
-	format.bitsPerSample = 16;
+	init_output_format(&format);
 	drwav_init_file_write(&out_wav, out_wav_filename, &format, NULL);
 	
 	float in_data[FRAME_SIZE + 2], out_data[FRAME_SIZE];
-	
-	while (flen > 0) {
-		n_samples = drwav_read_pcm_frames_s16(&in_wav, FRAME_MOVE, in_audio);
 
-		drwav_uint64 framesWritten = drwav_write_pcm_frames(&out_wav, n_samples, in_audio);
+	// Disk reads and writes run on the I/O thread, a few blocks ahead of and behind this loop
+	TAsyncIOConfig io_config;
+	io_config.block_frames = FRAME_MOVE;
+	io_config.in_frame_bytes = in_wav.channels * sizeof(short);
+	io_config.out_frame_bytes = format.channels * sizeof(short);
+	io_config.blocks = IO_BLOCKS;
+	io_config.read = read_input;
+	io_config.read_user = &in_wav;
+	io_config.write = write_output;
+	io_config.write_user = &out_wav;
+	TAsyncIO* io = Create_async_io(&io_config);
+	if (NULL == io) {
+		LOG_ERROR("Can't start the I/O thread");
+		drwav_uninit(&in_wav);
+		drwav_uninit(&out_wav);
+		return;
+	}
+
+	const void* in_block = NULL;
+	while (flen > 0 && (n_samples = Get_async_input(io, &in_block)) > 0) {
+		short* out_block = (short*)Get_async_output(io);
+		memcpy(out_block, in_block, n_samples * io_config.out_frame_bytes);
+		Release_async_input(io);
+		Commit_async_output(io, n_samples);
 
 		flen -= n_samples;
 	}
 
+	TAsyncIOStats io_stats;
+	Flush_async_io(io);
+	Get_async_io_stats(io, &io_stats);
+	Destroy_async_io(io);
+	LOG_INFO("I/O: %lld blocks in, %lld out, read %.1f ms, write %.1f ms",
+		io_stats.blocks_read, io_stats.blocks_written, io_stats.read_ms, io_stats.write_ms);
+	LOG_INFO("I/O stalls: input %lld (%.1f ms), output %lld (%.1f ms)%s",
+		io_stats.input_stalls, io_stats.input_stall_ms, io_stats.output_stalls, io_stats.output_stall_ms,
+		io_stats.error ? ", I/O error" : "");
+
 	drwav_uninit(&in_wav);
 	drwav_uninit(&out_wav);
 }
\ No newline at end of file
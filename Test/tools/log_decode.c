@@ -0,0 +1,30 @@
+#include <stdio.h>
+#include "../../Include/logger.h"
+
+/*
+ * Turns a binary log written by logger_initBinaryFileLogger into text, the same
+ * lines the file logger writes.
+ */
+int main(int argc, char* argv[])
+{
+	FILE* output = stdout;
+	long count = 0;
+
+	if (argc < 2 || argc > 3) {
+		fprintf(stderr, "Usage: %s <binary log> [output]\n", argv[0]);
+		return 1;
+	}
+	if (3 == argc && NULL == (output = fopen(argv[2], "w"))) {
+		fprintf(stderr, "Can't open %s\n", argv[2]);
+		return 1;
+	}
+	count = logger_decodeBinaryFile(argv[1], output);
+	if (output != stdout) {
+		fclose(output);
+	}
+	if (count < 0) {
+		fprintf(stderr, "Can't read %s\n", argv[1]);
+		return 1;
+	}
+	return 0;
+}